@@ -1,8 +1,10 @@
 # distutils: language = c++
 
 from libcpp.vector cimport vector
+from libcpp.string cimport string
 from libcpp cimport bool
 from cython.operator cimport dereference as deref, preincrement as preinc
+from cpython.buffer cimport PyObject_CheckBuffer, PyObject_GetBuffer, PyBuffer_Release, PyBUF_C_CONTIGUOUS, PyBUF_FORMAT, PyBUF_WRITABLE, PyBUF_SIMPLE
 
 """
 #############################################
@@ -41,6 +43,36 @@ cdef extern from "src/Population.h" namespace "NEAT":
         SIMPLIFYING
         BLENDED
 
+cdef extern from "src/CompiledNetwork.h" namespace "NEAT":
+    cpdef enum Precision:
+        DOUBLE_PRECISION
+        SINGLE_PRECISION
+
+    cpdef enum ActivationBackend:
+        INTERPRETED_BACKEND
+        CSR_BACKEND
+        PARALLEL_CSR_BACKEND
+        PROGRAM_BACKEND
+        FIXED_BACKEND
+
+    const char* ActivationBackendName_ "NEAT::ActivationBackendName"(ActivationBackend a_backend)
+
+    cdef cppclass BackendProfile:
+        unsigned int m_program_max_neurons
+        unsigned int m_parallel_min_connections
+        void Calibrate()
+        bool Save(const char* a_filename)
+        bool Load(const char* a_filename)
+
+    BackendProfile& BackendProfile_Active "NEAT::BackendProfile::Active"()
+
+cdef extern from "src/ActivationFunctions.h" namespace "NEAT":
+    cpdef enum ActivationAccuracy:
+        EXACT_ACTIVATION
+        FAST_ACTIVATION
+        TABLE_ACTIVATION
+        VECTOR_ACTIVATION
+
 
 """
 #############################################
@@ -608,10 +640,14 @@ NeuralNetwork class
 
 cdef extern from "src/NeuralNetwork.h" namespace "NEAT":
     cdef cppclass Connection:
-        unsigned short int m_source_neuron_idx;
-        unsigned short int m_target_neuron_idx;
+        unsigned int m_source_neuron_idx;
+        unsigned int m_target_neuron_idx;
         double m_weight;
+
+    cdef cppclass ConnectionLearning:
         bool m_recur_flag;
+        double m_hebb_rate;
+        double m_hebb_pre_rate;
 
     cdef cppclass Neuron:
         double m_activation;
@@ -620,6 +656,9 @@ cdef extern from "src/NeuralNetwork.h" namespace "NEAT":
         double m_b;
         double m_timeconst;
         double m_bias;
+        NeuronType m_type;
+
+    cdef cppclass NeuronLayout:
         double m_x;
         double m_y;
         double m_z;
@@ -628,11 +667,22 @@ cdef extern from "src/NeuralNetwork.h" namespace "NEAT":
         double m_sz;
         vector[double] m_substrate_coords;
         double m_split_y;
-        NeuronType m_type;
+
+    cdef struct OptimizationReport:
+        unsigned int m_small_connections;
+        unsigned int m_folded_neurons;
+        unsigned int m_folded_connections;
+        unsigned int m_added_connections;
+        unsigned int m_dead_neurons;
+        unsigned int m_dead_connections;
+
+    cdef cppclass NeuralNetworkState:
+        NeuralNetworkState() except +
+        NeuralNetworkState(const NeuralNetworkState& a_State) except +
 
     cdef cppclass NeuralNetwork:
-        unsigned short m_num_inputs;
-        unsigned short m_num_outputs;
+        unsigned int m_num_inputs;
+        unsigned int m_num_outputs;
         vector[Neuron] m_neurons;
         vector[Connection] m_connections;
 
@@ -644,24 +694,188 @@ cdef extern from "src/NeuralNetwork.h" namespace "NEAT":
         void Activate();
         void ActivateUseInternalBias();
         void ActivateLeaky(double step);
+        void ActivateTopological(unsigned int a_RecurrentIterations);
+        void ActivateDelta(double a_Epsilon);
+        bool IsAcyclic();
+        unsigned int SettlingDepth();
+        void ActivateBatch(vector[vector[double]]& a_Inputs, vector[vector[double]]& a_Outputs, unsigned int a_Steps);
+
+        void Compile();
+        void Decompile();
+        void UpdateParameters();
+        bool IsCompiled();
+        bool IsOptimized();
+        void SetPrecision(Precision a_Precision);
+        Precision GetPrecision();
+        void SetActivationAccuracy(ActivationAccuracy a_Accuracy);
+        ActivationAccuracy GetActivationAccuracy();
+        void SetNumThreads(unsigned int a_NumThreads);
+        unsigned int GetNumThreads();
+        ActivationBackend GetBackend();
+        ActivationBackend SelectBackend();
+        OptimizationReport Optimize(double a_WeightEpsilon, double a_BiasValue, bool a_UseInternalBias);
+        void ReorderHiddenNeurons();
 
         void RTRL_update_gradients();
         void RTRL_update_error(double a_target);
+        void RTRL_update_error(vector[double]& a_Targets);
         void RTRL_update_weights();
+        double Backprop(vector[vector[double]]& a_Inputs, vector[vector[double]]& a_Targets, double a_LearningRate);
+        double BPTT(vector[vector[double]]& a_Inputs, vector[vector[double]]& a_Targets, double a_LearningRate, unsigned int a_TruncationDepth);
         void Adapt(Parameters& a_Parameters);
 
         void Flush();
         void FlushCube();
         void Input(vector[double]& a_Inputs);
+        void InputFrom(const double* a_Inputs);
+        void InputFrom(const float* a_Inputs);
         vector[double] Output();
+        void OutputInto(double* a_Outputs);
+        void OutputInto(float* a_Outputs);
+
+        unsigned int NumNeurons();
+        unsigned int NumConnections();
+        void GetWeights(double* a_Weights);
+        void SetWeights(const double* a_Weights);
+        void GetBiases(double* a_Biases);
+        void SetBiases(const double* a_Biases);
+        void GetTimeConstants(double* a_TimeConstants);
+        void SetTimeConstants(const double* a_TimeConstants);
+        void GetActivationA(double* a_A);
+        void SetActivationA(const double* a_A);
+        void GetActivationB(double* a_B);
+        void SetActivationB(const double* a_B);
+
+        bool ExportC(const char* a_filename, const char* a_Prefix);
+
+        bool SaveBinary(const char* a_filename);
+        bool LoadBinary(const char* a_filename);
+        string ToBinary();
+        bool FromBinary(const void* a_Data, size_t a_Size);
+
+        NeuralNetworkState NewState() except +
+        NeuralNetworkState CloneState() except +
+        void RestoreState(const NeuralNetworkState& a_State) except +
+        void Input(NeuralNetworkState& a_State, vector[double]& a_Inputs) except +
+        void Activate(NeuralNetworkState& a_State) except +
+        void ActivateUseInternalBias(NeuralNetworkState& a_State) except +
+        void ActivateLeaky(NeuralNetworkState& a_State, double a_Step) except +
+        void ActivateTopological(NeuralNetworkState& a_State, unsigned int a_RecurrentIterations) except +
+        void ActivateDelta(NeuralNetworkState& a_State, double a_Epsilon) except +
+        void Flush(NeuralNetworkState& a_State) except +
+        vector[double] Output(const NeuralNetworkState& a_State) except +
+
+
+# Gets the buffer of a one-dimensional, C-contiguous float64 or float32 array
+# in native byte order with at least a_min_size elements. Returns its type,
+# b'd' or b'f', or 0 for any other object (with no buffer to release).
+cdef char _get_array_buffer(object a_array, Py_buffer* a_view, bint a_writable, unsigned int a_min_size):
+    cdef int t_flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT
+    cdef const char* t_format
+    cdef char t_type
+    if a_writable:
+        t_flags |= PyBUF_WRITABLE
+    if not PyObject_CheckBuffer(a_array):
+        return 0
+    try:
+        PyObject_GetBuffer(a_array, a_view, t_flags)
+    except (BufferError, ValueError, TypeError):
+        return 0
+
+    t_format = a_view.format
+    if t_format == NULL:
+        t_format = b"B"
+    if t_format[0] == b'@' or t_format[0] == b'=':
+        t_format += 1
+    t_type = t_format[0]
+    if (a_view.ndim == 1 and t_format[1] == 0 and a_view.len >= a_min_size * a_view.itemsize and
+            ((t_type == b'd' and a_view.itemsize == sizeof(double)) or
+             (t_type == b'f' and a_view.itemsize == sizeof(float)))):
+        return t_type
+    PyBuffer_Release(a_view)
+    return 0
+
+# Copies a_Values[0 .. a_Size) into a_Array, a sequence of at least a_Size
+# elements, in one pass if it is a contiguous float64/float32 array
+cdef _values_into_array(const vector[double]& a_Values, unsigned int a_Size, object a_Array):
+    cdef Py_buffer t_view
+    cdef unsigned int i
+    cdef char t_type = _get_array_buffer(a_Array, &t_view, True, a_Size)
+    if t_type == 0:
+        if len(a_Array) < a_Size:
+            raise ValueError("the array is smaller than the number of values")
+        for i in range(a_Size):
+            a_Array[i] = a_Values[i]
+        return
+    if t_type == b'd':
+        for i in range(a_Size):
+            (<double*>t_view.buf)[i] = a_Values[i]
+    else:
+        for i in range(a_Size):
+            (<float*>t_view.buf)[i] = a_Values[i]
+    PyBuffer_Release(&t_view)
+
+# The first a_Size elements of a_Array, and a 0 after them, so the vector
+# is never empty
+cdef vector[double] _array_values(object a_Array, unsigned int a_Size) except *:
+    cdef vector[double] t_values = vector[double](a_Size + 1)
+    cdef Py_buffer t_view
+    cdef unsigned int i
+    cdef char t_type = _get_array_buffer(a_Array, &t_view, False, a_Size)
+    if t_type == 0:
+        if len(a_Array) < a_Size:
+            raise ValueError("the array is smaller than the number of values")
+        for i in range(a_Size):
+            t_values[i] = a_Array[i]
+        return t_values
+    if t_type == b'd':
+        for i in range(a_Size):
+            t_values[i] = (<const double*>t_view.buf)[i]
+    else:
+        for i in range(a_Size):
+            t_values[i] = (<const float*>t_view.buf)[i]
+    PyBuffer_Release(&t_view)
+    return t_values
+
+
+def ActivationBackendName(a_backend):
+    return ActivationBackendName_(a_backend)
+
+# Wraps the profile the networks use, changes to it apply to networks compiled after
+cdef class pyBackendProfile:
+    cdef BackendProfile *thisptr      # not owned, BackendProfile::Active()
+    def __cinit__(self):
+        self.thisptr = &BackendProfile_Active()
+
+    property program_max_neurons:
+        def __get__(self): return self.thisptr.m_program_max_neurons
+        def __set__(self, unsigned int a_value): self.thisptr.m_program_max_neurons = a_value
+    property parallel_min_connections:
+        def __get__(self): return self.thisptr.m_parallel_min_connections
+        def __set__(self, unsigned int a_value): self.thisptr.m_parallel_min_connections = a_value
+
+    def Calibrate(self):
+        self.thisptr.Calibrate()
+    def Save(self, a_filename):
+        return self.thisptr.Save(a_filename)
+    def Load(self, a_filename):
+        return self.thisptr.Load(a_filename)
+
+def GetBackendProfile():
+    return pyBackendProfile()
 
 
+# The side table entry (ConnectionLearning, NeuronLayout) is held next to the
+# C++ instance
 cdef class pyConnection:
     cdef Connection *thisptr      # hold a C++ instance which we're wrapping
+    cdef ConnectionLearning *learningptr
     def __cinit__(self):
         self.thisptr = new Connection()
+        self.learningptr = new ConnectionLearning()
     def __dealloc__(self):
         del self.thisptr
+        del self.learningptr
 
     property m_source_neuron_idx:
             def __get__(self): return self.thisptr.m_source_neuron_idx
@@ -676,16 +890,19 @@ cdef class pyConnection:
             def __set__(self, m_weight): self.thisptr.m_weight = m_weight
             
     property m_recur_flag:
-            def __get__(self): return self.thisptr.m_recur_flag
-            def __set__(self, m_recur_flag): self.thisptr.m_recur_flag = m_recur_flag
+            def __get__(self): return self.learningptr.m_recur_flag
+            def __set__(self, m_recur_flag): self.learningptr.m_recur_flag = m_recur_flag
             
             
 cdef class pyNeuron:
     cdef Neuron *thisptr      # hold a C++ instance which we're wrapping
+    cdef NeuronLayout *layoutptr
     def __cinit__(self):
         self.thisptr = new Neuron()
+        self.layoutptr = new NeuronLayout()
     def __dealloc__(self):
         del self.thisptr
+        del self.layoutptr
 
     property m_activation:
             def __get__(self): return self.thisptr.m_activation
@@ -712,36 +929,36 @@ cdef class pyNeuron:
             def __set__(self, m_bias): self.thisptr.m_bias = m_bias
             
     property m_x:
-            def __get__(self): return self.thisptr.m_x
-            def __set__(self, m_x): self.thisptr.m_x = m_x
+            def __get__(self): return self.layoutptr.m_x
+            def __set__(self, m_x): self.layoutptr.m_x = m_x
             
     property m_y:
-            def __get__(self): return self.thisptr.m_y
-            def __set__(self, m_y): self.thisptr.m_y = m_y
+            def __get__(self): return self.layoutptr.m_y
+            def __set__(self, m_y): self.layoutptr.m_y = m_y
             
     property m_z:
-            def __get__(self): return self.thisptr.m_z
-            def __set__(self, m_z): self.thisptr.m_z = m_z
+            def __get__(self): return self.layoutptr.m_z
+            def __set__(self, m_z): self.layoutptr.m_z = m_z
             
     property m_sx:
-            def __get__(self): return self.thisptr.m_sx
-            def __set__(self, m_sx): self.thisptr.m_sx = m_sx
+            def __get__(self): return self.layoutptr.m_sx
+            def __set__(self, m_sx): self.layoutptr.m_sx = m_sx
             
     property m_sy:
-            def __get__(self): return self.thisptr.m_sy
-            def __set__(self, m_sy): self.thisptr.m_sy = m_sy
+            def __get__(self): return self.layoutptr.m_sy
+            def __set__(self, m_sy): self.layoutptr.m_sy = m_sy
             
     property m_sz:
-            def __get__(self): return self.thisptr.m_sz
-            def __set__(self, m_sz): self.thisptr.m_sz = m_sz
+            def __get__(self): return self.layoutptr.m_sz
+            def __set__(self, m_sz): self.layoutptr.m_sz = m_sz
             
     property m_substrate_coords:
-            def __get__(self): return self.thisptr.m_substrate_coords
-            def __set__(self, m_substrate_coords): self.thisptr.m_substrate_coords = m_substrate_coords
+            def __get__(self): return self.layoutptr.m_substrate_coords
+            def __set__(self, m_substrate_coords): self.layoutptr.m_substrate_coords = m_substrate_coords
             
     property m_split_y:
-            def __get__(self): return self.thisptr.m_split_y
-            def __set__(self, m_split_y): self.thisptr.m_split_y = m_split_y
+            def __get__(self): return self.layoutptr.m_split_y
+            def __set__(self, m_split_y): self.layoutptr.m_split_y = m_split_y
             
     property m_type:
             def __get__(self): return self.thisptr.m_type
@@ -750,6 +967,27 @@ cdef class pyNeuron:
 
             
             
+# The activation state of one network instance, see pyNeuralNetwork.NewState()
+cdef class pyNeuralNetworkState:
+    cdef NeuralNetworkState *thisptr      # hold a C++ instance which we're wrapping
+    def __cinit__(self):
+        self.thisptr = new NeuralNetworkState()
+    def __dealloc__(self):
+        del self.thisptr
+
+    # an independent copy, to fork a rollout
+    def copy(self):
+        cdef pyNeuralNetworkState t_copy = pyNeuralNetworkState()
+        t_copy.thisptr[0] = self.thisptr[0]
+        return t_copy
+    
+    def __copy__(self):
+        return self.copy()
+    
+    def __deepcopy__(self, memo):
+        return self.copy()
+
+            
 cdef class pyNeuralNetwork:
     cdef NeuralNetwork *thisptr      # hold a C++ instance which we're wrapping
     def __cinit__(self):
@@ -765,38 +1003,246 @@ cdef class pyNeuralNetwork:
     def ActivateFast(self):
         return self.thisptr.ActivateFast()
     
-    def Activate(self):
+    # the methods taking an optional a_State act on that state instead of the network's own
+    def Activate(self, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.Activate(deref(a_State.thisptr))
         return self.thisptr.Activate()
     
-    def ActivateUseInternalBias(self):
+    def ActivateUseInternalBias(self, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.ActivateUseInternalBias(deref(a_State.thisptr))
         return self.thisptr.ActivateUseInternalBias()
     
-    def ActivateLeaky(self, step):
+    def ActivateLeaky(self, step, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.ActivateLeaky(deref(a_State.thisptr), step)
         return self.thisptr.ActivateLeaky(step)
     
+    def ActivateTopological(self, recurrent_iterations=1, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.ActivateTopological(deref(a_State.thisptr), recurrent_iterations)
+        return self.thisptr.ActivateTopological(recurrent_iterations)
+    
+    def ActivateDelta(self, epsilon=0.0, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.ActivateDelta(deref(a_State.thisptr), epsilon)
+        return self.thisptr.ActivateDelta(epsilon)
+    
+    def NewState(self):
+        cdef pyNeuralNetworkState t_state = pyNeuralNetworkState()
+        t_state.thisptr[0] = self.thisptr.NewState()
+        return t_state
+    
+    def CloneState(self):
+        cdef pyNeuralNetworkState t_state = pyNeuralNetworkState()
+        t_state.thisptr[0] = self.thisptr.CloneState()
+        return t_state
+    
+    def RestoreState(self, pyNeuralNetworkState a_State):
+        return self.thisptr.RestoreState(deref(a_State.thisptr))
+    
+    def IsAcyclic(self):
+        return self.thisptr.IsAcyclic()
+    
+    def SettlingDepth(self):
+        return self.thisptr.SettlingDepth()
+    
+    def ActivateBatch(self, inputs, steps):
+        cdef vector[vector[double]] outputs
+        self.thisptr.ActivateBatch(inputs, outputs, steps)
+        return outputs
+    
+    def Compile(self):
+        return self.thisptr.Compile()
+    
+    def Decompile(self):
+        return self.thisptr.Decompile()
+    
+    def UpdateParameters(self):
+        return self.thisptr.UpdateParameters()
+    
+    def IsCompiled(self):
+        return self.thisptr.IsCompiled()
+    
+    def IsOptimized(self):
+        return self.thisptr.IsOptimized()
+    
+    def SetPrecision(self, a_Precision):
+        return self.thisptr.SetPrecision(a_Precision)
+    
+    def GetPrecision(self):
+        return self.thisptr.GetPrecision()
+    
+    def SetActivationAccuracy(self, a_Accuracy):
+        return self.thisptr.SetActivationAccuracy(a_Accuracy)
+    
+    def GetActivationAccuracy(self):
+        return self.thisptr.GetActivationAccuracy()
+    
+    def SetNumThreads(self, a_NumThreads):
+        return self.thisptr.SetNumThreads(a_NumThreads)
+    
+    def GetNumThreads(self):
+        return self.thisptr.GetNumThreads()
+    
+    def GetBackend(self):
+        return self.thisptr.GetBackend()
+    
+    def SelectBackend(self):
+        return self.thisptr.SelectBackend()
+    
+    # returns the report as a dict
+    def Optimize(self, a_WeightEpsilon=0.0, a_BiasValue=1.0, a_UseInternalBias=False):
+        return self.thisptr.Optimize(a_WeightEpsilon, a_BiasValue, a_UseInternalBias)
+    
+    def ReorderHiddenNeurons(self):
+        return self.thisptr.ReorderHiddenNeurons()
+    
     def RTRL_update_gradients(self):
         return self.thisptr.RTRL_update_gradients()
     
-    def RTRL_update_error(self, double a_target):
-        return self.thisptr.RTRL_update_error(a_target)
+    def RTRL_update_error(self, a_target):
+        cdef vector[double] t_targets
+        cdef double t_target
+        if isinstance(a_target, (list, tuple)):
+            t_targets = a_target
+            return self.thisptr.RTRL_update_error(t_targets)
+        t_target = a_target
+        return self.thisptr.RTRL_update_error(t_target)
     
     def RTRL_update_weights(self):
         return self.thisptr.RTRL_update_weights()
     
+    def Backprop(self, inputs, targets, a_LearningRate):
+        return self.thisptr.Backprop(inputs, targets, a_LearningRate)
+    
+    def BPTT(self, inputs, targets, a_LearningRate, a_TruncationDepth):
+        return self.thisptr.BPTT(inputs, targets, a_LearningRate, a_TruncationDepth)
+    
     def Adapt(self, pyParameters a_Parameters):
         return self.thisptr.Adapt(deref(a_Parameters.thisptr))
     
-    def Flush(self):
+    def Flush(self, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.Flush(deref(a_State.thisptr))
         return self.thisptr.Flush()
     
     def FlushCube(self):
         return self.thisptr.FlushCube()
     
-    def Input(self, a_Inputs):
-        return self.thisptr.Input(a_Inputs)
+    def Input(self, a_Inputs, pyNeuralNetworkState a_State=None):
+        cdef vector[double] t_inputs
+        if a_State is not None:
+            t_inputs = list(a_Inputs)
+            t_inputs.resize(self.thisptr.m_num_inputs)
+            return self.thisptr.Input(deref(a_State.thisptr), t_inputs)
+        # contiguous float64/float32 arrays are read in place
+        cdef Py_buffer t_view
+        cdef char t_type = _get_array_buffer(a_Inputs, &t_view, False, self.thisptr.m_num_inputs)
+        if t_type == 0:
+            return self.thisptr.Input(a_Inputs)
+        if t_type == b'd':
+            self.thisptr.InputFrom(<const double*>t_view.buf)
+        else:
+            self.thisptr.InputFrom(<const float*>t_view.buf)
+        PyBuffer_Release(&t_view)
     
-    def Output(self):
+    def Output(self, pyNeuralNetworkState a_State=None):
+        if a_State is not None:
+            return self.thisptr.Output(deref(a_State.thisptr))
         return self.thisptr.Output()
+    
+    def OutputInto(self, a_Outputs):
+        # contiguous float64/float32 arrays are written in place
+        cdef Py_buffer t_view
+        cdef char t_type = _get_array_buffer(a_Outputs, &t_view, True, self.thisptr.m_num_outputs)
+        if t_type == 0:
+            if len(a_Outputs) < self.thisptr.m_num_outputs:
+                raise ValueError("the array is smaller than the number of outputs")
+            t_outputs = self.thisptr.Output()
+            for i in range(self.thisptr.m_num_outputs):
+                a_Outputs[i] = t_outputs[i]
+            return
+        if t_type == b'd':
+            self.thisptr.OutputInto(<double*>t_view.buf)
+        else:
+            self.thisptr.OutputInto(<float*>t_view.buf)
+        PyBuffer_Release(&t_view)
+    
+    def NumNeurons(self):
+        return self.thisptr.NumNeurons()
+    
+    def NumConnections(self):
+        return self.thisptr.NumConnections()
+    
+    # the getters write to a_Array and the setters read from it, a NumPy
+    # array or any sequence of at least NumConnections()/NumNeurons() elements
+    def GetWeights(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumConnections() + 1)
+        self.thisptr.GetWeights(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumConnections(), a_Array)
+    
+    def SetWeights(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumConnections())
+        self.thisptr.SetWeights(&t_values[0])
+    
+    def GetBiases(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetBiases(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetBiases(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetBiases(&t_values[0])
+    
+    def GetTimeConstants(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetTimeConstants(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetTimeConstants(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetTimeConstants(&t_values[0])
+    
+    def GetActivationA(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetActivationA(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetActivationA(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetActivationA(&t_values[0])
+    
+    def GetActivationB(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetActivationB(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetActivationB(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetActivationB(&t_values[0])
+    
+    def ExportC(self, a_filename, a_Prefix="network"):
+        return self.thisptr.ExportC(a_filename, a_Prefix)
+    
+    def SaveBinary(self, a_filename):
+        return self.thisptr.SaveBinary(a_filename)
+    
+    def LoadBinary(self, a_filename):
+        return self.thisptr.LoadBinary(a_filename)
+    
+    # pickled as the binary image of the network
+    def __reduce__(self):
+        return (pyNeuralNetwork, (True,), self.thisptr.ToBinary())
+    
+    def __setstate__(self, a_State):
+        cdef Py_buffer t_view
+        PyObject_GetBuffer(a_State, &t_view, PyBUF_SIMPLE)
+        t_loaded = self.thisptr.FromBinary(t_view.buf, t_view.len)
+        PyBuffer_Release(&t_view)
+        if not t_loaded:
+            raise ValueError("not a network image of this version")
 
 
     property m_num_inputs:
@@ -847,6 +1293,8 @@ cdef extern from "src/Substrate.h" namespace "NEAT":
         ActivationFunction m_hidden_nodes_activation;
         ActivationFunction m_output_nodes_activation;
 
+        ActivationAccuracy m_cppn_activation_accuracy;
+
         double m_link_threshold;
         double m_max_weight_and_bias;
         double m_min_time_const;
@@ -940,6 +1388,10 @@ cdef class pySubstrate:
             def __get__(self): return self.thisptr.m_output_nodes_activation
             def __set__(self, m_output_nodes_activation): self.thisptr.m_output_nodes_activation = m_output_nodes_activation
             
+    property m_cppn_activation_accuracy:
+            def __get__(self): return self.thisptr.m_cppn_activation_accuracy
+            def __set__(self, m_cppn_activation_accuracy): self.thisptr.m_cppn_activation_accuracy = m_cppn_activation_accuracy
+            
     property m_link_threshold:
             def __get__(self): return self.thisptr.m_link_threshold
             def __set__(self, m_link_threshold): self.thisptr.m_link_threshold = m_link_threshold
@@ -990,8 +1442,21 @@ cdef extern from "src/Genome.h" namespace "NEAT":
         unsigned int GetDepth();
 
         void BuildPhenotype(NeuralNetwork& net);
+        void BuildPhenotype(NeuralNetwork& net, bool a_Compile);
+        bool UpdatePhenotype(NeuralNetwork& net);
         void BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst);
 
+        void GetWeights(double* a_Weights);
+        void SetWeights(const double* a_Weights);
+        void GetBiases(double* a_Biases);
+        void SetBiases(const double* a_Biases);
+        void GetTimeConstants(double* a_TimeConstants);
+        void SetTimeConstants(const double* a_TimeConstants);
+        void GetActivationA(double* a_A);
+        void SetActivationA(const double* a_A);
+        void GetActivationB(double* a_B);
+        void SetActivationB(const double* a_B);
+
         void Save(const char* a_filename);
 
         bool IsEvaluated();
@@ -1037,12 +1502,62 @@ cdef class pyGenome:
     def GetDepth(self):
         return self.thisptr.GetDepth()
     
-    def BuildPhenotype(self, pyNeuralNetwork net):
-        return self.thisptr.BuildPhenotype(deref(net.thisptr))
+    def BuildPhenotype(self, pyNeuralNetwork net, bool compile=False):
+        return self.thisptr.BuildPhenotype(deref(net.thisptr), compile)
+    
+    def UpdatePhenotype(self, pyNeuralNetwork net):
+        return self.thisptr.UpdatePhenotype(deref(net.thisptr))
     
     def BuildHyperNEATPhenotype(self, pyNeuralNetwork net, pySubstrate subst):
         return self.thisptr.BuildHyperNEATPhenotype(deref(net.thisptr), deref(subst.thisptr))
     
+    # the getters write to a_Array and the setters read from it, a NumPy
+    # array or any sequence of at least NumLinks()/NumNeurons() elements
+    def GetWeights(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumLinks() + 1)
+        self.thisptr.GetWeights(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumLinks(), a_Array)
+    
+    def SetWeights(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumLinks())
+        self.thisptr.SetWeights(&t_values[0])
+    
+    def GetBiases(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetBiases(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetBiases(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetBiases(&t_values[0])
+    
+    def GetTimeConstants(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetTimeConstants(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetTimeConstants(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetTimeConstants(&t_values[0])
+    
+    def GetActivationA(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetActivationA(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetActivationA(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetActivationA(&t_values[0])
+    
+    def GetActivationB(self, a_Array):
+        cdef vector[double] t_values = vector[double](self.thisptr.NumNeurons() + 1)
+        self.thisptr.GetActivationB(&t_values[0])
+        _values_into_array(t_values, self.thisptr.NumNeurons(), a_Array)
+    
+    def SetActivationB(self, a_Array):
+        cdef vector[double] t_values = _array_values(a_Array, self.thisptr.NumNeurons())
+        self.thisptr.SetActivationB(&t_values[0])
+    
     def Save(self, a_filename):
         return self.thisptr.Save(a_filename)
     
@@ -1206,4 +1721,103 @@ cdef class pyPopulation:
     #def Tick(self, a_deleted_genome):
     #    return self.thisptr.Tick(a_deleted_genome)
     
-    
\ No newline at end of file
+    
+
+
+"""
+#############################################
+
+PackedPopulation
+
+#############################################
+"""
+cdef extern from "src/PackedPopulation.h" namespace "NEAT":
+    cdef cppclass PackedPopulation:
+        PackedPopulation() except +
+
+        void Build(const Population& a_Population) except +
+        void Build(const vector[Genome]& a_Genomes) except +
+        void Clear();
+
+        unsigned int NumNetworks();
+        unsigned int NumInputs();
+        unsigned int NumOutputs();
+
+        void Activate();
+        void ActivateUseInternalBias();
+        void ActivateLeaky(double a_step);
+        void ActivateTopological(unsigned int a_RecurrentIterations);
+        void Flush();
+
+        void Input(const vector[double]& a_Inputs) except +
+        void InputFrom(const double* a_Inputs);
+        vector[double] Output(unsigned int a_Network) except +
+        const double* Outputs();
+
+
+cdef class pyPackedPopulation:
+    cdef PackedPopulation *thisptr      # hold a C++ instance which we're wrapping
+    def __cinit__(self):
+        self.thisptr = new PackedPopulation()
+    def __dealloc__(self):
+        del self.thisptr
+
+    def Build(self, a_source):
+        # a pyPopulation or a list of pyGenomes
+        cdef vector[Genome] t_genomes
+        cdef pyGenome t_genome
+        if isinstance(a_source, pyPopulation):
+            self.thisptr.Build(deref((<pyPopulation>a_source).thisptr))
+            return
+        for t_genome in a_source:
+            t_genomes.push_back(deref(t_genome.thisptr))
+        self.thisptr.Build(t_genomes)
+
+    def Clear(self):
+        return self.thisptr.Clear()
+
+    def NumNetworks(self):
+        return self.thisptr.NumNetworks()
+
+    def NumInputs(self):
+        return self.thisptr.NumInputs()
+
+    def NumOutputs(self):
+        return self.thisptr.NumOutputs()
+
+    def Activate(self):
+        return self.thisptr.Activate()
+
+    def ActivateUseInternalBias(self):
+        return self.thisptr.ActivateUseInternalBias()
+
+    def ActivateLeaky(self, step):
+        return self.thisptr.ActivateLeaky(step)
+
+    def ActivateTopological(self, recurrent_iterations=1):
+        return self.thisptr.ActivateTopological(recurrent_iterations)
+
+    def Flush(self):
+        return self.thisptr.Flush()
+
+    def Input(self, a_Inputs):
+        # contiguous float64 arrays are read in place
+        cdef Py_buffer t_view
+        cdef char t_type = _get_array_buffer(a_Inputs, &t_view, False, self.thisptr.NumInputs())
+        if t_type == b'd':
+            self.thisptr.InputFrom(<const double*>t_view.buf)
+            PyBuffer_Release(&t_view)
+            return
+        if t_type != 0:
+            PyBuffer_Release(&t_view)
+        return self.thisptr.Input(a_Inputs)
+
+    def Output(self, a_Network):
+        return self.thisptr.Output(a_Network)
+
+    def Outputs(self):
+        # the outputs of all networks, one row per network
+        cdef const double* t_outputs = self.thisptr.Outputs()
+        cdef unsigned int t_num_outputs = self.thisptr.NumOutputs()
+        return [[t_outputs[i * t_num_outputs + k] for k in range(t_num_outputs)]
+                for i in range(self.thisptr.NumNetworks())]
@@ -20,21 +20,28 @@ try:
           py_modules=['MultiNEAT'],
           ext_modules = cythonize([Extension('_MultiNEAT',
                                              ['_MultiNEAT.pyx',
+                                              'src/CompiledNetwork.cpp',
                                               'src/Genome.cpp',
                                               'src/Innovation.cpp',
+                                              'src/NetworkImage.cpp',
                                               'src/NeuralNetwork.cpp',
+                                              'src/PackedPopulation.cpp',
                                               'src/Parameters.cpp',
                                               'src/PhenotypeBehavior.cpp',
                                               'src/Population.cpp',
                                               'src/Random.cpp',
                                               'src/Species.cpp',
                                               'src/Substrate.cpp',
+                                              'src/ThreadPool.cpp',
                                               'src/Utils.cpp'],
                                   extra_compile_args=['-O3', '-march=native', #'/EHsc', # for Windows
                                                       '-std=gnu++11',
+                                                      '-ffp-contract=off',
+                                                      '-pthread',
                                                       '-g',
                                                       '-Wall'
-                 ])
+                 ],
+                                  extra_link_args=['-pthread'])
 ],
                                     ))
 
@@ -44,9 +51,12 @@ except Exception as ex:
     setup(name='MultiNEAT',
           version='0.3',
           py_modules=['MultiNEAT'],
-          ext_modules=[Extension('_MultiNEAT', ['src/Genome.cpp',
+          ext_modules=[Extension('_MultiNEAT', ['src/CompiledNetwork.cpp',
+                                                'src/Genome.cpp',
                                                 'src/Innovation.cpp',
+                                                'src/NetworkImage.cpp',
                                                 'src/NeuralNetwork.cpp',
+                                                'src/PackedPopulation.cpp',
                                                 'src/Parameters.cpp',
                                                 'src/PhenotypeBehavior.cpp',
                                                 'src/Population.cpp',
@@ -54,6 +64,7 @@ except Exception as ex:
                                                 'src/Random.cpp',
                                                 'src/Species.cpp',
                                                 'src/Substrate.cpp',
+                                                'src/ThreadPool.cpp',
                                                 'src/Utils.cpp'],
                                  libraries=[lb,
                                             'boost_serialization'],
@@ -67,7 +78,10 @@ except Exception as ex:
                                                      '-DUSE_BOOST_PYTHON',
                                                      '-DUSE_BOOST_RANDOM', 
                                                     '-std=gnu++11',
+                                                    '-ffp-contract=off',
+                                                    '-pthread',
                                                     '-g',
                                                     '-Wall'
-                                                     ])
+                                                     ],
+                                 extra_link_args=['-pthread'])
                        ])
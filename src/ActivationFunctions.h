@@ -0,0 +1,564 @@
+#ifndef _ACTIVATION_FUNCTIONS_H
+#define _ACTIVATION_FUNCTIONS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ActivationFunctions.h
+// Description: The neuron activation functions, shared by all activation engines.
+///////////////////////////////////////////////////////////////////////////////
+
+
+#include <math.h>
+#include <string.h>
+#include <vector>
+#include "Genes.h"
+
+namespace NEAT
+{
+
+/////////////////////////////////////
+// The set of activation functions //
+/////////////////////////////////////
+
+
+inline double af_sigmoid_unsigned(double aX, double aSlope, double aShift)
+{
+    return 1.0 / (1.0 + exp( - aSlope * aX - aShift));
+}
+
+inline double af_sigmoid_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_sigmoid_unsigned(aX, aSlope, aShift);
+    return (tY - 0.5) * 2.0;
+}
+
+inline double af_tanh(double aX, double aSlope, double aShift)
+{
+    return tanh(aX * aSlope);
+}
+
+inline double af_tanh_cubic(double aX, double aSlope, double aShift)
+{
+    return tanh(aX * aX * aX * aSlope);
+}
+
+inline double af_step_signed(double aX, double aShift)
+{
+    double tY;
+    if (aX > aShift)
+    {
+        tY = 1.0;
+    }
+    else
+    {
+        tY = -1.0;
+    }
+
+    return tY;
+}
+
+inline double af_step_unsigned(double aX, double aShift)
+{
+    if (aX > (0.5+aShift))
+    {
+        return 1.0;
+    }
+    else
+    {
+        return 0.0;
+    }
+}
+
+inline double af_gauss_signed(double aX, double aSlope, double aShift)
+{
+    double tY = exp( - aSlope * aX * aX + aShift); // TODO: Need separate a, b per activation function
+    return (tY-0.5)*2.0;
+}
+
+inline double af_gauss_unsigned(double aX, double aSlope, double aShift)
+{
+    return exp( - aSlope * aX * aX + aShift);
+}
+
+inline double af_abs(double aX, double aShift)
+{
+    return ((aX + aShift)< 0.0)? -(aX + aShift): (aX + aShift);
+}
+
+inline double af_sine_signed(double aX, double aFreq, double aShift)
+{
+    aFreq = 3.141592;
+    return sin(aX * aFreq + aShift);
+}
+
+inline double af_sine_unsigned(double aX, double aFreq, double aShift)
+{
+    double tY = sin((aX * aFreq + aShift) );
+    return (tY + 1.0) / 2.0;
+}
+
+
+inline double af_linear(double aX, double aShift)
+{
+    return (aX + aShift);
+}
+
+
+inline double af_relu(double aX)
+{
+    return (aX > 0)?aX:0;
+}
+
+
+inline double af_softplus(double aX)
+{
+    return log(1 + exp(aX));
+}
+
+
+// Applies the activation function of the given type to aX.
+// Unknown types fall back to the unsigned sigmoid, like the activation loops do.
+inline double af_apply(ActivationFunction aType, double aX, double aA, double aB)
+{
+    switch (aType)
+    {
+    case SIGNED_SIGMOID:
+        return af_sigmoid_signed(aX, aA, aB);
+    case UNSIGNED_SIGMOID:
+        return af_sigmoid_unsigned(aX, aA, aB);
+    case TANH:
+        return af_tanh(aX, aA, aB);
+    case TANH_CUBIC:
+        return af_tanh_cubic(aX, aA, aB);
+    case SIGNED_STEP:
+        return af_step_signed(aX, aB);
+    case UNSIGNED_STEP:
+        return af_step_unsigned(aX, aB);
+    case SIGNED_GAUSS:
+        return af_gauss_signed(aX, aA, aB);
+    case UNSIGNED_GAUSS:
+        return af_gauss_unsigned(aX, aA, aB);
+    case ABS:
+        return af_abs(aX, aB);
+    case SIGNED_SINE:
+        return af_sine_signed(aX, aA, aB);
+    case UNSIGNED_SINE:
+        return af_sine_unsigned(aX, aA, aB);
+    case LINEAR:
+        return af_linear(aX, aB);
+    case RELU:
+        return af_relu(aX);
+    case SOFTPLUS:
+        return af_softplus(aX);
+    default:
+        return af_sigmoid_unsigned(aX, aA, aB);
+    }
+}
+
+// The derivative of the activation function of the given type at aX,
+// where aY is the function's value there. The steps have none (zero).
+inline double af_derivative(ActivationFunction aType, double aX, double aY, double aA, double aB)
+{
+    switch (aType)
+    {
+    case SIGNED_SIGMOID:
+    {
+        double tY = (aY + 1.0) * 0.5;
+        return 2.0 * aA * tY * (1.0 - tY);
+    }
+    case TANH:
+        return aA * (1.0 - aY * aY);
+    case TANH_CUBIC:
+        return 3.0 * aA * aX * aX * (1.0 - aY * aY);
+    case SIGNED_STEP:
+    case UNSIGNED_STEP:
+        return 0.0;
+    case SIGNED_GAUSS:
+        return -2.0 * aA * aX * (aY + 1.0);
+    case UNSIGNED_GAUSS:
+        return -2.0 * aA * aX * aY;
+    case ABS:
+        return ((aX + aB) < 0.0) ? -1.0 : 1.0;
+    case SIGNED_SINE:
+        return 3.141592 * cos(aX * 3.141592 + aB);
+    case UNSIGNED_SINE:
+        return 0.5 * aA * cos(aX * aA + aB);
+    case LINEAR:
+        return 1.0;
+    case RELU:
+        return (aX > 0) ? 1.0 : 0.0;
+    case SOFTPLUS:
+        return 1.0 / (1.0 + exp(-aX));
+    default:
+        return aA * aY * (1.0 - aY); // the unsigned sigmoid
+    }
+}
+
+
+//////////////////////////////////////////////////
+// Approximations                               //
+//////////////////////////////////////////////////
+
+// How accurately the compiled networks compute the activation functions.
+//
+// EXACT_ACTIVATION calls the C library, as the functions above do, so the
+// compiled form gives the same results as the interpreted one.
+//
+// FAST_ACTIVATION replaces exp(), tanh() and log() with short polynomials.
+// The largest absolute errors (over all arguments) are:
+//     SIGNED_SIGMOID  8e-8      UNSIGNED_SIGMOID  4e-8
+//     TANH            8e-8      TANH_CUBIC        8e-8
+//     SOFTPLUS        1.1e-7
+// The gaussians have a relative error below 1.7e-7 in their exp() part
+// (results below 1e-307 are flushed to zero).
+//
+// TABLE_ACTIVATION interpolates linearly between values tabulated in
+// steps of 1/64 (1/128 for tanh and exp). The largest absolute errors are:
+//     SIGNED_SIGMOID  6e-6      UNSIGNED_SIGMOID  3e-6
+//     TANH            6e-6      TANH_CUBIC        6e-6
+//     SOFTPLUS        8e-6
+// The gaussians have a relative error below 8e-6 in their exp() part
+// for exponents above -16, and an absolute error below 1.2e-7 otherwise.
+//
+// VECTOR_ACTIVATION computes exp(), tanh(), sin() and log() with the
+// vectorized functions of SimdMath.h, which are within 3 ulp of the C
+// library's. It applies where whole runs of neurons are activated at once;
+// the small networks that are activated one neuron at a time use the C
+// library as in EXACT_ACTIVATION. Without SIMD it is the same as
+// EXACT_ACTIVATION.
+//
+// All the other activation functions are exact in every mode.
+enum ActivationAccuracy
+{
+    EXACT_ACTIVATION = 0,
+    FAST_ACTIVATION,
+    TABLE_ACTIVATION,
+    VECTOR_ACTIVATION
+};
+
+// True if FAST_ACTIVATION and TABLE_ACTIVATION change how the activation
+// function is computed
+inline bool af_is_approximated(ActivationFunction aType)
+{
+    switch (aType)
+    {
+    case SIGNED_SINE:
+    case UNSIGNED_SINE:
+    case SIGNED_STEP:
+    case UNSIGNED_STEP:
+    case ABS:
+    case LINEAR:
+    case RELU:
+        return false;
+    default:
+        return true;
+    }
+}
+
+// e^x with a relative error below 1.7e-7
+// Reduces x = k*ln2 + r with |r| <= ln2/2 and sums the Taylor series of e^r to r^6.
+// The series is split in independent parts (Estrin's scheme) for a short latency,
+// as a CPPN evaluates long chains of these.
+inline double fast_exp(double aX)
+{
+    if (!(aX > -708.0))
+    {
+        return (aX != aX) ? aX : 0.0;
+    }
+    if (aX > 709.0)
+    {
+        return HUGE_VAL;
+    }
+
+    // Adding 1.5 * 2^52 rounds to an integer, k ends up in the low bits
+    const double tRound = 6755399441055744.0;
+    double tKBig = aX * 1.4426950408889634074 + tRound;
+    double tK = tKBig - tRound;
+    double tR = aX - tK * 6.93147180559945309417e-01;
+
+    double tR2 = tR * tR;
+    double tP = (1.0 + tR) + tR2 * ((1.0 / 2.0 + tR * (1.0 / 6.0)) +
+                tR2 * ((1.0 / 24.0 + tR * (1.0 / 120.0)) + tR2 * (1.0 / 720.0)));
+
+    // 2^k, built from its bits
+    unsigned long long tBits;
+    memcpy(&tBits, &tKBig, sizeof(tBits));
+    tBits = (tBits + 1023) << 52;
+    double tPow2;
+    memcpy(&tPow2, &tBits, sizeof(tPow2));
+
+    return tP * tPow2;
+}
+
+// log(1 + u) for u in [0, 1], with an absolute error below 1e-7
+// Uses log(1 + u) = 2 atanh(s), s = u / (2 + u) <= 1/3
+inline double fast_log1p_unit(double aU)
+{
+    double tS = aU / (2.0 + aU);
+    double tZ = tS * tS;
+    double tZ2 = tZ * tZ;
+    return tS * ((2.0 + tZ * (2.0 / 3.0)) + tZ2 * ((2.0 / 5.0 + tZ * (2.0 / 7.0)) +
+                 tZ2 * (2.0 / 9.0 + tZ * (2.0 / 11.0))));
+}
+
+inline double af_fast_sigmoid_unsigned(double aX, double aSlope, double aShift)
+{
+    return 1.0 / (1.0 + fast_exp( - aSlope * aX - aShift));
+}
+
+inline double af_fast_sigmoid_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_fast_sigmoid_unsigned(aX, aSlope, aShift);
+    return (tY - 0.5) * 2.0;
+}
+
+// tanh(x) = (1 - e^-2|x|) / (1 + e^-2|x|) with the sign of x
+inline double fast_tanh(double aX)
+{
+    double tE = fast_exp(-2.0 * fabs(aX));
+    double tY = (1.0 - tE) / (1.0 + tE);
+    return (aX < 0) ? -tY : tY;
+}
+
+inline double af_fast_tanh(double aX, double aSlope, double aShift)
+{
+    return fast_tanh(aX * aSlope);
+}
+
+inline double af_fast_tanh_cubic(double aX, double aSlope, double aShift)
+{
+    return fast_tanh(aX * aX * aX * aSlope);
+}
+
+inline double af_fast_gauss_unsigned(double aX, double aSlope, double aShift)
+{
+    return fast_exp( - aSlope * aX * aX + aShift);
+}
+
+inline double af_fast_gauss_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_fast_gauss_unsigned(aX, aSlope, aShift);
+    return (tY-0.5)*2.0;
+}
+
+// log(1 + e^x) = max(x, 0) + log(1 + e^-|x|)
+inline double af_fast_softplus(double aX)
+{
+    double tY = fast_log1p_unit(fast_exp(-fabs(aX)));
+    return (aX > 0) ? (aX + tY) : tY;
+}
+
+// A function tabulated over [m_min, m_max] in steps of 1/m_scale
+struct ActivationTable
+{
+    double m_min, m_max, m_scale;
+    std::vector<float> m_values;
+
+    template <class F>
+    void Build(F aFunction, double aMin, double aMax, double aScale)
+    {
+        m_min = aMin;
+        m_max = aMax;
+        m_scale = aScale;
+        unsigned int tCount = static_cast<unsigned int>((aMax - aMin) * aScale + 0.5) + 2;
+        m_values.resize(tCount);
+        for (unsigned int i = 0; i < tCount; i++)
+        {
+            m_values[i] = static_cast<float>(aFunction(aMin + i / aScale));
+        }
+    }
+
+    // Interpolates linearly, for x in [m_min, m_max]
+    double Lookup(double aX) const
+    {
+        double tPos = (aX - m_min) * m_scale;
+        unsigned int tIdx = static_cast<unsigned int>(tPos);
+        double tFrac = tPos - tIdx;
+        double tLo = m_values[tIdx];
+        return tLo + tFrac * (m_values[tIdx + 1] - tLo);
+    }
+};
+
+inline double table_logistic(double aX)
+{
+    return 1.0 / (1.0 + exp(-aX));
+}
+
+inline double table_tanh(double aX)
+{
+    return tanh(aX);
+}
+
+inline double table_exp(double aX)
+{
+    return exp(aX);
+}
+
+inline double table_softplus(double aX)
+{
+    return log(1 + exp(aX));
+}
+
+// The tables of TABLE_ACTIVATION, built on first use
+struct ActivationTables
+{
+    ActivationTable m_logistic; // 1 / (1 + e^-x) for x in [-16, 16]
+    ActivationTable m_tanh;     // tanh(x) for x in [-8, 8]
+    ActivationTable m_exp;      // e^x for x in [-16, 4]
+    ActivationTable m_softplus; // log(1 + e^x) for x in [-16, 16]
+
+    ActivationTables()
+    {
+        m_logistic.Build(table_logistic, -16.0, 16.0, 64.0);
+        m_tanh.Build(table_tanh, -8.0, 8.0, 128.0);
+        m_exp.Build(table_exp, -16.0, 4.0, 128.0);
+        m_softplus.Build(table_softplus, -16.0, 16.0, 64.0);
+    }
+
+    static const ActivationTables& Get()
+    {
+        static const ActivationTables tTables;
+        return tTables;
+    }
+};
+
+// Outside their tables, the functions take their limits.
+// NaNs fail all the range checks and are passed through.
+
+inline double af_table_sigmoid_unsigned(double aX, double aSlope, double aShift)
+{
+    double tT = aSlope * aX + aShift;
+    if (tT >= -16.0 && tT <= 16.0)
+    {
+        return ActivationTables::Get().m_logistic.Lookup(tT);
+    }
+    return (tT > 0) ? 1.0 : ((tT < 0) ? 0.0 : tT);
+}
+
+inline double af_table_sigmoid_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_table_sigmoid_unsigned(aX, aSlope, aShift);
+    return (tY - 0.5) * 2.0;
+}
+
+inline double table_tanh_lookup(double aX)
+{
+    if (aX >= -8.0 && aX <= 8.0)
+    {
+        return ActivationTables::Get().m_tanh.Lookup(aX);
+    }
+    return (aX > 0) ? 1.0 : ((aX < 0) ? -1.0 : aX);
+}
+
+inline double af_table_tanh(double aX, double aSlope, double aShift)
+{
+    return table_tanh_lookup(aX * aSlope);
+}
+
+inline double af_table_tanh_cubic(double aX, double aSlope, double aShift)
+{
+    return table_tanh_lookup(aX * aX * aX * aSlope);
+}
+
+inline double af_table_gauss_unsigned(double aX, double aSlope, double aShift)
+{
+    double tT = - aSlope * aX * aX + aShift;
+    if (tT >= -16.0 && tT <= 4.0)
+    {
+        return ActivationTables::Get().m_exp.Lookup(tT);
+    }
+    return (tT < -16.0) ? 0.0 : exp(tT);
+}
+
+inline double af_table_gauss_signed(double aX, double aSlope, double aShift)
+{
+    double tY = af_table_gauss_unsigned(aX, aSlope, aShift);
+    return (tY-0.5)*2.0;
+}
+
+inline double af_table_softplus(double aX)
+{
+    if (aX >= -16.0 && aX <= 16.0)
+    {
+        return ActivationTables::Get().m_softplus.Lookup(aX);
+    }
+    return (aX > 0) ? aX : ((aX < 0) ? 0.0 : aX);
+}
+
+// Like af_apply(), in the given accuracy mode
+inline double af_apply(ActivationFunction aType, double aX, double aA, double aB, ActivationAccuracy aAccuracy)
+{
+    if (aAccuracy == FAST_ACTIVATION)
+    {
+        switch (aType)
+        {
+        case SIGNED_SIGMOID:
+            return af_fast_sigmoid_signed(aX, aA, aB);
+        case TANH:
+            return af_fast_tanh(aX, aA, aB);
+        case TANH_CUBIC:
+            return af_fast_tanh_cubic(aX, aA, aB);
+        case SIGNED_GAUSS:
+            return af_fast_gauss_signed(aX, aA, aB);
+        case UNSIGNED_GAUSS:
+            return af_fast_gauss_unsigned(aX, aA, aB);
+        case SOFTPLUS:
+            return af_fast_softplus(aX);
+        default:
+            if (af_is_approximated(aType))
+                return af_fast_sigmoid_unsigned(aX, aA, aB);
+            break;
+        }
+    }
+    else if (aAccuracy == TABLE_ACTIVATION)
+    {
+        switch (aType)
+        {
+        case SIGNED_SIGMOID:
+            return af_table_sigmoid_signed(aX, aA, aB);
+        case TANH:
+            return af_table_tanh(aX, aA, aB);
+        case TANH_CUBIC:
+            return af_table_tanh_cubic(aX, aA, aB);
+        case SIGNED_GAUSS:
+            return af_table_gauss_signed(aX, aA, aB);
+        case UNSIGNED_GAUSS:
+            return af_table_gauss_unsigned(aX, aA, aB);
+        case SOFTPLUS:
+            return af_table_softplus(aX);
+        default:
+            if (af_is_approximated(aType))
+                return af_table_sigmoid_unsigned(aX, aA, aB);
+            break;
+        }
+    }
+
+    return af_apply(aType, aX, aA, aB);
+}
+
+} // namespace NEAT
+
+#endif
@@ -0,0 +1,593 @@
+#ifndef _ACTIVATION_KERNELS_H
+#define _ACTIVATION_KERNELS_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ActivationKernels.h
+// Description: Activation functions applied over whole arrays of neurons.
+///////////////////////////////////////////////////////////////////////////////
+
+// Every activation function has a batch form here. It computes a whole
+// SIMD batch at once without branching, and reports the batches with
+// arguments outside the range of the vectorized math. Those batches are
+// recomputed with the scalar af_* functions, as are all batches when no
+// SIMD instruction set is available.
+//
+// The batches that call exp(), tanh(), sin() or log() are only used in the
+// VECTOR_ACTIVATION mode, since the vectorized math is not bit-identical to
+// the C library. In EXACT_ACTIVATION mode those functions go through the
+// scalar af_* functions; only the step, abs, linear and relu batches, which
+// give exactly the same results, are used in every mode.
+
+#include <float.h>
+#include "ActivationFunctions.h"
+#include "SimdMath.h"
+
+namespace NEAT
+{
+
+#ifdef NEAT_SIMD
+
+// Shorthands for the batch operations used by the kernels
+#define NEAT_AF_BATCH_TYPES \
+    typedef typename B::type V; \
+    typedef typename B::mask M;
+
+template <class B>
+struct af_batch_sigmoid_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::sub(B::mul(B::bitxor(a, B::set1(-0.0)), x), b);
+        bad = B::outside(t, B::set1(SIMD_EXP_MIN), B::set1(SIMD_EXP_MAX));
+        return B::div(B::set1(1.0), B::add(B::set1(1.0), simd_exp<B>(t)));
+    }
+    static double scalar(double x, double a, double b) { return af_sigmoid_unsigned(x, a, b); }
+};
+
+template <class B>
+struct af_batch_sigmoid_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V y = af_batch_sigmoid_unsigned<B>::compute(x, a, b, bad);
+        return B::mul(B::sub(y, B::set1(0.5)), B::set1(2.0));
+    }
+    static double scalar(double x, double a, double b) { return af_sigmoid_signed(x, a, b); }
+};
+
+template <class B>
+struct af_batch_tanh
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::mul(x, a);
+        bad = B::outside(t, B::set1(-DBL_MAX), B::set1(DBL_MAX));
+        return simd_tanh<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_tanh(x, a, b); }
+};
+
+template <class B>
+struct af_batch_tanh_cubic
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::mul(B::mul(B::mul(x, x), x), a);
+        bad = B::outside(t, B::set1(-DBL_MAX), B::set1(DBL_MAX));
+        return simd_tanh<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_tanh_cubic(x, a, b); }
+};
+
+template <class B>
+struct af_batch_step_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::none();
+        return B::select(B::gt(x, b), B::set1(1.0), B::set1(-1.0));
+    }
+    static double scalar(double x, double a, double b) { return af_step_signed(x, b); }
+};
+
+template <class B>
+struct af_batch_step_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::none();
+        return B::select(B::gt(x, B::add(B::set1(0.5), b)), B::set1(1.0), B::set1(0.0));
+    }
+    static double scalar(double x, double a, double b) { return af_step_unsigned(x, b); }
+};
+
+template <class B>
+struct af_batch_gauss_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::add(B::mul(B::mul(B::bitxor(a, B::set1(-0.0)), x), x), b);
+        bad = B::outside(t, B::set1(SIMD_EXP_MIN), B::set1(SIMD_EXP_MAX));
+        return simd_exp<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_gauss_unsigned(x, a, b); }
+};
+
+template <class B>
+struct af_batch_gauss_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V y = af_batch_gauss_unsigned<B>::compute(x, a, b, bad);
+        return B::mul(B::sub(y, B::set1(0.5)), B::set1(2.0));
+    }
+    static double scalar(double x, double a, double b) { return af_gauss_signed(x, a, b); }
+};
+
+template <class B>
+struct af_batch_abs
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::none();
+        V t = B::add(x, b);
+        return B::select(B::gt(B::set1(0.0), t), B::bitxor(t, B::set1(-0.0)), t);
+    }
+    static double scalar(double x, double a, double b) { return af_abs(x, b); }
+};
+
+template <class B>
+struct af_batch_sine_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::add(B::mul(x, B::set1(3.141592)), b);
+        bad = B::outside(t, B::set1(-SIMD_SIN_MAX), B::set1(SIMD_SIN_MAX));
+        return simd_sin<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_sine_signed(x, a, b); }
+};
+
+template <class B>
+struct af_batch_sine_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::add(B::mul(x, a), b);
+        bad = B::outside(t, B::set1(-SIMD_SIN_MAX), B::set1(SIMD_SIN_MAX));
+        return B::div(B::add(simd_sin<B>(t), B::set1(1.0)), B::set1(2.0));
+    }
+    static double scalar(double x, double a, double b) { return af_sine_unsigned(x, a, b); }
+};
+
+template <class B>
+struct af_batch_linear
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::none();
+        return B::add(x, b);
+    }
+    static double scalar(double x, double a, double b) { return af_linear(x, b); }
+};
+
+template <class B>
+struct af_batch_relu
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::none();
+        return B::select(B::gt(x, B::set1(0.0)), x, B::set1(0.0));
+    }
+    static double scalar(double x, double a, double b) { return af_relu(x); }
+};
+
+template <class B>
+struct af_batch_softplus
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        bad = B::outside(x, B::set1(SIMD_EXP_MIN), B::set1(SIMD_EXP_MAX));
+        return simd_log<B>(B::add(B::set1(1.0), simd_exp<B>(x)));
+    }
+    static double scalar(double x, double a, double b) { return af_softplus(x); }
+};
+
+// The FAST_ACTIVATION versions of the functions that have them
+
+template <class B>
+struct af_batch_fast_sigmoid_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::sub(B::mul(B::bitxor(a, B::set1(-0.0)), x), b);
+        bad = B::outside(t, B::set1(SIMD_EXP_MIN), B::set1(SIMD_EXP_MAX));
+        return B::div(B::set1(1.0), B::add(B::set1(1.0), simd_fast_exp<B>(t)));
+    }
+    static double scalar(double x, double a, double b) { return af_fast_sigmoid_unsigned(x, a, b); }
+};
+
+template <class B>
+struct af_batch_fast_sigmoid_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V y = af_batch_fast_sigmoid_unsigned<B>::compute(x, a, b, bad);
+        return B::mul(B::sub(y, B::set1(0.5)), B::set1(2.0));
+    }
+    static double scalar(double x, double a, double b) { return af_fast_sigmoid_signed(x, a, b); }
+};
+
+// (1 - e^-2|t|) / (1 + e^-2|t|) with the sign of t, like fast_tanh()
+template <class B>
+inline typename B::type simd_fast_tanh(typename B::type a_t)
+{
+    typename B::type t_abs = B::min(B::abs(a_t), B::set1(22.0));
+    typename B::type t_e = simd_fast_exp<B>(B::mul(t_abs, B::set1(-2.0)));
+    typename B::type t_y = B::div(B::sub(B::set1(1.0), t_e), B::add(B::set1(1.0), t_e));
+    return B::bitxor(t_y, B::signbit(a_t));
+}
+
+template <class B>
+struct af_batch_fast_tanh
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::mul(x, a);
+        bad = B::outside(t, B::set1(-DBL_MAX), B::set1(DBL_MAX));
+        return simd_fast_tanh<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_fast_tanh(x, a, b); }
+};
+
+template <class B>
+struct af_batch_fast_tanh_cubic
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::mul(B::mul(B::mul(x, x), x), a);
+        bad = B::outside(t, B::set1(-DBL_MAX), B::set1(DBL_MAX));
+        return simd_fast_tanh<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_fast_tanh_cubic(x, a, b); }
+};
+
+template <class B>
+struct af_batch_fast_gauss_unsigned
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V t = B::add(B::mul(B::mul(B::bitxor(a, B::set1(-0.0)), x), x), b);
+        bad = B::outside(t, B::set1(SIMD_EXP_MIN), B::set1(SIMD_EXP_MAX));
+        return simd_fast_exp<B>(t);
+    }
+    static double scalar(double x, double a, double b) { return af_fast_gauss_unsigned(x, a, b); }
+};
+
+template <class B>
+struct af_batch_fast_gauss_signed
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        V y = af_batch_fast_gauss_unsigned<B>::compute(x, a, b, bad);
+        return B::mul(B::sub(y, B::set1(0.5)), B::set1(2.0));
+    }
+    static double scalar(double x, double a, double b) { return af_fast_gauss_signed(x, a, b); }
+};
+
+// max(x, 0) + log(1 + e^-|x|), like af_fast_softplus()
+template <class B>
+struct af_batch_fast_softplus
+{
+    NEAT_AF_BATCH_TYPES
+    static V compute(V x, V a, V b, M& bad)
+    {
+        static const double t_coeffs[] =
+        {
+            2.0 / 11.0, 2.0 / 9.0, 2.0 / 7.0, 2.0 / 5.0, 2.0 / 3.0, 2.0
+        };
+
+        bad = B::outside(x, B::set1(-DBL_MAX), B::set1(DBL_MAX));
+        V u = simd_fast_exp<B>(B::bitxor(B::min(B::abs(x), B::set1(700.0)), B::set1(-0.0)));
+        V s = B::div(u, B::add(B::set1(2.0), u));
+        V y = B::mul(s, simd_poly<B>(B::mul(s, s), t_coeffs, 6));
+        return B::add(B::select(B::gt(x, B::set1(0.0)), x, B::set1(0.0)), y);
+    }
+    static double scalar(double x, double a, double b) { return af_fast_softplus(x); }
+};
+
+#undef NEAT_AF_BATCH_TYPES
+
+// Computes one full batch
+template <class B, class Op>
+inline void af_batch(const double* a_x, const double* a_a, const double* a_b, double* a_y)
+{
+    typename B::mask t_bad;
+    typename B::type t_y = Op::compute(B::load(a_x), B::load(a_a), B::load(a_b), t_bad);
+    if (B::any(t_bad))
+    {
+        for (int i = 0; i < B::size; i++)
+        {
+            a_y[i] = Op::scalar(a_x[i], a_a[i], a_b[i]);
+        }
+    }
+    else
+    {
+        B::store(a_y, t_y);
+    }
+}
+
+// Computes a_y[i] = f(a_x[i], a_a[i], a_b[i]) for i in [0, a_n)
+template <template <class> class Op>
+inline void af_span(const double* a_x, const double* a_a, const double* a_b, double* a_y, unsigned int a_n)
+{
+    typedef DoubleBatch B;
+
+    unsigned int i = 0;
+    for (; i + B::size <= a_n; i += B::size)
+    {
+        af_batch< B, Op<B> >(a_x + i, a_a + i, a_b + i, a_y + i);
+    }
+
+    // A short remainder is cheaper to do one by one,
+    // a longer one goes through a padded batch
+    if ((a_n - i) * 2 < B::size)
+    {
+        for (; i < a_n; i++)
+        {
+            a_y[i] = Op<B>::scalar(a_x[i], a_a[i], a_b[i]);
+        }
+    }
+    else
+    {
+        double t_x[B::size], t_a[B::size], t_b[B::size], t_y[B::size];
+        for (unsigned int j = 0; j < B::size; j++)
+        {
+            bool t_in = (i + j < a_n);
+            t_x[j] = t_in ? a_x[i + j] : 0.0;
+            t_a[j] = t_in ? a_a[i + j] : 0.0;
+            t_b[j] = t_in ? a_b[i + j] : 0.0;
+        }
+        af_batch< B, Op<B> >(t_x, t_a, t_b, t_y);
+        for (unsigned int j = 0; i + j < a_n; j++)
+        {
+            a_y[i + j] = t_y[j];
+        }
+    }
+}
+
+#define NEAT_AF_SPAN(op, scalar_fn) af_span<op>(a_x, a_a, a_b, a_y, a_n)
+
+#else // no SIMD
+
+#define NEAT_AF_SPAN(op, scalar_fn) \
+    for (unsigned int i = 0; i < a_n; i++) \
+    { \
+        a_y[i] = scalar_fn; \
+    }
+
+#endif
+
+#define NEAT_AF_LOOP(scalar_fn) \
+    for (unsigned int i = 0; i < a_n; i++) \
+    { \
+        a_y[i] = scalar_fn; \
+    }
+
+// ActivateSpan() for the FAST_ACTIVATION and TABLE_ACTIVATION modes,
+// and the functions they approximate
+inline void ActivateSpanApproximate(ActivationFunction a_type,
+                                    const double* a_x, const double* a_a, const double* a_b,
+                                    double* a_y, unsigned int a_n, ActivationAccuracy a_accuracy)
+{
+    if (a_accuracy == FAST_ACTIVATION)
+    {
+        switch (a_type)
+        {
+        case SIGNED_SIGMOID:
+            NEAT_AF_SPAN(af_batch_fast_sigmoid_signed, af_fast_sigmoid_signed(a_x[i], a_a[i], a_b[i]));
+            break;
+        case TANH:
+            NEAT_AF_SPAN(af_batch_fast_tanh, af_fast_tanh(a_x[i], a_a[i], a_b[i]));
+            break;
+        case TANH_CUBIC:
+            NEAT_AF_SPAN(af_batch_fast_tanh_cubic, af_fast_tanh_cubic(a_x[i], a_a[i], a_b[i]));
+            break;
+        case SIGNED_GAUSS:
+            NEAT_AF_SPAN(af_batch_fast_gauss_signed, af_fast_gauss_signed(a_x[i], a_a[i], a_b[i]));
+            break;
+        case UNSIGNED_GAUSS:
+            NEAT_AF_SPAN(af_batch_fast_gauss_unsigned, af_fast_gauss_unsigned(a_x[i], a_a[i], a_b[i]));
+            break;
+        case SOFTPLUS:
+            NEAT_AF_SPAN(af_batch_fast_softplus, af_fast_softplus(a_x[i]));
+            break;
+        default:
+            NEAT_AF_SPAN(af_batch_fast_sigmoid_unsigned, af_fast_sigmoid_unsigned(a_x[i], a_a[i], a_b[i]));
+            break;
+        }
+    }
+    else
+    {
+        switch (a_type)
+        {
+        case SIGNED_SIGMOID:
+            NEAT_AF_LOOP(af_table_sigmoid_signed(a_x[i], a_a[i], a_b[i]));
+            break;
+        case TANH:
+            NEAT_AF_LOOP(af_table_tanh(a_x[i], a_a[i], a_b[i]));
+            break;
+        case TANH_CUBIC:
+            NEAT_AF_LOOP(af_table_tanh_cubic(a_x[i], a_a[i], a_b[i]));
+            break;
+        case SIGNED_GAUSS:
+            NEAT_AF_LOOP(af_table_gauss_signed(a_x[i], a_a[i], a_b[i]));
+            break;
+        case UNSIGNED_GAUSS:
+            NEAT_AF_LOOP(af_table_gauss_unsigned(a_x[i], a_a[i], a_b[i]));
+            break;
+        case SOFTPLUS:
+            NEAT_AF_LOOP(af_table_softplus(a_x[i]));
+            break;
+        default:
+            NEAT_AF_LOOP(af_table_sigmoid_unsigned(a_x[i], a_a[i], a_b[i]));
+            break;
+        }
+    }
+}
+
+// The vectorized math when asked for, the C library otherwise
+#define NEAT_AF_VECTOR(op, scalar_fn) \
+    if (a_accuracy == VECTOR_ACTIVATION) \
+    { \
+        NEAT_AF_SPAN(op, scalar_fn); \
+    } \
+    else \
+    { \
+        NEAT_AF_LOOP(scalar_fn); \
+    }
+
+// Applies the activation function a_type to a whole span of neurons:
+// a_y[i] = f(a_x[i]) with slope/shift parameters a_a[i] and a_b[i].
+// The function is selected once per span, the loop itself does not branch.
+inline void ActivateSpan(ActivationFunction a_type,
+                         const double* a_x, const double* a_a, const double* a_b,
+                         double* a_y, unsigned int a_n,
+                         ActivationAccuracy a_accuracy = EXACT_ACTIVATION)
+{
+    if (((a_accuracy == FAST_ACTIVATION) || (a_accuracy == TABLE_ACTIVATION)) && af_is_approximated(a_type))
+    {
+        ActivateSpanApproximate(a_type, a_x, a_a, a_b, a_y, a_n, a_accuracy);
+        return;
+    }
+
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID:
+        NEAT_AF_VECTOR(af_batch_sigmoid_signed, af_sigmoid_signed(a_x[i], a_a[i], a_b[i]));
+        break;
+    case UNSIGNED_SIGMOID:
+        NEAT_AF_VECTOR(af_batch_sigmoid_unsigned, af_sigmoid_unsigned(a_x[i], a_a[i], a_b[i]));
+        break;
+    case TANH:
+        NEAT_AF_VECTOR(af_batch_tanh, af_tanh(a_x[i], a_a[i], a_b[i]));
+        break;
+    case TANH_CUBIC:
+        NEAT_AF_VECTOR(af_batch_tanh_cubic, af_tanh_cubic(a_x[i], a_a[i], a_b[i]));
+        break;
+    case SIGNED_STEP:
+        NEAT_AF_SPAN(af_batch_step_signed, af_step_signed(a_x[i], a_b[i]));
+        break;
+    case UNSIGNED_STEP:
+        NEAT_AF_SPAN(af_batch_step_unsigned, af_step_unsigned(a_x[i], a_b[i]));
+        break;
+    case SIGNED_GAUSS:
+        NEAT_AF_VECTOR(af_batch_gauss_signed, af_gauss_signed(a_x[i], a_a[i], a_b[i]));
+        break;
+    case UNSIGNED_GAUSS:
+        NEAT_AF_VECTOR(af_batch_gauss_unsigned, af_gauss_unsigned(a_x[i], a_a[i], a_b[i]));
+        break;
+    case ABS:
+        NEAT_AF_SPAN(af_batch_abs, af_abs(a_x[i], a_b[i]));
+        break;
+    case SIGNED_SINE:
+        NEAT_AF_VECTOR(af_batch_sine_signed, af_sine_signed(a_x[i], a_a[i], a_b[i]));
+        break;
+    case UNSIGNED_SINE:
+        NEAT_AF_VECTOR(af_batch_sine_unsigned, af_sine_unsigned(a_x[i], a_a[i], a_b[i]));
+        break;
+    case LINEAR:
+        NEAT_AF_SPAN(af_batch_linear, af_linear(a_x[i], a_b[i]));
+        break;
+    case RELU:
+        NEAT_AF_SPAN(af_batch_relu, af_relu(a_x[i]));
+        break;
+    case SOFTPLUS:
+        NEAT_AF_VECTOR(af_batch_softplus, af_softplus(a_x[i]));
+        break;
+    default:
+        NEAT_AF_VECTOR(af_batch_sigmoid_unsigned, af_sigmoid_unsigned(a_x[i], a_a[i], a_b[i]));
+        break;
+    }
+}
+
+#undef NEAT_AF_VECTOR
+#undef NEAT_AF_LOOP
+#undef NEAT_AF_SPAN
+
+// Single precision version. The functions are computed in double
+// precision, a chunk at a time, and rounded to float. There are no float
+// batches, so this runs at the double SIMD width plus the conversions;
+// single precision only widens the accumulation of the connections.
+inline void ActivateSpan(ActivationFunction a_type,
+                         const float* a_x, const float* a_a, const float* a_b,
+                         float* a_y, unsigned int a_n,
+                         ActivationAccuracy a_accuracy = EXACT_ACTIVATION)
+{
+    const unsigned int t_chunk = 64;
+    double t_x[t_chunk], t_a[t_chunk], t_b[t_chunk], t_y[t_chunk];
+
+    for (unsigned int i = 0; i < a_n; i += t_chunk)
+    {
+        unsigned int t_count = (a_n - i < t_chunk) ? (a_n - i) : t_chunk;
+        for (unsigned int j = 0; j < t_count; j++)
+        {
+            t_x[j] = a_x[i + j];
+            t_a[j] = a_a[i + j];
+            t_b[j] = a_b[i + j];
+        }
+        ActivateSpan(a_type, t_x, t_a, t_b, t_y, t_count, a_accuracy);
+        for (unsigned int j = 0; j < t_count; j++)
+        {
+            a_y[i + j] = static_cast<float>(t_y[j]);
+        }
+    }
+}
+
+} // namespace NEAT
+
+#endif
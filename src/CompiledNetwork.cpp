@@ -0,0 +1,1663 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        CompiledNetwork.cpp
+// Description: Implementation of the compiled network.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <array>
+#include <type_traits>
+#include <chrono>
+#include <fstream>
+#include <string>
+#include <stdio.h>
+#include <limits.h>
+#include "CompiledNetwork.h"
+#include "NeuralNetwork.h"
+#include "ActivationKernels.h"
+#include "Assert.h"
+#include "ThreadPool.h"
+
+namespace NEAT
+{
+
+template <class T>
+BasicCompiledNetwork<T>::BasicCompiledNetwork()
+{
+    m_num_threads = 1;
+    m_generation = 0;
+    Clear();
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Clear()
+{
+    m_num_inputs = m_num_outputs = 0;
+    m_slot.clear();
+    m_runs.clear();
+    m_schedule.clear();
+    m_row_start.clear();
+    m_source16.clear();
+    m_source32.clear();
+    m_wide_indices = false;
+    m_weight.clear();
+    m_connection.clear();
+    m_out_row_start.clear();
+    m_out_target.clear();
+    m_out_connection.clear();
+    m_a.clear();
+    m_b.clear();
+    m_timeconst.clear();
+    m_bias.clear();
+    m_activation_function_type.clear();
+    m_state = BasicCompiledNetworkState<T>();
+    m_batch_activesum.clear();
+    m_batch_activation.clear();
+    m_batch_a.clear();
+    m_batch_b.clear();
+    m_program.clear();
+    m_small.reset();
+    m_profile = BackendProfile::Active();
+    m_accuracy = EXACT_ACTIVATION;
+    m_generation++;
+}
+
+// Orders neuron indices by level, cyclic flag and activation function
+// type, keeping the original order among otherwise equal neurons
+struct SlotOrderLess
+{
+    const std::vector<Neuron>* m_neurons;
+    const std::vector<unsigned int>* m_level;
+    const std::vector<bool>* m_cyclic;
+
+    bool operator()(unsigned int a_lhs, unsigned int a_rhs) const
+    {
+        if ((*m_level)[a_lhs] != (*m_level)[a_rhs])
+            return (*m_level)[a_lhs] < (*m_level)[a_rhs];
+        if ((*m_cyclic)[a_lhs] != (*m_cyclic)[a_rhs])
+            return !(*m_cyclic)[a_lhs];
+        return (*m_neurons)[a_lhs].m_activation_function_type < (*m_neurons)[a_rhs].m_activation_function_type;
+    }
+};
+
+// Finds the strongly connected components of the graph given by its
+// incoming edges (the sources of node i are a_source[a_row_start[i] .. a_row_start[i+1])).
+// Returns the component of every node. The components are numbered
+// in topological order - the sources of a component are in itself or
+// in components with smaller numbers.
+static unsigned int FindComponents(const std::vector<unsigned int>& a_row_start,
+                                   const std::vector<unsigned int>& a_source,
+                                   std::vector<unsigned int>& a_component)
+{
+    const unsigned int t_num_nodes = static_cast<unsigned int>(a_row_start.size()) - 1;
+    const unsigned int t_unvisited = 0xFFFFFFFF;
+
+    std::vector<unsigned int> t_index(t_num_nodes, t_unvisited), t_low(t_num_nodes, 0);
+    std::vector<bool> t_on_stack(t_num_nodes, false);
+    std::vector<unsigned int> t_stack;
+
+    // (node, next incoming edge to visit) - the recursion of Tarjan's algorithm
+    std::vector< std::pair<unsigned int, unsigned int> > t_calls;
+
+    unsigned int t_counter = 0, t_num_components = 0;
+    a_component.assign(t_num_nodes, 0);
+
+    for (unsigned int r = 0; r < t_num_nodes; r++)
+    {
+        if (t_index[r] != t_unvisited)
+            continue;
+
+        t_index[r] = t_low[r] = t_counter++;
+        t_stack.push_back(r);
+        t_on_stack[r] = true;
+        t_calls.push_back(std::make_pair(r, a_row_start[r]));
+
+        while (!t_calls.empty())
+        {
+            unsigned int v = t_calls.back().first;
+            unsigned int e = t_calls.back().second;
+
+            if (e < a_row_start[v + 1])
+            {
+                t_calls.back().second++;
+
+                unsigned int w = a_source[e];
+                if (t_index[w] == t_unvisited)
+                {
+                    t_index[w] = t_low[w] = t_counter++;
+                    t_stack.push_back(w);
+                    t_on_stack[w] = true;
+                    t_calls.push_back(std::make_pair(w, a_row_start[w]));
+                }
+                else if (t_on_stack[w])
+                {
+                    t_low[v] = std::min(t_low[v], t_index[w]);
+                }
+            }
+            else
+            {
+                t_calls.pop_back();
+                if (!t_calls.empty())
+                {
+                    unsigned int t_parent = t_calls.back().first;
+                    t_low[t_parent] = std::min(t_low[t_parent], t_low[v]);
+                }
+
+                if (t_low[v] == t_index[v])
+                {
+                    // v is the root of a component, pop it off the stack
+                    unsigned int w;
+                    do
+                    {
+                        w = t_stack.back();
+                        t_stack.pop_back();
+                        t_on_stack[w] = false;
+                        a_component[w] = t_num_components;
+                    }
+                    while (w != v);
+
+                    t_num_components++;
+                }
+            }
+        }
+    }
+
+    return t_num_components;
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Build(const std::vector<Neuron>& a_neurons,
+                            const std::vector<Connection>& a_connections,
+                            unsigned int a_num_inputs, unsigned int a_num_outputs,
+                            ActivationAccuracy a_accuracy, const BackendProfile& a_profile)
+{
+    unsigned int t_num_neurons = static_cast<unsigned int>(a_neurons.size());
+
+    m_num_inputs = a_num_inputs;
+    m_num_outputs = a_num_outputs;
+    m_accuracy = a_accuracy;
+    m_profile = a_profile;
+    m_batch_a.clear();
+    m_batch_b.clear();
+
+    // The incoming connections per neuron, in the original numbering.
+    // Connections into the inputs are dropped, the inputs never get activated.
+    std::vector<unsigned int> t_row_start(t_num_neurons + 1, 0);
+    for (unsigned int i = 0; i < a_connections.size(); i++)
+    {
+        unsigned int t_target = a_connections[i].m_target_neuron_idx;
+        if ((t_target >= m_num_inputs) && (t_target < t_num_neurons))
+        {
+            t_row_start[t_target + 1]++;
+        }
+    }
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_row_start[i + 1] += t_row_start[i];
+    }
+    std::vector<unsigned int> t_source(t_row_start[t_num_neurons]);
+    std::vector<unsigned int> t_connection(t_row_start[t_num_neurons]);
+    {
+        std::vector<unsigned int> t_next(t_row_start.begin(), t_row_start.end() - 1);
+        for (unsigned int i = 0; i < a_connections.size(); i++)
+        {
+            unsigned int t_target = a_connections[i].m_target_neuron_idx;
+            if ((t_target >= m_num_inputs) && (t_target < t_num_neurons))
+            {
+                unsigned int t_pos = t_next[t_target]++;
+                t_source[t_pos] = a_connections[i].m_source_neuron_idx;
+                t_connection[t_pos] = i;
+            }
+        }
+    }
+
+    // Find the cycles and the level of every neuron
+    std::vector<unsigned int> t_component;
+    unsigned int t_num_components = FindComponents(t_row_start, t_source, t_component);
+
+    std::vector<bool> t_component_cyclic(t_num_components, false);
+    std::vector< std::vector<unsigned int> > t_members(t_num_components);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_members[t_component[i]].push_back(i);
+    }
+
+    std::vector<unsigned int> t_component_level(t_num_components, 0);
+    for (unsigned int c = 0; c < t_num_components; c++)
+    {
+        unsigned int t_level = 0;
+        bool t_cyclic = (t_members[c].size() > 1);
+        for (unsigned int k = 0; k < t_members[c].size(); k++)
+        {
+            unsigned int t_neuron = t_members[c][k];
+            if (t_neuron >= m_num_inputs)
+            {
+                t_level = std::max(t_level, 1u);
+            }
+            for (unsigned int j = t_row_start[t_neuron]; j < t_row_start[t_neuron + 1]; j++)
+            {
+                unsigned int t_src_component = t_component[t_source[j]];
+                if (t_src_component == c)
+                {
+                    t_cyclic = true;
+                }
+                else
+                {
+                    t_level = std::max(t_level, t_component_level[t_src_component] + 1);
+                }
+            }
+        }
+        t_component_level[c] = t_level;
+        t_component_cyclic[c] = t_cyclic;
+    }
+
+    std::vector<unsigned int> t_level(t_num_neurons);
+    std::vector<bool> t_cyclic(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_level[i] = t_component_level[t_component[i]];
+        t_cyclic[i] = t_component_cyclic[t_component[i]];
+    }
+
+    // Assign the slots - inputs first, then the rest in topological order,
+    // grouped by activation function within each level
+    std::vector<unsigned int> t_order(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_order[i] = i;
+    }
+    if (m_num_inputs < t_num_neurons)
+    {
+        SlotOrderLess t_less;
+        t_less.m_neurons = &a_neurons;
+        t_less.m_level = &t_level;
+        t_less.m_cyclic = &t_cyclic;
+        std::stable_sort(t_order.begin() + m_num_inputs, t_order.end(), t_less);
+    }
+    m_slot.resize(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        m_slot[t_order[i]] = i;
+    }
+
+    // Split the slots into schedule steps and activation runs
+    m_runs.clear();
+    m_schedule.clear();
+    for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+    {
+        unsigned int t_neuron = t_order[i];
+        if (m_schedule.empty() ||
+            (t_level[t_order[i - 1]] != t_level[t_neuron]) ||
+            (t_cyclic[t_order[i - 1]] != t_cyclic[t_neuron]))
+        {
+            ScheduleStep t_step;
+            t_step.m_begin = i;
+            t_step.m_run_begin = static_cast<unsigned int>(m_runs.size());
+            t_step.m_cyclic = t_cyclic[t_neuron];
+            m_schedule.push_back(t_step);
+        }
+
+        ActivationFunction t_type = a_neurons[t_neuron].m_activation_function_type;
+        if ((m_runs.empty()) ||
+            (m_schedule.back().m_run_begin == m_runs.size()) ||
+            (m_runs.back().m_type != t_type))
+        {
+            ActivationRun t_run;
+            t_run.m_type = t_type;
+            t_run.m_begin = i;
+            m_runs.push_back(t_run);
+        }
+        m_runs.back().m_end = i + 1;
+        m_schedule.back().m_end = i + 1;
+        m_schedule.back().m_run_end = static_cast<unsigned int>(m_runs.size());
+    }
+
+    // Neuron parameters and state
+    m_a.resize(t_num_neurons);
+    m_b.resize(t_num_neurons);
+    m_timeconst.resize(t_num_neurons);
+    m_bias.resize(t_num_neurons);
+    m_activation_function_type.resize(t_num_neurons);
+    m_state.m_activesum.resize(t_num_neurons);
+    m_state.m_activation.resize(t_num_neurons);
+    m_state.m_membrane_potential.resize(t_num_neurons);
+    m_state.m_sent_valid = false;
+    m_generation++;
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        const Neuron& t_neuron = a_neurons[t_order[i]];
+        m_a[i] = t_neuron.m_a;
+        m_b[i] = t_neuron.m_b;
+        m_timeconst[i] = t_neuron.m_timeconst;
+        m_bias[i] = t_neuron.m_bias;
+        m_activation_function_type[i] = t_neuron.m_activation_function_type;
+        m_state.m_activesum[i] = 0;
+        m_state.m_activation[i] = t_neuron.m_activation;
+        m_state.m_membrane_potential[i] = t_neuron.m_membrane_potential;
+    }
+
+    // Place the connections in the rows of their slots, preserving their order
+    m_row_start.resize(t_num_neurons + 1);
+    m_wide_indices = (t_num_neurons > 65536);
+    m_source16.resize(m_wide_indices ? 0 : t_source.size());
+    m_source32.resize(m_wide_indices ? t_source.size() : 0);
+    m_weight.resize(t_source.size());
+    m_connection.resize(t_source.size());
+    m_row_start[0] = 0;
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        unsigned int t_neuron = t_order[i];
+        unsigned int t_pos = m_row_start[i];
+        for (unsigned int j = t_row_start[t_neuron]; j < t_row_start[t_neuron + 1]; j++, t_pos++)
+        {
+            if (m_wide_indices)
+                m_source32[t_pos] = m_slot[t_source[j]];
+            else
+                m_source16[t_pos] = static_cast<unsigned short>(m_slot[t_source[j]]);
+            m_weight[t_pos] = a_connections[t_connection[j]].m_weight;
+            m_connection[t_pos] = t_connection[j];
+        }
+        m_row_start[i + 1] = t_pos;
+    }
+
+    // The same connections by source slot, for ActivateDelta()
+    m_out_row_start.assign(t_num_neurons + 1, 0);
+    for (unsigned int j = 0; j < NumConnections(); j++)
+    {
+        m_out_row_start[Source(j) + 1]++;
+    }
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        m_out_row_start[i + 1] += m_out_row_start[i];
+    }
+    m_out_target.resize(NumConnections());
+    m_out_connection.resize(NumConnections());
+    std::vector<unsigned int> t_out_pos(m_out_row_start.begin(), m_out_row_start.end() - 1);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        for (unsigned int j = m_row_start[i]; j < m_row_start[i + 1]; j++)
+        {
+            unsigned int t_pos = t_out_pos[Source(j)]++;
+            m_out_target[t_pos] = i;
+            m_out_connection[t_pos] = j;
+        }
+    }
+
+    BuildProgram();
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::UpdateParameters(const std::vector<Neuron>& a_neurons,
+                                               const std::vector<Connection>& a_connections)
+{
+    for (unsigned int i = 0; i < m_slot.size(); i++)
+    {
+        const Neuron& t_neuron = a_neurons[i];
+        unsigned int t_slot = m_slot[i];
+        m_a[t_slot] = t_neuron.m_a;
+        m_b[t_slot] = t_neuron.m_b;
+        m_timeconst[t_slot] = t_neuron.m_timeconst;
+        m_bias[t_slot] = t_neuron.m_bias;
+    }
+    for (unsigned int i = 0; i < m_weight.size(); i++)
+    {
+        m_weight[i] = a_connections[m_connection[i]].m_weight;
+    }
+
+    // the sums of the event-driven activation, in any state, are for the old weights
+    m_generation++;
+
+    // the copies of the parameters
+    m_batch_a.clear();
+    m_batch_b.clear();
+    BuildProgram();
+}
+
+//////////////////////////////////////////////////////////////////
+// The program
+//////////////////////////////////////////////////////////////////
+
+const unsigned int NUM_ACTIVATION_FUNCTIONS = SOFTPLUS + 1;
+
+// The functions an instruction can compute: the activation functions,
+// then their FAST_ACTIVATION and TABLE_ACTIVATION versions
+enum ProgramFunction
+{
+    FAST_SIGNED_SIGMOID = NUM_ACTIVATION_FUNCTIONS,
+    FAST_UNSIGNED_SIGMOID,
+    FAST_TANH,
+    FAST_TANH_CUBIC,
+    FAST_SIGNED_GAUSS,
+    FAST_UNSIGNED_GAUSS,
+    FAST_SOFTPLUS,
+    TABLE_SIGNED_SIGMOID,
+    TABLE_UNSIGNED_SIGMOID,
+    TABLE_TANH,
+    TABLE_TANH_CUBIC,
+    TABLE_SIGNED_GAUSS,
+    TABLE_UNSIGNED_GAUSS,
+    TABLE_SOFTPLUS,
+    NUM_PROGRAM_FUNCTIONS
+};
+
+// The function that computes a_type in the given accuracy mode
+static unsigned int GetProgramFunction(ActivationFunction a_type, ActivationAccuracy a_accuracy)
+{
+    unsigned int t_af = static_cast<unsigned int>(a_type);
+    if (t_af >= NUM_ACTIVATION_FUNCTIONS)
+    {
+        t_af = UNSIGNED_SIGMOID; // like af_apply()
+    }
+    if (((a_accuracy != FAST_ACTIVATION) && (a_accuracy != TABLE_ACTIVATION)) ||
+        !af_is_approximated(static_cast<ActivationFunction>(t_af)))
+    {
+        return t_af;
+    }
+
+    unsigned int t_base = (a_accuracy == FAST_ACTIVATION) ? FAST_SIGNED_SIGMOID : TABLE_SIGNED_SIGMOID;
+    switch (t_af)
+    {
+    case SIGNED_SIGMOID: return t_base;
+    case TANH:           return t_base + 2;
+    case TANH_CUBIC:     return t_base + 3;
+    case SIGNED_GAUSS:   return t_base + 4;
+    case UNSIGNED_GAUSS: return t_base + 5;
+    case SOFTPLUS:       return t_base + 6;
+    default:             return t_base + 1;
+    }
+}
+
+// How an instruction gathers the neuron's input.
+// The opcode is (input kind * NUM_PROGRAM_FUNCTIONS + function).
+enum InputKind
+{
+    OP_NO_INPUTS = 0,
+    OP_ONE_INPUT,
+    OP_TWO_INPUTS,
+    OP_ROW           // three or more inputs, summed from the CSR row
+};
+
+template <class T>
+static SmallCompiledNetwork<T>* MakeSmallCompiledNetwork(const BasicCompiledNetwork<T>& a_net);
+
+template <class T>
+void BasicCompiledNetwork<T>::BuildProgram()
+{
+    m_program.clear();
+    m_small.reset();
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    m_small.reset(MakeSmallCompiledNetwork(*this));
+    if (NumNeurons() - m_num_inputs > m_profile.m_program_max_neurons)
+        return;
+
+    m_program.resize(NumNeurons() - m_num_inputs);
+    for (unsigned int i = m_num_inputs; i < NumNeurons(); i++)
+    {
+        Instruction& t_ins = m_program[i - m_num_inputs];
+        unsigned int t_count = m_row_start[i + 1] - m_row_start[i];
+
+        unsigned int t_kind = OP_ROW;
+        if (t_count < 3)
+        {
+            t_kind = t_count; // OP_NO_INPUTS, OP_ONE_INPUT or OP_TWO_INPUTS
+        }
+
+        t_ins.m_op = t_kind * NUM_PROGRAM_FUNCTIONS +
+                     GetProgramFunction(m_activation_function_type[i], m_accuracy);
+        t_ins.m_target = i;
+        t_ins.m_source[0] = t_ins.m_source[1] = 0;
+        t_ins.m_weight[0] = t_ins.m_weight[1] = 0;
+        for (unsigned int k = 0; (k < t_count) && (k < 2); k++)
+        {
+            t_ins.m_source[k] = Source(m_row_start[i] + k);
+            t_ins.m_weight[k] = m_weight[m_row_start[i] + k];
+        }
+        t_ins.m_a = m_a[i];
+        t_ins.m_b = m_b[i];
+    }
+}
+
+// The cases of all activation functions for the input kind a_kind,
+// with the input computed by the expression a_x
+#define NEAT_PROGRAM_CASES(a_kind, a_x, a_a, a_b) \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + SIGNED_SIGMOID: \
+        t_y = af_sigmoid_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + UNSIGNED_SIGMOID: \
+        t_y = af_sigmoid_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TANH: \
+        t_y = af_tanh(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TANH_CUBIC: \
+        t_y = af_tanh_cubic(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + SIGNED_STEP: \
+        t_y = af_step_signed(a_x, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + UNSIGNED_STEP: \
+        t_y = af_step_unsigned(a_x, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + SIGNED_GAUSS: \
+        t_y = af_gauss_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + UNSIGNED_GAUSS: \
+        t_y = af_gauss_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + ABS: \
+        t_y = af_abs(a_x, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + SIGNED_SINE: \
+        t_y = af_sine_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + UNSIGNED_SINE: \
+        t_y = af_sine_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + LINEAR: \
+        t_y = af_linear(a_x, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + RELU: \
+        t_y = af_relu(a_x); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + SOFTPLUS: \
+        t_y = af_softplus(a_x); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_SIGNED_SIGMOID: \
+        t_y = af_fast_sigmoid_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_UNSIGNED_SIGMOID: \
+        t_y = af_fast_sigmoid_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_TANH: \
+        t_y = af_fast_tanh(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_TANH_CUBIC: \
+        t_y = af_fast_tanh_cubic(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_SIGNED_GAUSS: \
+        t_y = af_fast_gauss_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_UNSIGNED_GAUSS: \
+        t_y = af_fast_gauss_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + FAST_SOFTPLUS: \
+        t_y = af_fast_softplus(a_x); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_SIGNED_SIGMOID: \
+        t_y = af_table_sigmoid_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_UNSIGNED_SIGMOID: \
+        t_y = af_table_sigmoid_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_TANH: \
+        t_y = af_table_tanh(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_TANH_CUBIC: \
+        t_y = af_table_tanh_cubic(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_SIGNED_GAUSS: \
+        t_y = af_table_gauss_signed(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_UNSIGNED_GAUSS: \
+        t_y = af_table_gauss_unsigned(a_x, a_a, a_b); break; \
+    case a_kind * NUM_PROGRAM_FUNCTIONS + TABLE_SOFTPLUS: \
+        t_y = af_table_softplus(a_x); break;
+
+template <class T>
+void BasicCompiledNetwork<T>::RunProgram(const T* a_in, T* a_out, unsigned int a_begin, unsigned int a_end) const
+{
+    const Instruction* t_program = &m_program[0];
+
+    for (unsigned int p = a_begin; p < a_end; p++)
+    {
+        const Instruction& t_ins = t_program[p];
+        T t_row_sum = 0;
+        if (t_ins.m_op >= OP_ROW * NUM_PROGRAM_FUNCTIONS)
+        {
+            unsigned int t_slot = t_ins.m_target;
+            for (unsigned int j = m_row_start[t_slot]; j < m_row_start[t_slot + 1]; j++)
+            {
+                t_row_sum += a_in[Source(j)] * m_weight[j];
+            }
+        }
+
+        double t_y = 0;
+        switch (t_ins.m_op)
+        {
+            NEAT_PROGRAM_CASES(OP_NO_INPUTS, 0.0, t_ins.m_a, t_ins.m_b)
+            NEAT_PROGRAM_CASES(OP_ONE_INPUT, a_in[t_ins.m_source[0]] * t_ins.m_weight[0], t_ins.m_a, t_ins.m_b)
+            NEAT_PROGRAM_CASES(OP_TWO_INPUTS, a_in[t_ins.m_source[0]] * t_ins.m_weight[0] +
+                                              a_in[t_ins.m_source[1]] * t_ins.m_weight[1], t_ins.m_a, t_ins.m_b)
+            NEAT_PROGRAM_CASES(OP_ROW, t_row_sum, t_ins.m_a, t_ins.m_b)
+        default:
+            break;
+        }
+        a_out[t_ins.m_target] = static_cast<T>(t_y);
+    }
+}
+
+//////////////////////////////////////////////////////////////////
+// The fixed capacity form
+//
+// A network of at most MAX_NEURONS neurons and MAX_CONNECTIONS
+// connections, with all of its arrays in the object itself, so it is
+// a single small block of memory (a few hundred bytes to a few KB).
+// The sources are bytes and the rows are indexed by bytes too where
+// they fit. The capacities are constants, so the arrays need no
+// allocation and the sums of a step go to an array on the stack. The
+// loops run over the network's own neurons and connections, at most
+// the capacities. Like the program, it keeps the sums in registers and
+// on the stack, not in the state's m_activesum.
+//
+// Loops to the capacities themselves, over connections padded with
+// zero weights into a spare slot, were tried and were slower on CPPNs
+// of 10 to 30 neurons: the activation functions dominate, and the
+// padding and the test for the end of each neuron cost more than
+// loading the bounds of the rows saves.
+//////////////////////////////////////////////////////////////////
+
+// The index type for values up to a_max
+template <unsigned int a_max>
+struct SmallIndex
+{
+    typedef typename std::conditional<(a_max < 256), unsigned char, unsigned short>::type type;
+};
+
+template <class T, unsigned int MAX_NEURONS, unsigned int MAX_CONNECTIONS>
+class FixedCompiledNetwork : public SmallCompiledNetwork<T>
+{
+public:
+    typedef typename SmallIndex<MAX_NEURONS>::type SourceIndex;
+    typedef typename SmallIndex<MAX_CONNECTIONS>::type RowIndex;
+
+    // a_net must fit, MakeSmallCompiledNetwork() picks the capacities
+    explicit FixedCompiledNetwork(const BasicCompiledNetwork<T>& a_net)
+    {
+        ASSERT((a_net.NumNeurons() <= MAX_NEURONS) && (a_net.NumConnections() <= MAX_CONNECTIONS));
+        // clamped all the same, so no array is ever overrun
+        m_num_neurons = std::min(a_net.NumNeurons(), MAX_NEURONS);
+        m_num_inputs = std::min(a_net.m_num_inputs, m_num_neurons);
+        unsigned int t_num_connections = std::min(a_net.NumConnections(), MAX_CONNECTIONS);
+        for (unsigned int i = 0; i <= m_num_neurons; i++)
+        {
+            m_row_start[i] = static_cast<RowIndex>(std::min(a_net.m_row_start[i], t_num_connections));
+        }
+        for (unsigned int j = 0; j < t_num_connections; j++)
+        {
+            m_source[j] = static_cast<SourceIndex>(a_net.Source(j));
+            m_weight[j] = a_net.m_weight[j];
+        }
+        for (unsigned int i = 0; i < m_num_neurons; i++)
+        {
+            m_function[i] = static_cast<unsigned char>(GetProgramFunction(a_net.m_activation_function_type[i],
+                                                                          a_net.m_accuracy));
+            m_a[i] = a_net.m_a[i];
+            m_b[i] = a_net.m_b[i];
+        }
+    }
+
+    void Activate(T* a_activation) const
+    {
+        T t_sum[MAX_NEURONS];
+        for (unsigned int i = m_num_inputs; i < m_num_neurons; i++)
+        {
+            t_sum[i] = RowSum(a_activation, i);
+        }
+        for (unsigned int i = m_num_inputs; i < m_num_neurons; i++)
+        {
+            a_activation[i] = Apply(i, t_sum[i]);
+        }
+    }
+
+    void ActivateTopological(T* a_activation) const
+    {
+        for (unsigned int i = m_num_inputs; i < m_num_neurons; i++)
+        {
+            a_activation[i] = Apply(i, RowSum(a_activation, i));
+        }
+    }
+
+private:
+
+    T RowSum(const T* a_activation, unsigned int a_slot) const
+    {
+        T t_sum = 0;
+        for (unsigned int j = m_row_start[a_slot]; j < m_row_start[a_slot + 1]; j++)
+        {
+            t_sum += a_activation[m_source[j]] * m_weight[j];
+        }
+        return t_sum;
+    }
+
+    T Apply(unsigned int a_slot, T a_x) const
+    {
+        double t_y = 0;
+        // the cases of the kind 0 are just the functions
+        switch (m_function[a_slot])
+        {
+            NEAT_PROGRAM_CASES(OP_NO_INPUTS, a_x, m_a[a_slot], m_b[a_slot])
+        default:
+            break;
+        }
+        return static_cast<T>(t_y);
+    }
+
+    unsigned int m_num_inputs, m_num_neurons;
+    std::array<RowIndex, MAX_NEURONS + 1> m_row_start;
+    std::array<SourceIndex, MAX_CONNECTIONS> m_source;
+    std::array<T, MAX_CONNECTIONS> m_weight;
+    std::array<T, MAX_NEURONS> m_a, m_b;
+    std::array<unsigned char, MAX_NEURONS> m_function;
+};
+
+// The fixed capacity form of a_net in the smallest size that fits it,
+// or NULL if none does
+template <class T>
+static SmallCompiledNetwork<T>* MakeSmallCompiledNetwork(const BasicCompiledNetwork<T>& a_net)
+{
+    unsigned int t_neurons = a_net.NumNeurons(), t_connections = a_net.NumConnections();
+    if ((t_neurons <= 16) && (t_connections <= 64))
+        return new FixedCompiledNetwork<T, 16, 64>(a_net);
+    if ((t_neurons <= 32) && (t_connections <= 128))
+        return new FixedCompiledNetwork<T, 32, 128>(a_net);
+    if ((t_neurons <= 32) && (t_connections <= 256))
+        return new FixedCompiledNetwork<T, 32, 256>(a_net);
+    return NULL;
+}
+
+#undef NEAT_PROGRAM_CASES
+
+// Sums up the incoming signals of the rows [a_begin .. a_end).
+// I is the type of the source indices.
+template <class T, class I>
+static void AccumulateRows(const unsigned int* a_row_start, const I* a_source, const T* a_weight,
+                           const T* a_activation, T* a_activesum,
+                           unsigned int a_begin, unsigned int a_end)
+{
+    for (unsigned int i = a_begin; i < a_end; i++)
+    {
+        T t_sum = 0;
+        for (unsigned int j = a_row_start[i]; j < a_row_start[i + 1]; j++)
+        {
+            t_sum += a_activation[a_source[j]] * a_weight[j];
+        }
+        a_activesum[i] = t_sum;
+    }
+}
+
+// In single precision the rows are summed up a whole batch of connections
+// at a time. This changes the order of the additions, so unlike in double
+// precision the sums are not exactly the ones of NeuralNetwork's loops.
+template <class I>
+static void AccumulateRows(const unsigned int* a_row_start, const I* a_source, const float* a_weight,
+                           const float* a_activation, float* a_activesum,
+                           unsigned int a_begin, unsigned int a_end)
+{
+    for (unsigned int i = a_begin; i < a_end; i++)
+    {
+        unsigned int j = a_row_start[i];
+        float t_sum = 0;
+#ifdef NEAT_SIMD
+        typedef FloatBatch B;
+        if (j + B::size <= a_row_start[i + 1])
+        {
+            B::type t_sums = B::mul(B::gather(a_activation, a_source + j), B::load(a_weight + j));
+            for (j += B::size; j + B::size <= a_row_start[i + 1]; j += B::size)
+            {
+                t_sums = B::add(t_sums, B::mul(B::gather(a_activation, a_source + j), B::load(a_weight + j)));
+            }
+            t_sum = B::sum(t_sums);
+        }
+#endif
+        for (; j < a_row_start[i + 1]; j++)
+        {
+            t_sum += a_activation[a_source[j]] * a_weight[j];
+        }
+        a_activesum[i] = t_sum;
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Accumulate(BasicCompiledNetworkState<T>& a_state,
+                                         unsigned int a_begin, unsigned int a_end) const
+{
+    if (m_weight.empty())
+    {
+        std::fill(a_state.m_activesum.begin() + a_begin, a_state.m_activesum.begin() + a_end, static_cast<T>(0));
+    }
+    else if (m_wide_indices)
+    {
+        AccumulateRows(&m_row_start[0], &m_source32[0], &m_weight[0],
+                       &a_state.m_activation[0], &a_state.m_activesum[0], a_begin, a_end);
+    }
+    else
+    {
+        AccumulateRows(&m_row_start[0], &m_source16[0], &m_weight[0],
+                       &a_state.m_activation[0], &a_state.m_activesum[0], a_begin, a_end);
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ApplyActivationFunctions(BasicCompiledNetworkState<T>& a_state,
+                                                       unsigned int a_begin, unsigned int a_end) const
+{
+    for (unsigned int r = a_begin; r < a_end; r++)
+    {
+        const ActivationRun& t_run = m_runs[r];
+        ActivateSpan(t_run.m_type,
+                     &a_state.m_activesum[t_run.m_begin], &m_a[t_run.m_begin], &m_b[t_run.m_begin],
+                     &a_state.m_activation[t_run.m_begin], t_run.m_end - t_run.m_begin, m_accuracy);
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ApplyActivationFunctionsToSlots(BasicCompiledNetworkState<T>& a_state,
+                                                              unsigned int a_begin, unsigned int a_end) const
+{
+    // the first run that ends after a_begin
+    unsigned int t_lo = 0, t_hi = static_cast<unsigned int>(m_runs.size());
+    while (t_lo < t_hi)
+    {
+        unsigned int t_mid = (t_lo + t_hi) / 2;
+        if (m_runs[t_mid].m_end <= a_begin)
+            t_lo = t_mid + 1;
+        else
+            t_hi = t_mid;
+    }
+
+    for (unsigned int r = t_lo; (r < m_runs.size()) && (m_runs[r].m_begin < a_end); r++)
+    {
+        const ActivationRun& t_run = m_runs[r];
+        unsigned int t_begin = std::max(t_run.m_begin, a_begin);
+        unsigned int t_end = std::min(t_run.m_end, a_end);
+        ActivateSpan(t_run.m_type,
+                     &a_state.m_activesum[t_begin], &m_a[t_begin], &m_b[t_begin],
+                     &a_state.m_activation[t_begin], t_end - t_begin, m_accuracy);
+    }
+}
+
+template <class T>
+bool BasicCompiledNetwork<T>::UseThreads(unsigned int a_begin, unsigned int a_end) const
+{
+    return (m_num_threads > 1) && (m_row_start[a_end] - m_row_start[a_begin] >= m_profile.m_parallel_min_connections);
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateParallel(BasicCompiledNetworkState<T>& a_state,
+                                               unsigned int a_begin, unsigned int a_end,
+                                               SumUpdate a_update, double a_dtime) const
+{
+    ThreadPool& t_pool = ThreadPool::Shared();
+    unsigned int t_num_chunks = std::min(m_num_threads, t_pool.NumWorkers() + 1);
+    t_num_chunks = std::min(t_num_chunks, a_end - a_begin);
+
+    // Split the slots into chunks of about the same work, counting a
+    // connection as one and the activation function of a slot as one.
+    // The work up to slot i, m_row_start[i] + i, grows with i.
+    std::vector<unsigned int> t_bound(t_num_chunks + 1);
+    t_bound[0] = a_begin;
+    t_bound[t_num_chunks] = a_end;
+    const unsigned int t_work_begin = m_row_start[a_begin] + a_begin;
+    const double t_work = static_cast<double>(m_row_start[a_end] + a_end - t_work_begin);
+    for (unsigned int c = 1; c < t_num_chunks; c++)
+    {
+        unsigned int t_target = t_work_begin + static_cast<unsigned int>(t_work * c / t_num_chunks);
+        unsigned int t_lo = t_bound[c - 1], t_hi = a_end;
+        while (t_lo < t_hi)
+        {
+            unsigned int t_mid = (t_lo + t_hi) / 2;
+            if (m_row_start[t_mid] + t_mid < t_target)
+                t_lo = t_mid + 1;
+            else
+                t_hi = t_mid;
+        }
+        t_bound[c] = t_lo;
+    }
+
+    // All the sums first, they read the activations the second pass writes
+    t_pool.Run(t_num_chunks, [&](unsigned int c)
+    {
+        Accumulate(a_state, t_bound[c], t_bound[c + 1]);
+    });
+
+    t_pool.Run(t_num_chunks, [&](unsigned int c)
+    {
+        unsigned int t_begin = t_bound[c], t_end = t_bound[c + 1];
+        T* t_activesum = &a_state.m_activesum[0];
+        if (a_update == ADD_BIAS)
+        {
+            for (unsigned int i = t_begin; i < t_end; i++)
+            {
+                t_activesum[i] += m_bias[i];
+            }
+        }
+        else if (a_update == LEAKY)
+        {
+            T* t_membrane_potential = &a_state.m_membrane_potential[0];
+            for (unsigned int i = t_begin; i < t_end; i++)
+            {
+                T t_const = static_cast<T>(a_dtime) / m_timeconst[i];
+                t_membrane_potential[i] = (static_cast<T>(1) - t_const) * t_membrane_potential[i] + t_const * t_activesum[i];
+                t_activesum[i] = t_membrane_potential[i] + m_bias[i];
+            }
+        }
+        ApplyActivationFunctionsToSlots(a_state, t_begin, t_end);
+    });
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateFast(BasicCompiledNetworkState<T>& a_state) const
+{
+    a_state.m_sent_valid = false;
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    Accumulate(a_state, m_num_inputs, NumNeurons());
+    ActivateSpan(UNSIGNED_SIGMOID,
+                 &a_state.m_activesum[m_num_inputs], &m_a[m_num_inputs], &m_b[m_num_inputs],
+                 &a_state.m_activation[m_num_inputs], NumNeurons() - m_num_inputs, m_accuracy);
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Activate(BasicCompiledNetworkState<T>& a_state) const
+{
+    a_state.m_sent_valid = false;
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    if (m_small)
+    {
+        m_small->Activate(&a_state.m_activation[0]);
+        return;
+    }
+
+    if (m_program.empty() && UseThreads(m_num_inputs, NumNeurons()))
+    {
+        ActivateParallel(a_state, m_num_inputs, NumNeurons(), NO_SUM_UPDATE, 0);
+        return;
+    }
+
+    if (!m_program.empty())
+    {
+        // All neurons read the old activations and write the new ones
+        a_state.m_next_activation.resize(NumNeurons());
+        std::copy(a_state.m_activation.begin(), a_state.m_activation.begin() + m_num_inputs,
+                  a_state.m_next_activation.begin());
+        RunProgram(&a_state.m_activation[0], &a_state.m_next_activation[0],
+                   0, static_cast<unsigned int>(m_program.size()));
+        a_state.m_activation.swap(a_state.m_next_activation);
+        return;
+    }
+
+    Accumulate(a_state, m_num_inputs, NumNeurons());
+    ApplyActivationFunctions(a_state, 0, static_cast<unsigned int>(m_runs.size()));
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateUseInternalBias(BasicCompiledNetworkState<T>& a_state) const
+{
+    a_state.m_sent_valid = false;
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    if (UseThreads(m_num_inputs, NumNeurons()))
+    {
+        ActivateParallel(a_state, m_num_inputs, NumNeurons(), ADD_BIAS, 0);
+        return;
+    }
+
+    Accumulate(a_state, m_num_inputs, NumNeurons());
+    for (unsigned int i = m_num_inputs; i < NumNeurons(); i++)
+    {
+        a_state.m_activesum[i] += m_bias[i];
+    }
+    ApplyActivationFunctions(a_state, 0, static_cast<unsigned int>(m_runs.size()));
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateLeaky(BasicCompiledNetworkState<T>& a_state, double a_dtime) const
+{
+    a_state.m_sent_valid = false;
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    if (UseThreads(m_num_inputs, NumNeurons()))
+    {
+        ActivateParallel(a_state, m_num_inputs, NumNeurons(), LEAKY, a_dtime);
+        return;
+    }
+
+    T* t_activesum = &a_state.m_activesum[0];
+    T* t_membrane_potential = &a_state.m_membrane_potential[0];
+    Accumulate(a_state, m_num_inputs, NumNeurons());
+    for (unsigned int i = m_num_inputs; i < NumNeurons(); i++)
+    {
+        T t_const = static_cast<T>(a_dtime) / m_timeconst[i];
+        t_membrane_potential[i] = (static_cast<T>(1) - t_const) * t_membrane_potential[i] + t_const * t_activesum[i];
+        t_activesum[i] = t_membrane_potential[i] + m_bias[i];
+    }
+    ApplyActivationFunctions(a_state, 0, static_cast<unsigned int>(m_runs.size()));
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateTopological(BasicCompiledNetworkState<T>& a_state,
+                                                  unsigned int a_recurrent_iterations) const
+{
+    a_state.m_sent_valid = false;
+    if (m_small && IsAcyclic())
+    {
+        m_small->ActivateTopological(&a_state.m_activation[0]);
+        return;
+    }
+
+    for (unsigned int s = 0; s < m_schedule.size(); s++)
+    {
+        const ScheduleStep& t_step = m_schedule[s];
+        if (!t_step.m_cyclic && !m_program.empty())
+        {
+            // The neurons of an acyclic step don't depend on each other
+            RunProgram(&a_state.m_activation[0], &a_state.m_activation[0],
+                       t_step.m_begin - m_num_inputs, t_step.m_end - m_num_inputs);
+            continue;
+        }
+
+        unsigned int t_iterations = t_step.m_cyclic ? a_recurrent_iterations : 1;
+        bool t_parallel = UseThreads(t_step.m_begin, t_step.m_end);
+        for (unsigned int k = 0; k < t_iterations; k++)
+        {
+            if (t_parallel)
+            {
+                ActivateParallel(a_state, t_step.m_begin, t_step.m_end, NO_SUM_UPDATE, 0);
+                continue;
+            }
+            Accumulate(a_state, t_step.m_begin, t_step.m_end);
+            ApplyActivationFunctions(a_state, t_step.m_run_begin, t_step.m_run_end);
+        }
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateDelta(BasicCompiledNetworkState<T>& a_state, double a_epsilon) const
+{
+    if (NumNeurons() <= m_num_inputs)
+        return;
+
+    T* t_activesum = &a_state.m_activesum[0];
+    T* t_activation = &a_state.m_activation[0];
+    if (!a_state.m_sent_valid || (a_state.m_sent_generation != m_generation))
+    {
+        // A full step, which sends all the activations
+        a_state.m_sent.assign(a_state.m_activation.begin(), a_state.m_activation.end());
+        a_state.m_is_changed.assign(NumNeurons(), 0);
+        a_state.m_changed.clear();
+        Accumulate(a_state, m_num_inputs, NumNeurons());
+        ApplyActivationFunctions(a_state, 0, static_cast<unsigned int>(m_runs.size()));
+        a_state.m_sent_valid = true;
+        a_state.m_sent_generation = m_generation;
+        return;
+    }
+
+    // Send the changes of the old activations to the sums of their targets
+    T* t_sent = &a_state.m_sent[0];
+    const T t_epsilon = static_cast<T>(a_epsilon);
+    for (unsigned int i = 0; i < NumNeurons(); i++)
+    {
+        T t_delta = t_activation[i] - t_sent[i];
+        if (!(std::fabs(t_delta) > t_epsilon))
+            continue;
+
+        t_sent[i] = t_activation[i];
+        for (unsigned int j = m_out_row_start[i]; j < m_out_row_start[i + 1]; j++)
+        {
+            unsigned int t_target = m_out_target[j];
+            t_activesum[t_target] += m_weight[m_out_connection[j]] * t_delta;
+            if (!a_state.m_is_changed[t_target])
+            {
+                a_state.m_is_changed[t_target] = 1;
+                a_state.m_changed.push_back(t_target);
+            }
+        }
+    }
+
+    // and compute the new activations of these targets only
+    for (unsigned int k = 0; k < a_state.m_changed.size(); k++)
+    {
+        unsigned int t_slot = a_state.m_changed[k];
+        ActivateSpan(m_activation_function_type[t_slot],
+                     &t_activesum[t_slot], &m_a[t_slot], &m_b[t_slot],
+                     &t_activation[t_slot], 1, m_accuracy);
+        a_state.m_is_changed[t_slot] = 0;
+    }
+    a_state.m_changed.clear();
+}
+
+// a_y[i] += a_w * a_x[i] for i in [0, a_n)
+static inline void AddScaled(double a_w, const double* a_x, double* a_y, unsigned int a_n)
+{
+    unsigned int i = 0;
+#ifdef NEAT_SIMD
+    typedef DoubleBatch B;
+    B::type t_w = B::set1(a_w);
+    for (; i + B::size <= a_n; i += B::size)
+    {
+        B::store(a_y + i, B::add(B::load(a_y + i), B::mul(B::load(a_x + i), t_w)));
+    }
+#endif
+    for (; i < a_n; i++)
+    {
+        a_y[i] += a_x[i] * a_w;
+    }
+}
+
+static inline void AddScaled(float a_w, const float* a_x, float* a_y, unsigned int a_n)
+{
+    unsigned int i = 0;
+#ifdef NEAT_SIMD
+    typedef FloatBatch B;
+    B::type t_w = B::set1(a_w);
+    for (; i + B::size <= a_n; i += B::size)
+    {
+        B::store(a_y + i, B::add(B::load(a_y + i), B::mul(B::load(a_x + i), t_w)));
+    }
+#endif
+    for (; i < a_n; i++)
+    {
+        a_y[i] += a_x[i] * a_w;
+    }
+}
+
+// The number of samples ActivateBatch() processes at once
+const unsigned int BATCH_BLOCK_SIZE = 64;
+
+template <class T>
+void BasicCompiledNetwork<T>::ActivateBatch(const double* a_inputs, double* a_outputs,
+                                    unsigned int a_num_samples, unsigned int a_steps)
+{
+    const unsigned int t_num_neurons = NumNeurons();
+
+    for (unsigned int t_first = 0; t_first < a_num_samples; t_first += BATCH_BLOCK_SIZE)
+    {
+        const unsigned int t_width = std::min(BATCH_BLOCK_SIZE, a_num_samples - t_first);
+        const unsigned int t_size = t_num_neurons * t_width;
+
+        // The activation function parameters, repeated for every sample
+        if (m_batch_a.size() != t_size)
+        {
+            m_batch_a.resize(t_size);
+            m_batch_b.resize(t_size);
+            for (unsigned int i = 0; i < t_num_neurons; i++)
+            {
+                std::fill(m_batch_a.begin() + i * t_width, m_batch_a.begin() + (i + 1) * t_width, m_a[i]);
+                std::fill(m_batch_b.begin() + i * t_width, m_batch_b.begin() + (i + 1) * t_width, m_b[i]);
+            }
+        }
+
+        // Flush and input
+        m_batch_activesum.assign(t_size, static_cast<T>(0));
+        m_batch_activation.assign(t_size, static_cast<T>(0));
+        for (unsigned int s = 0; s < t_width; s++)
+        {
+            for (unsigned int i = 0; i < m_num_inputs; i++)
+            {
+                m_batch_activation[i * t_width + s] = static_cast<T>(a_inputs[(t_first + s) * m_num_inputs + i]);
+            }
+        }
+
+        T* t_activesum = t_size ? &m_batch_activesum[0] : NULL;
+        T* t_activation = t_size ? &m_batch_activation[0] : NULL;
+        for (unsigned int t_step = 0; t_step < a_steps; t_step++)
+        {
+            for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+            {
+                T* t_sum = t_activesum + i * t_width;
+                std::fill(t_sum, t_sum + t_width, static_cast<T>(0));
+                for (unsigned int j = m_row_start[i]; j < m_row_start[i + 1]; j++)
+                {
+                    AddScaled(m_weight[j], t_activation + Source(j) * t_width, t_sum, t_width);
+                }
+            }
+
+            for (unsigned int r = 0; r < m_runs.size(); r++)
+            {
+                const ActivationRun& t_run = m_runs[r];
+                unsigned int t_offset = t_run.m_begin * t_width;
+                ActivateSpan(t_run.m_type,
+                             t_activesum + t_offset, &m_batch_a[t_offset], &m_batch_b[t_offset],
+                             t_activation + t_offset, (t_run.m_end - t_run.m_begin) * t_width, m_accuracy);
+            }
+        }
+
+        for (unsigned int s = 0; s < t_width; s++)
+        {
+            for (unsigned int k = 0; k < m_num_outputs; k++)
+            {
+                a_outputs[(t_first + s) * m_num_outputs + k] = m_batch_activation[m_slot[m_num_inputs + k] * t_width + s];
+            }
+        }
+    }
+}
+
+template <class T>
+bool BasicCompiledNetwork<T>::IsAcyclic() const
+{
+    for (unsigned int s = 0; s < m_schedule.size(); s++)
+    {
+        if (m_schedule[s].m_cyclic)
+            return false;
+    }
+    return true;
+}
+
+template <class T>
+unsigned int BasicCompiledNetwork<T>::SettlingDepth() const
+{
+    // every level of an acyclic network is one schedule step
+    return IsAcyclic() ? static_cast<unsigned int>(m_schedule.size()) : UINT_MAX;
+}
+
+template <class T>
+ActivationBackend BasicCompiledNetwork<T>::Backend() const
+{
+    if (m_small)
+        return FIXED_BACKEND;
+    if (!m_program.empty())
+        return PROGRAM_BACKEND;
+    if ((NumNeurons() > m_num_inputs) && UseThreads(m_num_inputs, NumNeurons()))
+        return PARALLEL_CSR_BACKEND;
+    return CSR_BACKEND;
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Flush(BasicCompiledNetworkState<T>& a_state) const
+{
+    a_state.m_sent_valid = false;
+    std::fill(a_state.m_activation.begin(), a_state.m_activation.end(), static_cast<T>(0));
+    std::fill(a_state.m_activesum.begin(), a_state.m_activesum.end(), static_cast<T>(0));
+    std::fill(a_state.m_membrane_potential.begin(), a_state.m_membrane_potential.end(), static_cast<T>(0));
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::Input(BasicCompiledNetworkState<T>& a_state, const double* a_Inputs) const
+{
+    for (unsigned int i = 0; i < m_num_inputs; i++)
+    {
+        a_state.m_activation[i] = static_cast<T>(a_Inputs[i]);
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::NewState(BasicCompiledNetworkState<T>& a_state) const
+{
+    a_state.m_activation.assign(NumNeurons(), static_cast<T>(0));
+    a_state.m_activesum.assign(NumNeurons(), static_cast<T>(0));
+    a_state.m_membrane_potential.assign(NumNeurons(), static_cast<T>(0));
+    a_state.m_next_activation.clear();
+    a_state.m_sent_valid = false;
+}
+
+//////////////////////////////////////////////////////////////////
+// Training
+//////////////////////////////////////////////////////////////////
+
+template <class T>
+void BasicCompiledNetwork<T>::TrainingStep(const double* a_weight, const double* a_in, double* a_out, double* a_derivative)
+{
+    for (unsigned int i = m_num_inputs; i < NumNeurons(); i++)
+    {
+        double t_sum = 0;
+        for (unsigned int j = m_row_start[i]; j < m_row_start[i + 1]; j++)
+        {
+            t_sum += a_in[Source(j)] * a_weight[j];
+        }
+
+        double t_y = af_apply(m_activation_function_type[i], t_sum, m_a[i], m_b[i], m_accuracy);
+        a_derivative[i] = af_derivative(m_activation_function_type[i], t_sum, t_y, m_a[i], m_b[i]);
+        a_out[i] = t_y;
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::TrainingBackStep(const double* a_weight, const double* a_in, const double* a_derivative,
+                                               const double* a_out_error, double* a_in_error, double* a_gradient)
+{
+    for (unsigned int i = NumNeurons(); i-- > m_num_inputs; )
+    {
+        double t_delta = a_out_error[i] * a_derivative[i];
+        if (t_delta == 0)
+            continue;
+
+        for (unsigned int j = m_row_start[i]; j < m_row_start[i + 1]; j++)
+        {
+            a_gradient[j] += t_delta * a_in[Source(j)];
+            a_in_error[Source(j)] += t_delta * a_weight[j];
+        }
+    }
+}
+
+template <class T>
+void BasicCompiledNetwork<T>::UpdateWeights(double* a_weight, const double* a_gradient, double a_rate,
+                                            std::vector<Connection>& a_connections)
+{
+    for (unsigned int j = 0; j < NumConnections(); j++)
+    {
+        a_weight[j] -= a_rate * a_gradient[j];
+        a_connections[m_connection[j]].m_weight = a_weight[j];
+        m_weight[j] = static_cast<T>(a_weight[j]);
+    }
+
+    // The program has its own copies of some weights
+    BuildProgram();
+    m_generation++;
+}
+
+template <class T>
+double BasicCompiledNetwork<T>::Backprop(const double* a_inputs, const double* a_targets, unsigned int a_num_samples,
+                                         double a_learning_rate, std::vector<Connection>& a_connections)
+{
+    const unsigned int t_num_neurons = NumNeurons();
+    if ((a_num_samples == 0) || (t_num_neurons == 0))
+        return 0;
+
+    std::vector<double> t_weight(NumConnections() + 1), t_gradient(NumConnections() + 1, 0.0);
+    for (unsigned int j = 0; j < NumConnections(); j++)
+    {
+        t_weight[j] = a_connections[m_connection[j]].m_weight;
+    }
+
+    std::vector<double> t_activation(t_num_neurons), t_derivative(t_num_neurons), t_error(t_num_neurons);
+    double t_total_error = 0;
+    for (unsigned int s = 0; s < a_num_samples; s++)
+    {
+        // Forward, every neuron after its sources
+        std::fill(t_activation.begin(), t_activation.end(), 0.0);
+        std::copy(a_inputs + s * m_num_inputs, a_inputs + (s + 1) * m_num_inputs, t_activation.begin());
+        TrainingStep(&t_weight[0], &t_activation[0], &t_activation[0], &t_derivative[0]);
+
+        // Backward, every neuron before its sources
+        std::fill(t_error.begin(), t_error.end(), 0.0);
+        for (unsigned int k = 0; k < m_num_outputs; k++)
+        {
+            unsigned int t_slot = m_slot[m_num_inputs + k];
+            double t_diff = t_activation[t_slot] - a_targets[s * m_num_outputs + k];
+            t_error[t_slot] += t_diff;
+            t_total_error += t_diff * t_diff;
+        }
+        TrainingBackStep(&t_weight[0], &t_activation[0], &t_derivative[0],
+                         &t_error[0], &t_error[0], &t_gradient[0]);
+    }
+
+    UpdateWeights(&t_weight[0], &t_gradient[0], a_learning_rate / a_num_samples, a_connections);
+
+    return m_num_outputs ? (t_total_error / (static_cast<double>(a_num_samples) * m_num_outputs)) : 0;
+}
+
+template <class T>
+double BasicCompiledNetwork<T>::BPTT(const double* a_inputs, const double* a_targets, unsigned int a_num_samples,
+                                     double a_learning_rate, unsigned int a_truncation,
+                                     std::vector<Connection>& a_connections)
+{
+    const unsigned int t_num_neurons = NumNeurons();
+    if ((a_num_samples == 0) || (t_num_neurons == 0))
+        return 0;
+    if (a_truncation == 0)
+    {
+        a_truncation = 1;
+    }
+
+    std::vector<double> t_weight(NumConnections() + 1), t_gradient(NumConnections() + 1);
+    for (unsigned int j = 0; j < NumConnections(); j++)
+    {
+        t_weight[j] = a_connections[m_connection[j]].m_weight;
+    }
+
+    // The activations before every step of the window and after the last one,
+    // and the derivatives of every step
+    const unsigned int t_window = std::min(a_truncation, a_num_samples);
+    std::vector<double> t_state((t_window + 1) * t_num_neurons), t_derivative(t_window * t_num_neurons);
+    std::vector<double> t_error(t_num_neurons), t_prev_error(t_num_neurons);
+    std::copy(m_state.m_activation.begin(), m_state.m_activation.end(), t_state.begin());
+
+    double t_total_error = 0;
+    for (unsigned int t_first = 0; t_first < a_num_samples; t_first += t_window)
+    {
+        const unsigned int t_steps = std::min(t_window, a_num_samples - t_first);
+
+        // Forward
+        for (unsigned int k = 0; k < t_steps; k++)
+        {
+            double* t_in = &t_state[k * t_num_neurons];
+            double* t_out = t_in + t_num_neurons;
+            std::copy(a_inputs + (t_first + k) * m_num_inputs, a_inputs + (t_first + k + 1) * m_num_inputs, t_in);
+            std::copy(t_in, t_in + m_num_inputs, t_out);
+            TrainingStep(&t_weight[0], t_in, t_out, &t_derivative[k * t_num_neurons]);
+        }
+
+        // Backward through the steps of the window
+        std::fill(t_gradient.begin(), t_gradient.end(), 0.0);
+        std::fill(t_error.begin(), t_error.end(), 0.0);
+        for (unsigned int k = t_steps; k-- > 0; )
+        {
+            const double* t_out = &t_state[(k + 1) * t_num_neurons];
+            for (unsigned int o = 0; o < m_num_outputs; o++)
+            {
+                unsigned int t_slot = m_slot[m_num_inputs + o];
+                double t_diff = t_out[t_slot] - a_targets[(t_first + k) * m_num_outputs + o];
+                t_error[t_slot] += t_diff;
+                t_total_error += t_diff * t_diff;
+            }
+
+            std::fill(t_prev_error.begin(), t_prev_error.end(), 0.0);
+            TrainingBackStep(&t_weight[0], &t_state[k * t_num_neurons], &t_derivative[k * t_num_neurons],
+                             &t_error[0], &t_prev_error[0], &t_gradient[0]);
+            t_error.swap(t_prev_error);
+        }
+
+        UpdateWeights(&t_weight[0], &t_gradient[0], a_learning_rate / t_steps, a_connections);
+
+        // The next window starts where this one ended
+        std::copy(t_state.begin() + t_steps * t_num_neurons, t_state.begin() + (t_steps + 1) * t_num_neurons,
+                  t_state.begin());
+    }
+
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        m_state.m_activation[i] = static_cast<T>(t_state[i]);
+    }
+    m_state.m_sent_valid = false;
+
+    return m_num_outputs ? (t_total_error / (static_cast<double>(a_num_samples) * m_num_outputs)) : 0;
+}
+
+// The two precisions the library is built with
+template class BasicCompiledNetwork<double>;
+template class BasicCompiledNetwork<float>;
+
+//////////////////////////////////////////////////////////////////
+// Backend selection
+//////////////////////////////////////////////////////////////////
+
+const char* ActivationBackendName(ActivationBackend a_backend)
+{
+    switch (a_backend)
+    {
+    case INTERPRETED_BACKEND:  return "interpreted";
+    case CSR_BACKEND:          return "csr";
+    case PARALLEL_CSR_BACKEND: return "parallel_csr";
+    case PROGRAM_BACKEND:      return "program";
+    case FIXED_BACKEND:        return "fixed";
+    default:                   return "unknown";
+    }
+}
+
+// Networks with more neurons than this are not compiled into a program,
+// as the vectorized activation functions of the runs are faster for them
+const unsigned int DEFAULT_PROGRAM_MAX_NEURONS = 256;
+
+// Ranges of slots with fewer connections than this are activated serially,
+// waking the threads would cost more than it saves
+const unsigned int DEFAULT_PARALLEL_MIN_CONNECTIONS = 16384;
+
+// Never, for the sizes
+const unsigned int NEVER = 0xFFFFFFFFu;
+
+BackendProfile::BackendProfile()
+{
+    m_program_max_neurons = DEFAULT_PROGRAM_MAX_NEURONS;
+    m_parallel_min_connections = DEFAULT_PARALLEL_MIN_CONNECTIONS;
+}
+
+BackendProfile& BackendProfile::Active()
+{
+    static BackendProfile s_profile;
+    return s_profile;
+}
+
+// A random network of a_num_neurons neurons (8 of them inputs) with
+// a_fan_in connections into every other one, compiled with a_profile
+static void BuildCalibrationNetwork(unsigned int a_num_neurons, unsigned int a_fan_in,
+                                    const BackendProfile& a_profile, CompiledNetwork& a_net)
+{
+    const unsigned int t_num_inputs = 8;
+    std::vector<Neuron> t_neurons(a_num_neurons);
+    for (unsigned int i = 0; i < a_num_neurons; i++)
+    {
+        Neuron& t_n = t_neurons[i];
+        t_n.m_a = 1;
+        t_n.m_b = 0;
+        t_n.m_timeconst = 1;
+        t_n.m_bias = 0;
+        t_n.m_activation = 0;
+        t_n.m_membrane_potential = 0;
+        t_n.m_activation_function_type = (i % 2) ? TANH : UNSIGNED_SIGMOID;
+    }
+
+    // a fixed linear congruential sequence, so every calibration times the same networks
+    unsigned int t_seed = 12345;
+    std::vector<Connection> t_connections;
+    for (unsigned int i = t_num_inputs; i < a_num_neurons; i++)
+    {
+        for (unsigned int k = 0; k < a_fan_in; k++)
+        {
+            t_seed = t_seed * 1103515245u + 12345u;
+            Connection t_c;
+            t_c.m_source_neuron_idx = (t_seed >> 8) % a_num_neurons;
+            t_c.m_target_neuron_idx = i;
+            t_c.m_weight = static_cast<double>((t_seed >> 4) % 2001) / 1000.0 - 1.0;
+            t_connections.push_back(t_c);
+        }
+    }
+
+    a_net.Build(t_neurons, t_connections, t_num_inputs, 1, EXACT_ACTIVATION, a_profile);
+}
+
+// Seconds per Activate() of a_net, with a_num_threads threads
+static double TimeActivate(CompiledNetwork& a_net, unsigned int a_num_threads)
+{
+    a_net.m_num_threads = a_num_threads;
+    std::vector<double> t_inputs(a_net.m_num_inputs, 0.5);
+    a_net.Flush();
+    a_net.Input(&t_inputs[0]);
+
+    // enough steps for about 2M connections, at least 20, after as many untimed
+    unsigned int t_steps = std::max(20u, 2000000u / std::max(1u, a_net.NumConnections()));
+    for (unsigned int s = 0; s < t_steps; s++)
+    {
+        a_net.Activate();
+    }
+
+    std::chrono::steady_clock::time_point t_start = std::chrono::steady_clock::now();
+    for (unsigned int s = 0; s < t_steps; s++)
+    {
+        a_net.Activate();
+    }
+    std::chrono::duration<double> t_time = std::chrono::steady_clock::now() - t_start;
+    return t_time.count() / t_steps;
+}
+
+void BackendProfile::Calibrate()
+{
+    const unsigned int t_fan_in = 4;
+
+    // The largest network the program is faster for, of the sizes tried
+    BackendProfile t_program, t_csr;
+    t_program.m_program_max_neurons = NEVER;
+    t_program.m_parallel_min_connections = t_csr.m_parallel_min_connections = NEVER;
+    t_csr.m_program_max_neurons = 0;
+    unsigned int t_program_max_neurons = 0;
+    for (unsigned int n = 64; n <= 1024; n *= 2)
+    {
+        CompiledNetwork t_net;
+        BuildCalibrationNetwork(n, t_fan_in, t_program, t_net);
+        double t_program_time = TimeActivate(t_net, 1);
+        BuildCalibrationNetwork(n, t_fan_in, t_csr, t_net);
+        double t_csr_time = TimeActivate(t_net, 1);
+        if (t_program_time < t_csr_time)
+            t_program_max_neurons = t_net.NumNeurons() - t_net.m_num_inputs;
+        else
+            break;
+    }
+
+    // The smallest network the threads are faster for by a tenth, of the sizes tried
+    unsigned int t_parallel_min_connections = NEVER;
+    unsigned int t_num_threads = ThreadPool::Shared().NumWorkers() + 1;
+    if (t_num_threads > 1)
+    {
+        BackendProfile t_parallel;
+        t_parallel.m_program_max_neurons = 0;
+        t_parallel.m_parallel_min_connections = 0;
+        for (unsigned int c = 4096; c <= 262144; c *= 2)
+        {
+            CompiledNetwork t_net;
+            BuildCalibrationNetwork(c / t_fan_in + 8, t_fan_in, t_parallel, t_net);
+            double t_serial_time = TimeActivate(t_net, 1);
+            double t_parallel_time = TimeActivate(t_net, t_num_threads);
+            if (t_parallel_time < 0.9 * t_serial_time)
+            {
+                t_parallel_min_connections = t_net.NumConnections();
+                break;
+            }
+        }
+    }
+
+    m_program_max_neurons = t_program_max_neurons;
+    m_parallel_min_connections = t_parallel_min_connections;
+}
+
+bool BackendProfile::Save(const char* a_filename) const
+{
+    FILE* t_file = fopen(a_filename, "w");
+    if (!t_file)
+        return false;
+
+    fprintf(t_file, "NEAT_BackendProfileStart\n");
+    fprintf(t_file, "ProgramMaxNeurons %u\n", m_program_max_neurons);
+    fprintf(t_file, "ParallelMinConnections %u\n", m_parallel_min_connections);
+    fprintf(t_file, "NEAT_BackendProfileEnd\n");
+    return fclose(t_file) == 0;
+}
+
+bool BackendProfile::Load(const char* a_filename)
+{
+    std::ifstream t_file(a_filename);
+    std::string s;
+    if (!(t_file >> s) || (s != "NEAT_BackendProfileStart"))
+        return false;
+
+    BackendProfile t_profile = *this;
+    while ((t_file >> s) && (s != "NEAT_BackendProfileEnd"))
+    {
+        if (s == "ProgramMaxNeurons")
+            t_file >> t_profile.m_program_max_neurons;
+        else if (s == "ParallelMinConnections")
+            t_file >> t_profile.m_parallel_min_connections;
+        if (!t_file)
+            return false;
+    }
+    if (s != "NEAT_BackendProfileEnd")
+        return false;
+
+    *this = t_profile;
+    return true;
+}
+
+} // namespace NEAT
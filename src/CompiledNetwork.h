@@ -0,0 +1,537 @@
+#ifndef _COMPILED_NETWORK_H
+#define _COMPILED_NETWORK_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        CompiledNetwork.h
+// Description: A compiled, read-optimized form of the neural network.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "Genes.h"
+#include "ActivationFunctions.h"
+
+namespace NEAT
+{
+
+class Neuron;
+class Connection;
+
+//////////////////////////////////////////////////////////////////
+// The compiled network.
+//
+// The incoming connections of every neuron are stored contiguously
+// (compressed sparse rows), with source indices, weights and the
+// per-neuron parameters and state in separate flat arrays. One
+// activation step is then a single gather-and-accumulate pass over
+// the connections, with no scattered writes.
+//
+// Within a neuron's row the connections keep their original order,
+// so in double precision the sums are the same as the ones computed
+// by NeuralNetwork's own activation loops, and so are the outputs
+// in EXACT_ACTIVATION mode.
+//
+// The neurons are stored in slots that are grouped by activation
+// function type, so each activation step applies every function once
+// over a contiguous run of slots (see ActivationKernels.h).
+// The inputs always occupy the first slots, in their original order.
+//
+// The slots are also sorted in topological order. The strongly
+// connected components of the network are found, and each neuron
+// gets the level of its component (the longest path to it from the
+// inputs in the graph of components). The slots are ordered by level,
+// then by whether the neuron is in a cycle, then by activation
+// function, so every level is a contiguous range of slots that depends
+// only on the levels before it and on itself (the cyclic part).
+//
+// T is the type of the weights, parameters and state - double, or
+// float for half the memory traffic. The interface is in double.
+//
+// Small networks are also compiled into a program - a flat stream of
+// instructions, one per neuron, in slot order. An instruction's opcode
+// combines how the neuron's inputs are gathered with its activation
+// function, and neurons with one or two inputs carry their sources and
+// weights in the instruction itself, so a single switch does all the
+// work of a neuron.
+//
+// The smallest networks, such as most CPPNs, also get a copy of the
+// weights and parameters in a SmallCompiledNetwork, of fixed capacity
+// and with small indices, that is activated instead of the program.
+// Only compiled networks have one: the substrate builders compile their
+// CPPNs, but Genome::BuildPhenotype(net) alone leaves the network
+// uncompiled.
+//
+// Large networks can be activated by several threads at once (see
+// m_num_threads). The slots to activate are split into chunks of about
+// the same number of connections, which the threads of a ThreadPool
+// accumulate and then activate, the second only once all of the first
+// is done. Every slot is computed as it is serially, so the outputs
+// don't depend on the number of threads.
+//
+// The network itself (the arrays above) doesn't change once built,
+// and the state of the neurons is kept apart from it, in a
+// BasicCompiledNetworkState. The network has a state of its own, but
+// the const methods that take a state never change the network, so one
+// network can drive any number of states, from any number of threads.
+//////////////////////////////////////////////////////////////////
+
+// The numeric type of a compiled network. In single precision the
+// connections are accumulated in float batches, twice as wide as the
+// double ones, but the activation functions are still computed in double
+// and rounded (see ActivationKernels.h).
+enum Precision
+{
+    DOUBLE_PRECISION = 0,
+    SINGLE_PRECISION
+};
+
+// The engine a network is activated with
+enum ActivationBackend
+{
+    INTERPRETED_BACKEND = 0, // not compiled, the neurons and connections themselves
+    CSR_BACKEND,             // the compressed rows and the activation runs
+    PARALLEL_CSR_BACKEND,    // the same, split between threads
+    PROGRAM_BACKEND,         // the program
+    FIXED_BACKEND            // the fixed capacity form
+};
+
+// The name of a_backend, for logs
+const char* ActivationBackendName(ActivationBackend a_backend);
+
+// The sizes at which the compiled network switches engines. The
+// defaults suit most hosts, Calibrate() measures them on this one.
+// The networks copy the active profile (or the one given to Build())
+// when they are compiled, so it is best set up before that.
+class BackendProfile
+{
+public:
+    // Networks of at most this many non-input neurons also get a program
+    unsigned int m_program_max_neurons;
+
+    // Ranges of slots with at least this many connections are activated
+    // in parallel by networks allowed more than one thread
+    unsigned int m_parallel_min_connections;
+
+    BackendProfile();
+
+    // The profile the networks use unless given another one
+    static BackendProfile& Active();
+
+    // Times the engines on random networks of several sizes and sets the
+    // fields to the sizes where they break even on this host. Takes about
+    // a second. The networks it times are built with profiles of their
+    // own, the active profile isn't touched unless this is it.
+    void Calibrate();
+
+    // Saves/loads the profile as a small text file. Both return false on
+    // any error, Load() leaving the profile as it was.
+    bool Save(const char* a_filename) const;
+    bool Load(const char* a_filename);
+};
+
+// A contiguous run of slots with the same activation function
+struct ActivationRun
+{
+    ActivationFunction m_type;
+    unsigned int m_begin, m_end;
+};
+
+// A contiguous range of slots that can be activated together
+// once everything before it is up to date
+struct ScheduleStep
+{
+    unsigned int m_begin, m_end;
+
+    // The activation runs covering [m_begin .. m_end)
+    unsigned int m_run_begin, m_run_end;
+
+    // True if the neurons are in cycles and need to be iterated
+    bool m_cyclic;
+};
+
+// The state of the neurons of a compiled network, by slot.
+// A copy is an independent state, it shares nothing.
+template <class T>
+class BasicCompiledNetworkState
+{
+public:
+    // Before the activation functions are applied, m_activesum holds their
+    // argument. It is working memory of the compressed rows only: the
+    // program and the fixed capacity form keep their sums to themselves,
+    // so after a step of theirs it holds nothing in particular.
+    std::vector<T> m_activesum;
+    std::vector<T> m_activation;
+    std::vector<T> m_membrane_potential;
+
+    // The activations being written by the program in Activate()
+    std::vector<T> m_next_activation;
+
+    // The event-driven activation (ActivateDelta()). If m_sent_valid,
+    // m_activesum holds the sums of the activations in m_sent, the ones
+    // last propagated, with the weights of the network's m_generation
+    // m_sent_generation. Any other activation method or Flush() clears it.
+    std::vector<T> m_sent;
+    bool m_sent_valid;
+    unsigned int m_sent_generation;
+
+    // The slots whose sums changed in the current ActivateDelta() step
+    std::vector<unsigned int> m_changed;
+    std::vector<unsigned char> m_is_changed;
+
+    BasicCompiledNetworkState()
+    {
+        m_sent_valid = false;
+        m_sent_generation = 0;
+    }
+};
+
+// The fixed capacity form of a small compiled network (see CompiledNetwork.cpp).
+// It has the slots of the network it was made from and activates a state of it.
+template <class T>
+class SmallCompiledNetwork
+{
+public:
+    virtual ~SmallCompiledNetwork()
+    {
+    }
+
+    // One step of Activate() of the activations a_activation
+    virtual void Activate(T* a_activation) const = 0;
+
+    // ActivateTopological(), for acyclic networks only
+    virtual void ActivateTopological(T* a_activation) const = 0;
+};
+
+template <class T>
+class BasicCompiledNetwork
+{
+public:
+
+    unsigned int m_num_inputs, m_num_outputs;
+
+    // The slot of every neuron (indexed by the neuron's original index).
+    // All the arrays below are indexed by slot.
+    std::vector<unsigned int> m_slot;
+
+    // The activation function runs, covering all non-input slots
+    std::vector<ActivationRun> m_runs;
+
+    // The topological schedule, covering all non-input slots
+    std::vector<ScheduleStep> m_schedule;
+
+    // The incoming connections of slot i are
+    // [m_row_start[i] .. m_row_start[i+1]) in the sources and m_weight
+    std::vector<unsigned int> m_row_start;
+    std::vector<T> m_weight;
+
+    // The source slots of the connections. Networks of up to 65536 neurons
+    // keep them in 16 bits (m_source16), larger ones in 32 bits (m_source32).
+    std::vector<unsigned short> m_source16;
+    std::vector<unsigned int> m_source32;
+    bool m_wide_indices;
+
+    // The index of every connection in the list the network was built from
+    std::vector<unsigned int> m_connection;
+
+    // The outgoing connections of slot i are [m_out_row_start[i] .. m_out_row_start[i+1])
+    // in m_out_target (their target slots) and m_out_connection (their
+    // indices in m_weight). Used by ActivateDelta().
+    std::vector<unsigned int> m_out_row_start;
+    std::vector<unsigned int> m_out_target;
+    std::vector<unsigned int> m_out_connection;
+
+    // One instruction of the program
+    struct Instruction
+    {
+        unsigned int m_op;        // the input kind and the function computed
+        unsigned int m_target;    // the slot of the neuron
+        unsigned int m_source[2]; // the sources of one and two input neurons
+        T m_weight[2];
+        T m_a, m_b;               // the activation function parameters
+    };
+
+    // The program, empty for networks too large for it to pay off
+    std::vector<Instruction> m_program;
+
+    // The fixed capacity form, NULL for networks too large for one. It
+    // doesn't change once made, so copies of the network share it.
+    boost::shared_ptr<const SmallCompiledNetwork<T> > m_small;
+
+    // The profile the network was built with
+    BackendProfile m_profile;
+
+    // Neuron parameters
+    std::vector<T> m_a, m_b, m_timeconst, m_bias;
+    std::vector<ActivationFunction> m_activation_function_type;
+
+    // The network's own state
+    BasicCompiledNetworkState<T> m_state;
+
+    // Changes whenever the weights or the neuron parameters do, so the
+    // sums ActivateDelta() kept in any state of the network can be
+    // recognized as stale
+    unsigned int m_generation;
+
+    // How accurately the activation functions are computed
+    ActivationAccuracy m_accuracy;
+
+    // The most threads Activate(), ActivateUseInternalBias(), ActivateLeaky()
+    // and ActivateTopological() use. They use them only for the ranges of
+    // slots with enough connections to pay off, 1 (the default) is serial.
+    // Build() keeps it.
+    unsigned int m_num_threads;
+
+    BasicCompiledNetwork();
+
+    // Compiles the given neurons and connections.
+    // The state of the neurons (activations, membrane potentials) is carried over.
+    void Build(const std::vector<Neuron>& a_neurons,
+               const std::vector<Connection>& a_connections,
+               unsigned int a_num_inputs, unsigned int a_num_outputs,
+               ActivationAccuracy a_accuracy = EXACT_ACTIVATION,
+               const BackendProfile& a_profile = BackendProfile::Active());
+
+    void Clear();
+
+    // Copies the weights and the neuron parameters (A, B, time constant and
+    // bias) again from the neurons and connections the network was built
+    // from. Their numbers, the connections' ends and the activation functions
+    // must not have changed. Much cheaper than Build(), the state is kept.
+    void UpdateParameters(const std::vector<Neuron>& a_neurons,
+                          const std::vector<Connection>& a_connections);
+
+    unsigned int NumNeurons() const
+    {
+        return static_cast<unsigned int>(m_a.size());
+    }
+    unsigned int NumConnections() const
+    {
+        return static_cast<unsigned int>(m_weight.size());
+    }
+
+    // The source slot of connection a_idx
+    unsigned int Source(unsigned int a_idx) const
+    {
+        return m_wide_indices ? m_source32[a_idx] : m_source16[a_idx];
+    }
+
+    // Same semantics as the NeuralNetwork methods of the same name
+    void ActivateFast()
+    {
+        ActivateFast(m_state);
+    }
+    void Activate()
+    {
+        Activate(m_state);
+    }
+    void ActivateUseInternalBias()
+    {
+        ActivateUseInternalBias(m_state);
+    }
+    void ActivateLeaky(double a_dtime)
+    {
+        ActivateLeaky(m_state, a_dtime);
+    }
+
+    // Activates the network in a single pass in topological order.
+    // Every acyclic neuron is activated once, after all of its sources,
+    // and the neurons in cycles are activated a_recurrent_iterations
+    // times (synchronously among themselves).
+    void ActivateTopological(unsigned int a_recurrent_iterations)
+    {
+        ActivateTopological(m_state, a_recurrent_iterations);
+    }
+
+    // Event-driven Activate(). Only the neurons whose activation changed by
+    // more than a_epsilon since it was last propagated pass the change on
+    // through their outgoing connections, and only the neurons whose sums
+    // changed apply their activation functions. The first step after
+    // Flush() or any other activation method is a full Activate().
+    void ActivateDelta(double a_epsilon)
+    {
+        ActivateDelta(m_state, a_epsilon);
+    }
+
+    // The same on a state other than the network's own, made with
+    // NewState() or copied from another state of this network
+    void ActivateFast(BasicCompiledNetworkState<T>& a_state) const;
+    void Activate(BasicCompiledNetworkState<T>& a_state) const;
+    void ActivateUseInternalBias(BasicCompiledNetworkState<T>& a_state) const;
+    void ActivateLeaky(BasicCompiledNetworkState<T>& a_state, double a_dtime) const;
+    void ActivateTopological(BasicCompiledNetworkState<T>& a_state, unsigned int a_recurrent_iterations) const;
+    void ActivateDelta(BasicCompiledNetworkState<T>& a_state, double a_epsilon) const;
+    void Flush(BasicCompiledNetworkState<T>& a_state) const;
+    void Input(BasicCompiledNetworkState<T>& a_state, const double* a_Inputs) const;
+
+    // Sizes a_state for this network and flushes it
+    void NewState(BasicCompiledNetworkState<T>& a_state) const;
+
+    // True if a_state has the size of this network's states
+    bool IsStateOf(const BasicCompiledNetworkState<T>& a_state) const
+    {
+        return a_state.m_activation.size() == NumNeurons();
+    }
+
+    // True if no neuron is part of a cycle
+    bool IsAcyclic() const;
+
+    // The number of Activate() steps after which the outputs settle, from
+    // any state, to those of ActivateTopological() - the number of levels.
+    // UINT_MAX if the network has cycles.
+    unsigned int SettlingDepth() const;
+
+    // The engine Activate() uses
+    ActivationBackend Backend() const;
+
+    // Runs a_num_samples independent samples through the network, each one
+    // like Flush(), Input(), a_steps times Activate() and Output().
+    // a_inputs is [a_num_samples][m_num_inputs], a_outputs is
+    // [a_num_samples][m_num_outputs], both row-major.
+    // The state of the network is not used or changed.
+    void ActivateBatch(const double* a_inputs, double* a_outputs,
+                       unsigned int a_num_samples, unsigned int a_steps);
+
+    // Gradient descent on the squared error of the outputs. The weights are
+    // trained in double precision in a_connections (the connections the
+    // network was built from) and copied into m_weight.
+    // a_inputs is [a_num_samples][m_num_inputs], a_targets is
+    // [a_num_samples][m_num_outputs], both row-major. Both return the mean
+    // squared error of the outputs over all samples. For Backprop() that is
+    // the error before the weights changed, for BPTT() the error of the
+    // sequence as it was run, with the updates between its windows.
+
+    // Backpropagation for acyclic networks. Every sample is run like
+    // Flush(), Input() and ActivateTopological(), then the weights change
+    // once, by the gradient averaged over all samples.
+    // The state of the network is not used or changed.
+    double Backprop(const double* a_inputs, const double* a_targets, unsigned int a_num_samples,
+                    double a_learning_rate, std::vector<Connection>& a_connections);
+
+    // Truncated backpropagation through time. The samples are a sequence,
+    // run like Input() and Activate() from the current state on. After every
+    // a_truncation steps the errors are propagated back through these steps
+    // and the weights change by the gradient averaged over them.
+    double BPTT(const double* a_inputs, const double* a_targets, unsigned int a_num_samples,
+                double a_learning_rate, unsigned int a_truncation,
+                std::vector<Connection>& a_connections);
+
+    void Flush()
+    {
+        Flush(m_state);
+    }
+    void Input(const double* a_Inputs)
+    {
+        Input(m_state, a_Inputs);
+    }
+    double GetOutput(unsigned int a_idx) const
+    {
+        return GetOutput(m_state, a_idx);
+    }
+    double GetOutput(const BasicCompiledNetworkState<T>& a_state, unsigned int a_idx) const
+    {
+        return a_state.m_activation[m_slot[m_num_inputs + a_idx]];
+    }
+
+    // State of a neuron, by its original index
+    double GetActivation(unsigned int a_neuron_idx) const
+    {
+        return m_state.m_activation[m_slot[a_neuron_idx]];
+    }
+    double GetMembranePotential(unsigned int a_neuron_idx) const
+    {
+        return m_state.m_membrane_potential[m_slot[a_neuron_idx]];
+    }
+
+private:
+
+    // Sums up the incoming signals of the slots [a_begin .. a_end) into m_activesum
+    void Accumulate(BasicCompiledNetworkState<T>& a_state, unsigned int a_begin, unsigned int a_end) const;
+
+    // Applies the activation functions to m_activesum, for the runs [a_begin .. a_end)
+    void ApplyActivationFunctions(BasicCompiledNetworkState<T>& a_state, unsigned int a_begin, unsigned int a_end) const;
+
+    // The same for the slots [a_begin .. a_end)
+    void ApplyActivationFunctionsToSlots(BasicCompiledNetworkState<T>& a_state, unsigned int a_begin, unsigned int a_end) const;
+
+    // What is done to the sums of the slots before the activation functions
+    enum SumUpdate
+    {
+        NO_SUM_UPDATE = 0,
+        ADD_BIAS,   // as in ActivateUseInternalBias()
+        LEAKY       // as in ActivateLeaky()
+    };
+
+    // True if the slots [a_begin .. a_end) are to be activated in parallel
+    bool UseThreads(unsigned int a_begin, unsigned int a_end) const;
+
+    // Accumulates and activates the slots [a_begin .. a_end) on the threads
+    // of the shared ThreadPool, all of them from the activations as they
+    // were before. The same as Accumulate(), then a_update, then
+    // ApplyActivationFunctionsToSlots() over the range.
+    void ActivateParallel(BasicCompiledNetworkState<T>& a_state, unsigned int a_begin, unsigned int a_end,
+                          SumUpdate a_update, double a_dtime) const;
+
+    // Compiles the program, and the fixed capacity form, from the arrays above
+    void BuildProgram();
+
+    // Activates the non-input slots in slot order, in double precision and
+    // with the weights a_weight, reading the activations from a_in and
+    // writing them to a_out. With a_in and a_out the same, this is
+    // ActivateTopological() of an acyclic network, otherwise a step of
+    // Activate(). The derivatives of the activation functions are stored
+    // in a_derivative.
+    void TrainingStep(const double* a_weight, const double* a_in, double* a_out, double* a_derivative);
+
+    // Propagates the errors of the activations back through TrainingStep(),
+    // in reverse slot order, from a_out_error to a_in_error (which may be
+    // the same). The gradient of the weights is added to a_gradient.
+    void TrainingBackStep(const double* a_weight, const double* a_in, const double* a_derivative,
+                          const double* a_out_error, double* a_in_error, double* a_gradient);
+
+    // Moves a_weight by -a_rate times a_gradient and stores the result
+    // in a_connections and m_weight
+    void UpdateWeights(double* a_weight, const double* a_gradient, double a_rate,
+                       std::vector<Connection>& a_connections);
+
+    // Runs the instructions [a_begin .. a_end), reading the activations
+    // from a_in and writing them to a_out (which may be the same)
+    void RunProgram(const T* a_in, T* a_out, unsigned int a_begin, unsigned int a_end) const;
+
+    // State of the samples in ActivateBatch(). Every array is
+    // [slot][sample], so a connection is applied to all samples at once.
+    std::vector<T> m_batch_activesum, m_batch_activation;
+    std::vector<T> m_batch_a, m_batch_b;
+};
+
+typedef BasicCompiledNetwork<double> CompiledNetwork;
+typedef BasicCompiledNetwork<float> CompiledNetworkFloat;
+typedef BasicCompiledNetworkState<double> CompiledNetworkState;
+typedef BasicCompiledNetworkState<float> CompiledNetworkStateFloat;
+
+} // namespace NEAT
+
+#endif
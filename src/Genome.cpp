@@ -570,6 +570,11 @@ bool Genome::HasLinkByInnovID(unsigned int id) const
 
 // This builds a fastnetwork structure out from the genome
 void Genome::BuildPhenotype(NeuralNetwork& a_Net) const
+{
+    BuildPhenotype(a_Net, false);
+}
+
+void Genome::BuildPhenotype(NeuralNetwork& a_Net, bool a_Compile) const
 {
     // first clear out the network
     a_Net.Clear();
@@ -579,49 +584,183 @@ void Genome::BuildPhenotype(NeuralNetwork& a_Net) const
     for(unsigned int i=0; i<NumNeurons(); i++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
 
         t_n.m_a                        = m_NeuronGenes[i].m_A;
         t_n.m_b                        = m_NeuronGenes[i].m_B;
         t_n.m_timeconst                = m_NeuronGenes[i].m_TimeConstant;
         t_n.m_bias                     = m_NeuronGenes[i].m_Bias;
         t_n.m_activation_function_type = m_NeuronGenes[i].m_ActFunction;
-        t_n.m_split_y                  = m_NeuronGenes[i].SplitY();
         t_n.m_type                     = m_NeuronGenes[i].Type();
+        t_l.m_split_y                  = m_NeuronGenes[i].SplitY();
 
-        a_Net.AddNeuron( t_n );
+        a_Net.AddNeuron( t_n, t_l );
+        a_Net.m_neuron_gene_ids.push_back( m_NeuronGenes[i].ID() );
     }
 
     // Fill the net with the connections
     for(unsigned int i=0; i<NumLinks(); i++)
     {
         Connection t_c;
+        ConnectionLearning t_l;
 
         t_c.m_source_neuron_idx = GetNeuronIndex( m_LinkGenes[i].FromNeuronID() );
         t_c.m_target_neuron_idx = GetNeuronIndex( m_LinkGenes[i].ToNeuronID() );
         t_c.m_weight = m_LinkGenes[i].GetWeight();
-        t_c.m_recur_flag = m_LinkGenes[i].IsRecurrent();
+        t_l.m_recur_flag = m_LinkGenes[i].IsRecurrent();
 
         //////////////////////
         // stupid hack
-        t_c.m_hebb_rate = 0.3;
-        t_c.m_hebb_pre_rate = 0.1;
+        t_l.m_hebb_rate = 0.3;
+        t_l.m_hebb_pre_rate = 0.1;
         //////////////////////
 
-        a_Net.AddConnection( t_c );
+        a_Net.AddConnection( t_c, t_l );
+        a_Net.m_link_gene_ids.push_back( m_LinkGenes[i].InnovationID() );
     }
 
     a_Net.Flush();
 
+    if (a_Compile)
+    {
+        a_Net.SelectBackend();
+    }
+
     // Note however that the RTRL variables are not initialized.
     // The user must manually call the InitRTRLMatrix() method to do it.
     // This is because of storage issues. RTRL need not to be used every time.
 }
 
+bool Genome::UpdatePhenotype(NeuralNetwork& a_Net) const
+{
+    // the same genes, in the same order, and the same activation functions
+    bool t_same = (a_Net.NumInputs() == m_NumInputs) && (a_Net.NumOutputs() == m_NumOutputs) &&
+                  (a_Net.m_neurons.size() == NumNeurons()) &&
+                  (a_Net.m_neuron_gene_ids.size() == NumNeurons()) &&
+                  (a_Net.m_connections.size() == NumLinks()) &&
+                  (a_Net.m_link_gene_ids.size() == NumLinks());
+    for(unsigned int i=0; t_same && (i<NumNeurons()); i++)
+    {
+        t_same = (a_Net.m_neuron_gene_ids[i] == m_NeuronGenes[i].ID()) &&
+                 (a_Net.m_neurons[i].m_activation_function_type == m_NeuronGenes[i].m_ActFunction);
+    }
+    for(unsigned int i=0; t_same && (i<NumLinks()); i++)
+    {
+        t_same = (a_Net.m_link_gene_ids[i] == m_LinkGenes[i].InnovationID());
+    }
+
+    if (!t_same)
+    {
+        BuildPhenotype(a_Net, a_Net.IsCompiled());
+        return false;
+    }
+
+    for(unsigned int i=0; i<NumNeurons(); i++)
+    {
+        Neuron& t_n = a_Net.m_neurons[i];
+        t_n.m_a         = m_NeuronGenes[i].m_A;
+        t_n.m_b         = m_NeuronGenes[i].m_B;
+        t_n.m_timeconst = m_NeuronGenes[i].m_TimeConstant;
+        t_n.m_bias      = m_NeuronGenes[i].m_Bias;
+    }
+    for(unsigned int i=0; i<NumLinks(); i++)
+    {
+        a_Net.m_connections[i].m_weight = m_LinkGenes[i].GetWeight();
+    }
+    a_Net.UpdateParameters();
+
+    return true;
+}
+
+
+// The a_Field of every neuron gene, to or from a_Values
+static void GetNeuronGeneField(const std::vector<NeuronGene>& a_Genes, double NeuronGene::*a_Field, double* a_Values)
+{
+    for(unsigned int i=0; i<a_Genes.size(); i++)
+    {
+        a_Values[i] = a_Genes[i].*a_Field;
+    }
+}
+
+static void SetNeuronGeneField(std::vector<NeuronGene>& a_Genes, double NeuronGene::*a_Field, const double* a_Values)
+{
+    for(unsigned int i=0; i<a_Genes.size(); i++)
+    {
+        a_Genes[i].*a_Field = a_Values[i];
+    }
+}
+
+void Genome::GetWeights(double* a_Weights) const
+{
+    for(unsigned int i=0; i<NumLinks(); i++)
+    {
+        a_Weights[i] = m_LinkGenes[i].GetWeight();
+    }
+}
+
+void Genome::SetWeights(const double* a_Weights)
+{
+    for(unsigned int i=0; i<NumLinks(); i++)
+    {
+        m_LinkGenes[i].SetWeight(a_Weights[i]);
+    }
+}
+
+void Genome::GetBiases(double* a_Biases) const
+{
+    GetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_Bias, a_Biases);
+}
+
+void Genome::SetBiases(const double* a_Biases)
+{
+    SetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_Bias, a_Biases);
+}
+
+void Genome::GetTimeConstants(double* a_TimeConstants) const
+{
+    GetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_TimeConstant, a_TimeConstants);
+}
+
+void Genome::SetTimeConstants(const double* a_TimeConstants)
+{
+    SetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_TimeConstant, a_TimeConstants);
+}
+
+void Genome::GetActivationA(double* a_A) const
+{
+    GetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_A, a_A);
+}
+
+void Genome::SetActivationA(const double* a_A)
+{
+    SetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_A, a_A);
+}
+
+void Genome::GetActivationB(double* a_B) const
+{
+    GetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_B, a_B);
+}
+
+void Genome::SetActivationB(const double* a_B)
+{
+    SetNeuronGeneField(m_NeuronGenes, &NeuronGene::m_B, a_B);
+}
 
 
 
 
 
+
+// True if the CPPN gives the same outputs with one ActivateTopological()
+// as with a_Depth Activate() calls, as deep as its genome - if it is
+// acyclic and settles within those. The depth of the genome stops at 16
+// and doesn't count the path to hidden neurons without inputs, and then
+// the outputs of a_Depth steps are the ones the CPPN is queried for.
+static bool ActivatesTopologically(const NeuralNetwork& a_Cppn, int a_Depth)
+{
+    return (a_Depth > 0) && (a_Cppn.SettlingDepth() <= static_cast<unsigned int>(a_Depth));
+}
+
 // Builds a HyperNEAT phenotype based on the substrate
 // The CPPN input dimensionality must match the largest number of
 // dimensions in the substrate
@@ -648,64 +787,69 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
     }
 
     // Now we create the substrate (net)
-    net.SetInputOutputDimentions(static_cast<unsigned short>(subst.m_input_coords.size()),
-                                 static_cast<unsigned short>(subst.m_output_coords.size()));
+    net.SetInputOutputDimentions(static_cast<unsigned int>(subst.m_input_coords.size()),
+                                 static_cast<unsigned int>(subst.m_output_coords.size()));
 
     // Inputs
     for(unsigned int i=0; i<subst.m_input_coords.size(); i++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
 
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = subst.m_input_coords[i];
-        ASSERT(t_n.m_substrate_coords.size() > 0); // prevent 0D points
+        t_l.m_substrate_coords = subst.m_input_coords[i];
+        ASSERT(t_l.m_substrate_coords.size() > 0); // prevent 0D points
         t_n.m_activation_function_type = NEAT::LINEAR;
         t_n.m_type = NEAT::INPUT;
 
-        net.AddNeuron(t_n);
+        net.AddNeuron(t_n, t_l);
     }
 
     // Output
     for(unsigned int i=0; i<subst.m_output_coords.size(); i++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
 
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = subst.m_output_coords[i];
-        ASSERT(t_n.m_substrate_coords.size() > 0); // prevent 0D points
+        t_l.m_substrate_coords = subst.m_output_coords[i];
+        ASSERT(t_l.m_substrate_coords.size() > 0); // prevent 0D points
         t_n.m_activation_function_type = subst.m_output_nodes_activation;
         t_n.m_type = NEAT::OUTPUT;
 
-        net.AddNeuron(t_n);
+        net.AddNeuron(t_n, t_l);
     }
 
     // Hidden
     for(unsigned int i=0; i<subst.m_hidden_coords.size(); i++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
 
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = subst.m_hidden_coords[i];
-        ASSERT(t_n.m_substrate_coords.size() > 0); // prevent 0D points
+        t_l.m_substrate_coords = subst.m_hidden_coords[i];
+        ASSERT(t_l.m_substrate_coords.size() > 0); // prevent 0D points
         t_n.m_activation_function_type = subst.m_hidden_nodes_activation;
         t_n.m_type = NEAT::HIDDEN;
 
-        net.AddNeuron(t_n);
+        net.AddNeuron(t_n, t_l);
     }
 
     // Begin querying the CPPN
     // Create the neural network that will represent the CPPN
     NeuralNetwork t_temp_phenotype(true);
-    BuildPhenotype(t_temp_phenotype);
+    t_temp_phenotype.SetActivationAccuracy(subst.m_cppn_activation_accuracy);
+    BuildPhenotype(t_temp_phenotype, true);
     t_temp_phenotype.Flush();
 
     // now loop over every potential connection in the substrate and take its weight
     CalculateDepth();
     int dp = GetDepth();
-
+    bool t_topological = ActivatesTopologically(t_temp_phenotype, dp);
+
     // For leaky substrates, first loop over the neurons and set their properties
     if (subst.m_leaky)
 	{
@@ -720,9 +864,10 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
 			std::vector<double> t_inputs;
 			t_inputs.resize(NumInputs());
 
-			for(unsigned int n=0; n<net.m_neurons[i].m_substrate_coords.size(); n++)
+			const std::vector<double>& t_coords = net.GetNeuronLayout(i).m_substrate_coords;
+			for(unsigned int n=0; n<t_coords.size(); n++)
 			{
-				t_inputs[n] = net.m_neurons[i].m_substrate_coords[n];
+				t_inputs[n] = t_coords[n];
 			}
 
 			if (subst.m_with_distance)
@@ -741,13 +886,21 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
 			t_temp_phenotype.Input(t_inputs);
 
 			// activate as many times as deep
-			for(int d=0; d<dp; d++)
+			if (t_topological)
 			{
-				t_temp_phenotype.Activate();
+				t_temp_phenotype.ActivateTopological();
+			}
+			else
+			{
+				for(int d=0; d<dp; d++)
+				{
+					t_temp_phenotype.Activate();
+				}
 			}
 
-			double t_tc   = t_temp_phenotype.Output()[NumOutputs()-2];
-			double t_bias = t_temp_phenotype.Output()[NumOutputs()-1];
+			const double* t_outputs = t_temp_phenotype.OutputPtr();
+			double t_tc   = t_outputs[NumOutputs()-2];
+			double t_bias = t_outputs[NumOutputs()-1];
 
 			Clamp(t_tc, -1, 1);
 			Clamp(t_bias, -1, 1);
@@ -910,19 +1063,21 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
 		std::vector<double> t_inputs;
 		t_inputs.resize(NumInputs());
 
-		int from_dims = net.m_neurons[j].m_substrate_coords.size();
-		int to_dims = net.m_neurons[i].m_substrate_coords.size();
+		const std::vector<double>& t_from = net.GetNeuronLayout(j).m_substrate_coords;
+		const std::vector<double>& t_to = net.GetNeuronLayout(i).m_substrate_coords;
+		int from_dims = t_from.size();
+		int to_dims = t_to.size();
 
 		// input the node positions to the CPPN
 		// from
 		for(int n=0; n<from_dims; n++)
 		{
-			t_inputs[n] = net.m_neurons[j].m_substrate_coords[n];
+			t_inputs[n] = t_from[n];
 		}
 		// to
 		for(int n=0; n<to_dims; n++)
 		{
-			t_inputs[max_dims + n] = net.m_neurons[i].m_substrate_coords[n];
+			t_inputs[max_dims + n] = t_to[n];
 		}
 
 		// the input is like
@@ -953,23 +1108,31 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
 		t_temp_phenotype.Input(t_inputs);
 
 		// activate as many times as deep
-		for(int d=0; d<dp; d++)
+		if (t_topological)
 		{
-			t_temp_phenotype.Activate();
+			t_temp_phenotype.ActivateTopological();
+		}
+		else
+		{
+			for(int d=0; d<dp; d++)
+			{
+				t_temp_phenotype.Activate();
+			}
 		}
 
 		// the output is a weight
 		double t_link = 0; ;
 		double t_weight = 0;
 
+		const double* t_outputs = t_temp_phenotype.OutputPtr();
 		if (subst.m_query_weights_only)
 		{
-			t_weight = t_temp_phenotype.Output()[0];
+			t_weight = t_outputs[0];
 		}
 		else
 		{
-			t_link = t_temp_phenotype.Output()[0];
-			t_weight = t_temp_phenotype.Output()[1];
+			t_link = t_outputs[0];
+			t_weight = t_outputs[1];
 		}
 
 //		Clamp(t_weight, -1, 1);
@@ -985,11 +1148,13 @@ void Genome::BuildHyperNEATPhenotype(NeuralNetwork& net, Substrate& subst)
 			t_c.m_source_neuron_idx = j;
 			t_c.m_target_neuron_idx = i;
 			t_c.m_weight = t_weight;
-			t_c.m_recur_flag = false;
 
 			net.AddConnection(t_c);
 		}
     }
+
+    // number the hidden neurons so activation reads them mostly in sequence
+    net.ReorderHiddenNeurons();
 }
 
 
@@ -1008,6 +1173,22 @@ void Genome::DerivePhenotypicChanges(NeuralNetwork& a_Net)
     // Since we don't have a comparison operator yet, we are going to assume
     // identical topolgy
     // TODO: create that comparison operator for NeuralNetworks
+    // (a network with a different number of connections is surely different)
+    if (a_Net.m_connections.size() != NumLinks())
+        return;
+    // an optimized network has lost, merged or added connections, even if
+    // as many are left, so which link each one came from is unknown
+    if (a_Net.IsOptimized())
+        return;
+    // and where the links the connections came from are known, they must match
+    if (!a_Net.m_link_gene_ids.empty())
+    {
+        for(unsigned int i=0; i<NumLinks(); i++)
+        {
+            if (a_Net.m_link_gene_ids[i] != m_LinkGenes[i].InnovationID())
+                return;
+        }
+    }
 
     // Iterate through the links and replace weights
     for(unsigned int i=0; i<NumLinks(); i++)
@@ -2923,12 +3104,13 @@ void Genome::Build_ES_Phenotype(NeuralNetwork& net, Substrate& subst, Parameters
 
     net.m_neurons.reserve(maxNodes);
     net.m_connections.reserve((maxNodes*(maxNodes -1))/2);
-    net.SetInputOutputDimentions(static_cast<unsigned short>(input_count),
-                                 static_cast<unsigned short>(output_count));
+    net.SetInputOutputDimentions(static_cast<unsigned int>(input_count),
+                                 static_cast<unsigned int>(output_count));
 
 
     NeuralNetwork t_temp_phenotype(true);
-    BuildPhenotype(t_temp_phenotype);
+    t_temp_phenotype.SetActivationAccuracy(subst.m_cppn_activation_accuracy);
+    BuildPhenotype(t_temp_phenotype, true);
 
     // Find Inputs to Hidden connections.
     for(unsigned int i = 0; i < input_count; i++)
@@ -2961,7 +3143,6 @@ void Genome::Build_ES_Phenotype(NeuralNetwork& net, Substrate& subst, Parameters
             tc.m_source_neuron_idx = i;
             tc.m_target_neuron_idx = target_index + hidden_index ;
             tc.m_weight = TempConnections[j].weight*subst.m_max_weight_and_bias;
-            tc.m_recur_flag = false;
 
             net.m_connections.push_back(tc);
 
@@ -3000,7 +3181,6 @@ void Genome::Build_ES_Phenotype(NeuralNetwork& net, Substrate& subst, Parameters
                 tc.m_source_neuron_idx = itr_hid->second + hidden_index;  // NO!!!
                 tc.m_target_neuron_idx = target_index + hidden_index;
                 tc.m_weight = TempConnections[k].weight*subst.m_max_weight_and_bias;
-                tc.m_recur_flag = false;
 
                 net.m_connections.push_back(tc);
 
@@ -3042,7 +3222,6 @@ void Genome::Build_ES_Phenotype(NeuralNetwork& net, Substrate& subst, Parameters
                 tc.m_target_neuron_idx = i + input_count;
 
                 tc.m_weight = TempConnections[j].weight*subst.m_max_weight_and_bias;
-                tc.m_recur_flag = false;
 
                 net.m_connections.push_back(tc);
             }
@@ -3054,50 +3233,58 @@ void Genome::Build_ES_Phenotype(NeuralNetwork& net, Substrate& subst, Parameters
     {
         // Shameless reuse
         Neuron t_n;
+        NeuronLayout t_l;
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = subst.m_input_coords[i];
+        t_l.m_substrate_coords = subst.m_input_coords[i];
         t_n.m_activation_function_type = NEAT::LINEAR;
         t_n.m_type = NEAT::INPUT;
-        net.m_neurons.push_back(t_n);
+        net.AddNeuron(t_n, t_l);
     }
     //Bias n.
     Neuron t_n;
+    NeuronLayout t_l;
     t_n.m_a = 1;
     t_n.m_b = 0;
-    t_n.m_substrate_coords = subst.m_input_coords[input_count -1];
+    t_l.m_substrate_coords = subst.m_input_coords[input_count -1];
     t_n.m_activation_function_type = NEAT::LINEAR;
     t_n.m_type = NEAT::BIAS;
-    net.m_neurons.push_back(t_n);
+    net.AddNeuron(t_n, t_l);
 
     for (unsigned int i = 0; i < output_count; i++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = subst.m_output_coords[i];
+        t_l.m_substrate_coords = subst.m_output_coords[i];
         t_n.m_activation_function_type = subst.m_output_nodes_activation;
         t_n.m_type = NEAT::OUTPUT;
-        net.m_neurons.push_back(t_n);
+        net.AddNeuron(t_n, t_l);
     }
 
     boost::unordered_map< std::vector<double>, int >::iterator itr;
     for (itr = hidden_nodes.begin(); itr!=hidden_nodes.end(); itr++)
     {
         Neuron t_n;
+        NeuronLayout t_l;
         t_n.m_a = 1;
         t_n.m_b = 0;
-        t_n.m_substrate_coords = itr -> first;
+        t_l.m_substrate_coords = itr -> first;
 
-        ASSERT(t_n.m_substrate_coords.size() > 0); // prevent 0D points
+        ASSERT(t_l.m_substrate_coords.size() > 0); // prevent 0D points
         t_n.m_activation_function_type = subst.m_hidden_nodes_activation;
         t_n.m_type = NEAT::HIDDEN;
-        net.m_neurons.push_back(t_n);
+        net.AddNeuron(t_n, t_l);
     }
 
     // Clean the generated network from dangling connections and we're good to go.
     // Easy as 1,2,4 ...
     Clean_Net(net.m_connections, input_count, output_count, hidden_nodes.size());
+
+    // the hidden neurons are in hash order, number them so activation
+    // reads them mostly in sequence
+    net.ReorderHiddenNeurons();
 }
 
 // Used to determine the placement of hidden neurons in the Evolvable Substrate.
@@ -3105,6 +3292,7 @@ void Genome::DivideInitialize(const std::vector<double>& node, boost::shared_ptr
 {   // Have to check if this actually does something useful here
     CalculateDepth();
     int cppn_depth = GetDepth();
+    bool t_topological = ActivatesTopologically(cppn, cppn_depth);
     std::vector<double> t_inputs;
     t_inputs.reserve(7); // 3 dimensions + bias. // TODO: get rid of the hardcoded value, make it support 2D/3D substrates
 
@@ -3155,14 +3343,22 @@ void Genome::DivideInitialize(const std::vector<double>& node, boost::shared_ptr
             cppn.Flush();
             cppn.Input(t_inputs);
 
-            for(int d=0; d<cppn_depth; d++)
+            if (t_topological)
             {
-                cppn.Activate();
+                cppn.ActivateTopological();
             }
-            p -> children[i] -> weight = cppn.Output()[0];
+            else
+            {
+                for(int d=0; d<cppn_depth; d++)
+                {
+                    cppn.Activate();
+                }
+            }
+            const double* t_outputs = cppn.OutputPtr();
+            p -> children[i] -> weight = t_outputs[0];
             if (params.Leo)
             {
-                p -> children[i] -> leo = cppn.Output()[cppn.Output().size() - 1];
+                p -> children[i] -> leo = t_outputs[cppn.NumOutputs() - 1];
             }
             cppn.Flush();
 
@@ -3206,6 +3402,7 @@ void Genome::PruneExpress( const std::vector<double>& node, boost::shared_ptr<Qu
             {
                 CalculateDepth();
                 int cppn_depth = GetDepth();
+                bool t_topological = ActivatesTopologically(cppn, cppn_depth);
 
                 double d_left, d_right, d_top, d_bottom;
                 std::vector<double> inputs;
@@ -3238,24 +3435,38 @@ void Genome::PruneExpress( const std::vector<double>& node, boost::shared_ptr<Qu
                 inputs[root_index] -= root -> width;
                 cppn.Input(inputs);
 
-                for(int d=0; d<cppn_depth; d++)
+                if (t_topological)
                 {
-                    cppn.Activate();
+                    cppn.ActivateTopological();
+                }
+                else
+                {
+                    for(int d=0; d<cppn_depth; d++)
+                    {
+                        cppn.Activate();
+                    }
                 }
 
-                d_left = Abs(root -> children[i] -> weight - cppn.Output()[0]);
+                d_left = Abs(root -> children[i] -> weight - cppn.OutputPtr()[0]);
                 cppn.Flush();
 
                 // Right
                 inputs[root_index] += 2* root -> width;
                 cppn.Input(inputs);
 
-                for(int d=0; d<cppn_depth; d++)
+                if (t_topological)
                 {
-                    cppn.Activate();
+                    cppn.ActivateTopological();
+                }
+                else
+                {
+                    for(int d=0; d<cppn_depth; d++)
+                    {
+                        cppn.Activate();
+                    }
                 }
 
-                d_right = Abs(root -> children[i] -> weight - cppn.Output()[0]);
+                d_right = Abs(root -> children[i] -> weight - cppn.OutputPtr()[0]);
                 cppn.Flush();
 
                 // Top
@@ -3263,23 +3474,37 @@ void Genome::PruneExpress( const std::vector<double>& node, boost::shared_ptr<Qu
                 inputs[root_index+1] -= root -> width;
                 cppn.Input(inputs);
 
-                for(int d=0; d<cppn_depth; d++)
+                if (t_topological)
                 {
-                    cppn.Activate();
+                    cppn.ActivateTopological();
+                }
+                else
+                {
+                    for(int d=0; d<cppn_depth; d++)
+                    {
+                        cppn.Activate();
+                    }
                 }
 
-                d_top = Abs(root -> children[i] -> weight - cppn.Output()[0]);
+                d_top = Abs(root -> children[i] -> weight - cppn.OutputPtr()[0]);
                 cppn.Flush();
                 // Bottom
                 inputs[root_index+1] += 2*root -> width;
                 cppn.Input(inputs);
 
-                for(int d=0; d<cppn_depth; d++)
+                if (t_topological)
                 {
-                    cppn.Activate();
+                    cppn.ActivateTopological();
+                }
+                else
+                {
+                    for(int d=0; d<cppn_depth; d++)
+                    {
+                        cppn.Activate();
+                    }
                 }
 
-                d_bottom = Abs(root -> children[i] -> weight - cppn.Output()[0]);
+                d_bottom = Abs(root -> children[i] -> weight - cppn.OutputPtr()[0]);
                 cppn.Flush();
 
                 if (std::max(std::min(d_top, d_bottom), std::min(d_left, d_right)) > params.BandThreshold)
@@ -3391,7 +3616,7 @@ py::list Genome::GetPoints(py::tuple& t_node,Parameters& params, bool outgoing )
     }
 
     NeuralNetwork cppn(true);
-    BuildPhenotype(cppn);
+    BuildPhenotype(cppn, true);
     cppn.Flush();
 
     boost::shared_ptr<QuadPoint> root  = boost::shared_ptr<QuadPoint>(new QuadPoint(params.Qtree_X, params.Qtree_Y, params.Width, params.Height, 1));
@@ -269,6 +269,22 @@ public:
         return m_NumOutputs;
     }
 
+    // Bulk access to the link weights (NumLinks() of them, in the order of
+    // m_LinkGenes) and the neuron parameters (NumNeurons() of them, in the
+    // order of m_NeuronGenes), which is the order of the phenotype's
+    // connections and neurons. The values set aren't clamped to the limits
+    // in the parameters.
+    void GetWeights(double* a_Weights) const;
+    void SetWeights(const double* a_Weights);
+    void GetBiases(double* a_Biases) const;
+    void SetBiases(const double* a_Biases);
+    void GetTimeConstants(double* a_TimeConstants) const;
+    void SetTimeConstants(const double* a_TimeConstants);
+    void GetActivationA(double* a_A) const;
+    void SetActivationA(const double* a_A);
+    void GetActivationB(double* a_B) const;
+    void SetActivationB(const double* a_B);
+
     void SetNeuronXY(unsigned int a_idx, int a_x, int a_y)
     {
         ASSERT(a_idx < m_NeuronGenes.size());
@@ -337,7 +353,20 @@ public:
     // This builds a fastnetwork structure out from the genome
     void BuildPhenotype(NeuralNetwork& net) const;
 
-    // Projects the phenotype's weights back to the genome
+    // Same as above, optionally compiling the network once it is built,
+    // with the engine NeuralNetwork::SelectBackend() picks for it
+    void BuildPhenotype(NeuralNetwork& net, bool a_Compile) const;
+
+    // Copies the weights and neuron parameters of the genome into a phenotype
+    // built from it (or from a genome of the same topology) by BuildPhenotype(),
+    // in place and in its compiled form, keeping its state. Phenotypes of
+    // other neuron or link genes or activation functions are built again
+    // instead (and compiled if they were). Returns true if updated in place.
+    bool UpdatePhenotype(NeuralNetwork& net) const;
+
+    // Projects the phenotype's weights back to the genome,
+    // e.g. after training it with NeuralNetwork::Backprop() or BPTT()
+    // (not after NeuralNetwork::Optimize(), nothing is changed then)
     void DerivePhenotypicChanges(NeuralNetwork& a_Net);
 
 
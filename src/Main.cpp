@@ -18,6 +18,8 @@
 //#include "NSGAPopulation.h"
 
 #include <iostream>
+#include <cstdio>
+#include <cmath>
 #include <boost/asio.hpp>
 #include <boost/thread.hpp>
 #include <boost/bind.hpp>
@@ -28,11 +30,6 @@ using namespace NEAT;
 #ifdef ENABLE_TESTING
 
 
-double abs(double x)
-{
-    if (x < 0) return -x;
-    return x;
-}
 
 //std::vector<double>
 double xortest(Genome& g, Substrate& subst, Parameters& params)
@@ -44,40 +41,20 @@ double xortest(Genome& g, Substrate& subst, Parameters& params)
 
     int depth = 5;
     double error = 0;
-    std::vector<double> inputs;
-    inputs.resize(3);
-
-    net.Flush();
-    inputs[0] = 1;
-    inputs[1] = 0;
-    inputs[2] = 1;
-    net.Input(inputs);
-    for(int i=0; i<depth; i++) { net.Activate(); }
-    error += abs(net.Output()[0] - 1.0);
-
-    net.Flush();
-    inputs[0] = 0;
-    inputs[1] = 1;
-    inputs[2] = 1;
-    net.Input(inputs);
-    for(int i=0; i<depth; i++) { net.Activate(); }
-    error += abs(net.Output()[0] - 1.0);
-
-    net.Flush();
-    inputs[0] = 0;
-    inputs[1] = 0;
-    inputs[2] = 1;
-    net.Input(inputs);
-    for(int i=0; i<depth; i++) { net.Activate(); }
-    error += abs(net.Output()[0] - 0.0);
-
-    net.Flush();
-    inputs[0] = 1;
-    inputs[1] = 1;
-    inputs[2] = 1;
-    net.Input(inputs);
-    for(int i=0; i<depth; i++) { net.Activate(); }
-    error += abs(net.Output()[0] - 0.0);
+
+    // all four XOR cases in one batch
+    std::vector< std::vector<double> > inputs(4, std::vector<double>(3, 1.0));
+    inputs[0][0] = 1; inputs[0][1] = 0;
+    inputs[1][0] = 0; inputs[1][1] = 1;
+    inputs[2][0] = 0; inputs[2][1] = 0;
+    inputs[3][0] = 1; inputs[3][1] = 1;
+
+    std::vector< std::vector<double> > outputs;
+    net.ActivateBatch(inputs, outputs, depth);
+    error += fabs(outputs[0][0] - 1.0);
+    error += fabs(outputs[1][0] - 1.0);
+    error += fabs(outputs[2][0] - 0.0);
+    error += fabs(outputs[3][0] - 0.0);
 
     //std::vector<double> f;
     //f.push_back((4.0 - error)*(4.0 - error));
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        NetworkImage.cpp
+// Description: The binary, memory-mappable file format of the phenotypes.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+#include "NetworkImage.h"
+
+namespace NEAT
+{
+
+static const char g_ImageMagic[8] = { 'M', 'N', 'E', 'A', 'T', 'N', 'N', 0 };
+
+static uint64_t AlignImageOffset(uint64_t a_offset)
+{
+    return (a_offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+NetworkImage::NetworkImage()
+{
+    m_data = NULL;
+    m_size = 0;
+}
+
+size_t NetworkImage::ElementSize(NetworkImageArray a_Array)
+{
+    switch (a_Array)
+    {
+    case IMAGE_NEURON_TYPE:
+    case IMAGE_NEURON_ACTIVATION_FUNCTION:
+    case IMAGE_CONNECTION_SOURCE:
+    case IMAGE_CONNECTION_TARGET:
+        return 4;
+    case IMAGE_CONNECTION_RECUR_FLAG:
+        return 1;
+    default:
+        return sizeof(double);
+    }
+}
+
+void NetworkImage::Layout(unsigned int a_NumNeurons, unsigned int a_NumConnections,
+                          NetworkImageHeader& a_Header)
+{
+    memset(&a_Header, 0, sizeof(a_Header));
+    memcpy(a_Header.m_magic, g_ImageMagic, sizeof(g_ImageMagic));
+    a_Header.m_version = NETWORK_IMAGE_VERSION;
+    a_Header.m_byte_order = NETWORK_IMAGE_BYTE_ORDER;
+    a_Header.m_header_size = sizeof(NetworkImageHeader);
+    a_Header.m_num_neurons = a_NumNeurons;
+    a_Header.m_num_connections = a_NumConnections;
+
+    uint64_t t_offset = AlignImageOffset(sizeof(NetworkImageHeader));
+    for (int i = 0; i < IMAGE_NUM_ARRAYS; i++)
+    {
+        NetworkImageArray t_array = static_cast<NetworkImageArray>(i);
+        uint64_t t_count = (t_array < IMAGE_CONNECTION_SOURCE) ? a_NumNeurons : a_NumConnections;
+        a_Header.m_offset[i] = t_offset;
+        t_offset = AlignImageOffset(t_offset + t_count * ElementSize(t_array));
+    }
+    a_Header.m_size = t_offset;
+}
+
+bool NetworkImage::Attach(const void* a_Data, size_t a_Size)
+{
+    m_data = NULL;
+    m_size = 0;
+
+    if ((a_Data == NULL) || (a_Size < sizeof(NetworkImageHeader)) ||
+        ((reinterpret_cast<size_t>(a_Data) & 7) != 0))
+        return false;
+
+    const NetworkImageHeader* t_header = reinterpret_cast<const NetworkImageHeader*>(a_Data);
+    if ((memcmp(t_header->m_magic, g_ImageMagic, sizeof(g_ImageMagic)) != 0) ||
+        (t_header->m_version != NETWORK_IMAGE_VERSION) ||
+        (t_header->m_byte_order != NETWORK_IMAGE_BYTE_ORDER) ||
+        (t_header->m_header_size != sizeof(NetworkImageHeader)) ||
+        (t_header->m_size > a_Size))
+        return false;
+
+    // the layout is fixed by the counts, anything else is a damaged image
+    NetworkImageHeader t_layout;
+    Layout(t_header->m_num_neurons, t_header->m_num_connections, t_layout);
+    if ((t_layout.m_size != t_header->m_size) ||
+        (memcmp(t_layout.m_offset, t_header->m_offset, sizeof(t_layout.m_offset)) != 0))
+        return false;
+
+    m_data = reinterpret_cast<const char*>(a_Data);
+    m_size = a_Size;
+    return true;
+}
+
+MappedFile::MappedFile()
+{
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const char* a_filename)
+{
+    Close();
+
+#ifndef _WIN32
+    int t_fd = open(a_filename, O_RDONLY);
+    if (t_fd < 0)
+        return false;
+
+    struct stat t_stat;
+    if ((fstat(t_fd, &t_stat) != 0) || (t_stat.st_size <= 0))
+    {
+        close(t_fd);
+        return false;
+    }
+
+    void* t_data = mmap(NULL, static_cast<size_t>(t_stat.st_size), PROT_READ, MAP_SHARED, t_fd, 0);
+    close(t_fd); // the mapping keeps the file
+    if (t_data == MAP_FAILED)
+        return false;
+
+    m_data = t_data;
+    m_size = static_cast<size_t>(t_stat.st_size);
+    m_mapped = true;
+    return true;
+#else
+    FILE* t_file = fopen(a_filename, "rb");
+    if (t_file == NULL)
+        return false;
+
+    fseek(t_file, 0, SEEK_END);
+    long t_size = ftell(t_file);
+    fseek(t_file, 0, SEEK_SET);
+    if (t_size <= 0)
+    {
+        fclose(t_file);
+        return false;
+    }
+
+    // malloc() memory is aligned well enough for the arrays
+    m_data = malloc(static_cast<size_t>(t_size));
+    m_size = static_cast<size_t>(t_size);
+    bool t_read = (m_data != NULL) && (fread(m_data, 1, m_size, t_file) == m_size);
+    fclose(t_file);
+    if (!t_read)
+        Close();
+    return t_read;
+#endif
+}
+
+void MappedFile::Close()
+{
+    if (m_data != NULL)
+    {
+#ifndef _WIN32
+        if (m_mapped)
+            munmap(m_data, m_size);
+        else
+            free(m_data);
+#else
+        free(m_data);
+#endif
+    }
+    m_data = NULL;
+    m_size = 0;
+    m_mapped = false;
+}
+
+} // namespace NEAT
@@ -0,0 +1,185 @@
+#ifndef _NETWORK_IMAGE_H
+#define _NETWORK_IMAGE_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        NetworkImage.h
+// Description: The binary, memory-mappable file format of the phenotypes.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace NEAT
+{
+
+//////////////////////////////////////////////////////////////////
+// A network image.
+//
+// The binary form of a NeuralNetwork, written by
+// NeuralNetwork::SaveBinary(). It is a header followed by one
+// contiguous array per field of the neurons and the connections,
+// in native byte order. Every array starts at the offset the
+// header gives for it, a multiple of 8 bytes from the start of the
+// image, so an image in memory (a mapped file or a buffer) can be
+// read in place through NetworkImage, without parsing.
+//
+// Loading it into a NeuralNetwork is not zero-copy, though: the
+// arrays are checked and copied element by element into the
+// network's neurons and connections, and compiling builds its own
+// arrays from those. What the format saves is the parsing, not the
+// copy.
+//
+// The version changes whenever the layout does, and images of
+// another version, byte order or word size aren't accepted.
+//////////////////////////////////////////////////////////////////
+
+const uint32_t NETWORK_IMAGE_VERSION = 1;
+const uint32_t NETWORK_IMAGE_BYTE_ORDER = 0x01020304;
+
+// The arrays of an image. The neuron arrays have one element per
+// neuron and the connection arrays one per connection.
+enum NetworkImageArray
+{
+    IMAGE_NEURON_TYPE = 0,        // int32_t, the NeuronType
+    IMAGE_NEURON_ACTIVATION_FUNCTION, // int32_t, the ActivationFunction
+    IMAGE_NEURON_A,               // double
+    IMAGE_NEURON_B,               // double
+    IMAGE_NEURON_TIMECONST,       // double
+    IMAGE_NEURON_BIAS,            // double
+    IMAGE_NEURON_SPLIT_Y,         // double
+    IMAGE_NEURON_ACTIVESUM,       // double
+    IMAGE_NEURON_ACTIVATION,      // double
+    IMAGE_NEURON_MEMBRANE_POTENTIAL, // double
+    IMAGE_CONNECTION_SOURCE,      // uint32_t
+    IMAGE_CONNECTION_TARGET,      // uint32_t
+    IMAGE_CONNECTION_WEIGHT,      // double
+    IMAGE_CONNECTION_HEBB_RATE,   // double
+    IMAGE_CONNECTION_HEBB_PRE_RATE, // double
+    IMAGE_CONNECTION_RECUR_FLAG,  // uint8_t
+
+    IMAGE_NUM_ARRAYS
+};
+
+// The flags of an image
+const uint32_t IMAGE_COMPILED = 1; // the network was compiled when saved
+
+struct NetworkImageHeader
+{
+    char m_magic[8];              // "MNEATNN" and a zero
+    uint32_t m_version;           // NETWORK_IMAGE_VERSION
+    uint32_t m_byte_order;        // NETWORK_IMAGE_BYTE_ORDER as written
+    uint32_t m_header_size;       // sizeof(NetworkImageHeader)
+    uint32_t m_flags;
+
+    uint32_t m_num_inputs, m_num_outputs;
+    uint32_t m_num_neurons, m_num_connections;
+    uint32_t m_precision;         // the Precision
+    uint32_t m_accuracy;          // the ActivationAccuracy
+
+    uint64_t m_size;              // of the whole image, in bytes
+    uint64_t m_offset[IMAGE_NUM_ARRAYS]; // of each array, from the start of the image
+};
+
+// A read-only view of an image in memory. The memory isn't copied
+// and must outlive the view.
+class NetworkImage
+{
+    const char* m_data;
+    size_t m_size;
+
+public:
+
+    NetworkImage();
+
+    // Fills a_Header with the counts and the layout of an image of
+    // that many neurons and connections. The rest is left to the caller.
+    static void Layout(unsigned int a_NumNeurons, unsigned int a_NumConnections,
+                       NetworkImageHeader& a_Header);
+
+    // Returns the size of the elements of an array
+    static size_t ElementSize(NetworkImageArray a_Array);
+
+    // Checks the header and that every array lies within the image.
+    // a_Data must be aligned to 8 bytes. Returns false (and leaves
+    // the view empty) if it isn't an image this version can use.
+    bool Attach(const void* a_Data, size_t a_Size);
+
+    bool Empty() const
+    {
+        return m_data == NULL;
+    }
+
+    const NetworkImageHeader& Header() const
+    {
+        return *reinterpret_cast<const NetworkImageHeader*>(m_data);
+    }
+
+    const void* Array(NetworkImageArray a_Array) const
+    {
+        return m_data + Header().m_offset[a_Array];
+    }
+
+    const double* Doubles(NetworkImageArray a_Array) const
+    {
+        return reinterpret_cast<const double*>(Array(a_Array));
+    }
+};
+
+// A file mapped read-only into memory. Where mmap() isn't available,
+// the file is read into memory instead.
+class MappedFile
+{
+    void* m_data;
+    size_t m_size;
+    bool m_mapped;
+
+    // not copyable
+    MappedFile(const MappedFile&);
+    MappedFile& operator=(const MappedFile&);
+
+public:
+
+    MappedFile();
+    ~MappedFile();
+
+    // Returns false if the file can't be opened or is empty
+    bool Open(const char* a_filename);
+    void Close();
+
+    const void* Data() const
+    {
+        return m_data;
+    }
+    size_t Size() const
+    {
+        return m_size;
+    }
+};
+
+} // namespace NEAT
+
+#endif
@@ -31,11 +31,17 @@
 
 #include <math.h>
 #include <float.h>
+#include <stdio.h>
+#include <cmath>
 #include <fstream>
 #include <sstream>
 #include <string>
+#include <algorithm>
 #include <iostream>
+#include <thread>
+#include <string.h>
 #include "NeuralNetwork.h"
+#include "ActivationFunctions.h"
 #include "Assert.h"
 #include "Utils.h"
 
@@ -46,106 +52,6 @@
 namespace NEAT
 {
 
-/////////////////////////////////////
-// The set of activation functions //
-/////////////////////////////////////
-
-
-inline double af_sigmoid_unsigned(double aX, double aSlope, double aShift)
-{
-    return 1.0 / (1.0 + exp( - aSlope * aX - aShift));
-}
-
-inline double af_sigmoid_signed(double aX, double aSlope, double aShift)
-{
-    double tY = af_sigmoid_unsigned(aX, aSlope, aShift);
-    return (tY - 0.5) * 2.0;
-}
-
-inline double af_tanh(double aX, double aSlope, double aShift)
-{
-    return tanh(aX * aSlope);
-}
-
-inline double af_tanh_cubic(double aX, double aSlope, double aShift)
-{
-    return tanh(aX * aX * aX * aSlope);
-}
-
-inline double af_step_signed(double aX, double aShift)
-{
-    double tY;
-    if (aX > aShift)
-    {
-        tY = 1.0;
-    }
-    else
-    {
-        tY = -1.0;
-    }
-
-    return tY;
-}
-
-inline double af_step_unsigned(double aX, double aShift)
-{
-    if (aX > (0.5+aShift))
-    {
-        return 1.0;
-    }
-    else
-    {
-        return 0.0;
-    }
-}
-
-inline double af_gauss_signed(double aX, double aSlope, double aShift)
-{
-    double tY = exp( - aSlope * aX * aX + aShift); // TODO: Need separate a, b per activation function
-    return (tY-0.5)*2.0;
-}
-
-inline double af_gauss_unsigned(double aX, double aSlope, double aShift)
-{
-    return exp( - aSlope * aX * aX + aShift);
-}
-
-inline double af_abs(double aX, double aShift)
-{
-    return ((aX + aShift)< 0.0)? -(aX + aShift): (aX + aShift);
-}
-
-inline double af_sine_signed(double aX, double aFreq, double aShift)
-{
-    aFreq = 3.141592;
-    return sin(aX * aFreq + aShift);
-}
-
-inline double af_sine_unsigned(double aX, double aFreq, double aShift)
-{
-    double tY = sin((aX * aFreq + aShift) );
-    return (tY + 1.0) / 2.0;
-}
-
-
-inline double af_linear(double aX, double aShift)
-{
-    return (aX + aShift);
-}
-
-
-inline double af_relu(double aX)
-{
-    return (aX > 0)?aX:0;
-}
-
-
-inline double af_softplus(double aX)
-{
-    return log(1 + exp(aX));
-}
-
-
 double unsigned_sigmoid_derivative(double x)
 {
     return x * (1 - x);
@@ -166,13 +72,13 @@ NeuralNetwork::NeuralNetwork(bool a_Minimal)
         // build an XOR network
 
         // The input neurons are 3 // indexes 0 1 2
-        Neuron t_i1, t_i2, t_i3;
+        Neuron t_i1 = Neuron(), t_i2 = Neuron(), t_i3 = Neuron();
 
         // The output neuron       // index 3
-        Neuron t_o1;
+        Neuron t_o1 = Neuron();
 
         // The hidden neuron       // index 4
-        Neuron t_h1;
+        Neuron t_h1 = Neuron();
 
         m_neurons.push_back(t_i1);
         m_neurons.push_back(t_i2);
@@ -220,6 +126,11 @@ NeuralNetwork::NeuralNetwork(bool a_Minimal)
 
         m_num_inputs = 3;
         m_num_outputs = 1;
+        m_is_compiled = false;
+        m_is_optimized = false;
+        m_precision = DOUBLE_PRECISION;
+        m_accuracy = EXACT_ACTIVATION;
+        m_num_threads = 1;
 
         // Initialize the network's weights (make them random)
         for (unsigned int i = 0; i < m_connections.size(); i++)
@@ -244,6 +155,9 @@ NeuralNetwork::NeuralNetwork(bool a_Minimal)
         // an empty network
         m_num_inputs = m_num_outputs = 0;
         m_total_error = 0;
+        m_precision = DOUBLE_PRECISION;
+        m_accuracy = EXACT_ACTIVATION;
+        m_num_threads = 1;
         // clean up other neuron data as well
         for (unsigned int i = 0; i < m_neurons.size(); i++)
         {
@@ -261,6 +175,9 @@ NeuralNetwork::NeuralNetwork()
     // an empty network
     m_num_inputs = m_num_outputs = 0;
     m_total_error = 0;
+    m_precision = DOUBLE_PRECISION;
+    m_accuracy = EXACT_ACTIVATION;
+    m_num_threads = 1;
     // clean up other neuron data as well
     for (unsigned int i = 0; i < m_neurons.size(); i++)
     {
@@ -272,18 +189,69 @@ NeuralNetwork::NeuralNetwork()
     Clear();
 }
 
+// Orders the connections by target, then source, then index
+struct RTRLPairLess
+{
+    const std::vector<Connection>* m_connections;
+
+    bool operator()(unsigned int a, unsigned int b) const
+    {
+        const Connection& t_a = (*m_connections)[a];
+        const Connection& t_b = (*m_connections)[b];
+        if (t_a.m_target_neuron_idx != t_b.m_target_neuron_idx)
+            return t_a.m_target_neuron_idx < t_b.m_target_neuron_idx;
+        if (t_a.m_source_neuron_idx != t_b.m_source_neuron_idx)
+            return t_a.m_source_neuron_idx < t_b.m_source_neuron_idx;
+        return a < b;
+    }
+};
+
 void NeuralNetwork::InitRTRLMatrix()
 {
-    // Allocate memory for the neurons sensitivity matrices.
-    for (unsigned int i = 0; i < m_neurons.size(); i++)
+    unsigned int t_n = static_cast<unsigned int>(m_neurons.size());
+
+    // Build the connection index. Only the first connection of duplicate
+    // (target, source) pairs is trained.
+    std::vector<unsigned int> t_order;
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        if ((m_connections[i].m_target_neuron_idx >= m_num_inputs) &&
+            (m_connections[i].m_target_neuron_idx < t_n) &&
+            (m_connections[i].m_source_neuron_idx < t_n))
+        {
+            t_order.push_back(i);
+        }
+    }
+    RTRLPairLess t_less;
+    t_less.m_connections = &m_connections;
+    std::sort(t_order.begin(), t_order.end(), t_less);
+
+    m_rtrl_pairs.clear();
+    m_rtrl_row_start.assign(t_n + 1, 0);
+    for (unsigned int i = 0; i < t_order.size(); i++)
     {
-        m_neurons[i].m_sensitivity_matrix.resize(m_neurons.size()); // first dimention
-        for (unsigned int j = 0; j < m_neurons.size(); j++)
+        const Connection& t_c = m_connections[t_order[i]];
+        if (!m_rtrl_pairs.empty())
         {
-            m_neurons[i].m_sensitivity_matrix[j].resize(m_neurons.size()); // second dimention
+            const Connection& t_last = m_connections[m_rtrl_pairs.back()];
+            if ((t_last.m_target_neuron_idx == t_c.m_target_neuron_idx) &&
+                (t_last.m_source_neuron_idx == t_c.m_source_neuron_idx))
+            {
+                continue;
+            }
         }
+        m_rtrl_pairs.push_back(t_order[i]);
+        m_rtrl_row_start[t_c.m_target_neuron_idx + 1]++;
+    }
+    for (unsigned int i = 0; i < t_n; i++)
+    {
+        m_rtrl_row_start[i + 1] += m_rtrl_row_start[i];
     }
 
+    // Allocate memory for the sensitivities
+    size_t t_rows = (t_n > m_num_inputs) ? (t_n - m_num_inputs) : 0;
+    m_sensitivity.resize(t_rows * m_rtrl_pairs.size());
+
     // now clear it
     FlushCube();
     // clear out the other RTRL stuff as well
@@ -297,6 +265,15 @@ void NeuralNetwork::InitRTRLMatrix()
 
 void NeuralNetwork::ActivateFast()
 {
+    if (m_is_compiled)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.ActivateFast();
+        else
+            m_compiled.ActivateFast();
+        return;
+    }
+
     // Loop connections. Calculate each connection's output signal.
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
@@ -328,6 +305,15 @@ void NeuralNetwork::ActivateFast()
 
 void NeuralNetwork::Activate()
 {
+    if (m_is_compiled)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.Activate();
+        else
+            m_compiled.Activate();
+        return;
+    }
+
     // Loop connections. Calculate each connection's output signal.
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
@@ -408,6 +394,15 @@ void NeuralNetwork::Activate()
 
 void NeuralNetwork::ActivateUseInternalBias()
 {
+    if (m_is_compiled)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.ActivateUseInternalBias();
+        else
+            m_compiled.ActivateUseInternalBias();
+        return;
+    }
+
     // Loop connections. Calculate each connection's output signal.
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
@@ -487,6 +482,15 @@ void NeuralNetwork::ActivateUseInternalBias()
 
 void NeuralNetwork::ActivateLeaky(double a_dtime)
 {
+    if (m_is_compiled)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.ActivateLeaky(a_dtime);
+        else
+            m_compiled.ActivateLeaky(a_dtime);
+        return;
+    }
+
     // Loop connections. Calculate each connection's output signal.
     for (unsigned int i = 0; i < m_connections.size(); i++)
     {
@@ -574,6 +578,15 @@ void NeuralNetwork::ActivateLeaky(double a_dtime)
 
 void NeuralNetwork::Flush()
 {
+    if (m_is_compiled)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.Flush();
+        else
+            m_compiled.Flush();
+        return;
+    }
+
     for (unsigned int i = 0; i < m_neurons.size(); i++)
     {
         m_neurons[i].m_activation = 0;
@@ -584,23 +597,57 @@ void NeuralNetwork::Flush()
 
 void NeuralNetwork::FlushCube()
 {
-    // clear the cube
-    for (unsigned int i = 0; i < m_neurons.size(); i++)
-        for (unsigned int j = 0; j < m_neurons.size(); j++)
-            for (unsigned int k = 0; k < m_neurons.size(); k++)
-                m_neurons[k].m_sensitivity_matrix[i][j] = 0;
+    // clear the sensitivities
+    std::fill(m_sensitivity.begin(), m_sensitivity.end(), 0.0);
 }
 void NeuralNetwork::Input(std::vector<double>& a_Inputs)
 {
     if (a_Inputs.size() != m_num_inputs)
         throw std::exception();
 
-    for (unsigned int i = 0; i < a_Inputs.size(); i++)
+    if (!a_Inputs.empty())
+    {
+        InputFrom(&a_Inputs[0]);
+    }
+}
+
+// The inputs are the first neurons, and the first slots of the compiled network
+template <class T>
+void NeuralNetwork::InputFromArray(const T* a_Inputs)
+{
+    if (!m_is_compiled)
+    {
+        for (unsigned int i = 0; i < m_num_inputs; i++)
+        {
+            m_neurons[i].m_activation = a_Inputs[i];
+        }
+    }
+    else if (m_precision == SINGLE_PRECISION)
+    {
+        for (unsigned int i = 0; i < m_num_inputs; i++)
+        {
+            m_compiled_float.m_state.m_activation[i] = static_cast<float>(a_Inputs[i]);
+        }
+    }
+    else
     {
-        m_neurons[i].m_activation = a_Inputs[i];
+        for (unsigned int i = 0; i < m_num_inputs; i++)
+        {
+            m_compiled.m_state.m_activation[i] = a_Inputs[i];
+        }
     }
 }
 
+void NeuralNetwork::InputFrom(const double* a_Inputs)
+{
+    InputFromArray(a_Inputs);
+}
+
+void NeuralNetwork::InputFrom(const float* a_Inputs)
+{
+    InputFromArray(a_Inputs);
+}
+
 #ifdef USE_BOOST_PYTHON
 
 void NeuralNetwork::Input_python_list(py::list& a_Inputs)
@@ -619,7 +666,7 @@ void NeuralNetwork::Input_python_list(py::list& a_Inputs)
     Input(inp);
 }
 
-void NeuralNetwork::Input_numpy(py::numeric::array& a_Inputs)
+void NeuralNetwork::Input_state_python_list(NeuralNetworkState& a_State, py::list& a_Inputs) const
 {
     int len = py::len(a_Inputs);
     std::vector<double> inp;
@@ -627,231 +674,1494 @@ void NeuralNetwork::Input_numpy(py::numeric::array& a_Inputs)
     for(int i=0; i<len; i++)
         inp[i] = py::extract<double>(a_Inputs[i]);
 
-    // if the number of passed inputs differs from the actual number of inputs,
-    // clip them to fit.
+    // clip to fit, as Input() does
     if (inp.size() != m_num_inputs)
         inp.resize(m_num_inputs);
 
-    Input(inp);
+    Input(a_State, inp);
 }
 
-#endif
+void NeuralNetwork::RTRL_update_error_python_list(py::list& a_Targets)
+{
+    int len = py::len(a_Targets);
+    std::vector<double> t_targets(len);
+    for(int i=0; i<len; i++)
+        t_targets[i] = py::extract<double>(a_Targets[i]);
 
-std::vector<double> NeuralNetwork::Output()
+    RTRL_update_error(t_targets);
+}
+
+// Converts a list of lists to rows of a_Width values,
+// clipping them to fit like Input_python_list()
+static std::vector< std::vector<double> > ListToRows(py::list& a_List, unsigned int a_Width)
 {
-    std::vector<double> t_output;
-    for (int i = 0; i < m_num_outputs; i++)
+    int t_num_rows = py::len(a_List);
+    std::vector< std::vector<double> > t_rows(t_num_rows);
+    for(int s=0; s<t_num_rows; s++)
     {
-        t_output.push_back(m_neurons[i + m_num_inputs].m_activation);
+        py::list t_row = py::extract<py::list>(a_List[s]);
+        int len = py::len(t_row);
+        t_rows[s].resize(len);
+        for(int i=0; i<len; i++)
+            t_rows[s][i] = py::extract<double>(t_row[i]);
+
+        t_rows[s].resize(a_Width);
     }
-    return t_output;
+    return t_rows;
 }
 
-void NeuralNetwork::Adapt(Parameters& a_Parameters)
+py::list NeuralNetwork::ActivateBatch_python_list(py::list& a_Inputs, unsigned int a_Steps)
 {
-    // find max absolute magnitude of the weight
-    double t_max_weight = -999999999;
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    int t_num_samples = py::len(a_Inputs);
+    std::vector< std::vector<double> > t_inputs = ListToRows(a_Inputs, m_num_inputs);
+
+    std::vector< std::vector<double> > t_outputs;
+    ActivateBatch(t_inputs, t_outputs, a_Steps);
+
+    py::list t_result;
+    for(int s=0; s<t_num_samples; s++)
     {
-        if (abs(m_connections[i].m_weight) > t_max_weight)
-        {
-            t_max_weight = abs(m_connections[i].m_weight);
-        }
+        py::list t_sample;
+        for(unsigned int i=0; i<t_outputs[s].size(); i++)
+            t_sample.append(t_outputs[s][i]);
+        t_result.append(t_sample);
     }
+    return t_result;
+}
 
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+double NeuralNetwork::Backprop_python_list(py::list& a_Inputs, py::list& a_Targets, double a_LearningRate)
+{
+    return Backprop(ListToRows(a_Inputs, m_num_inputs), ListToRows(a_Targets, m_num_outputs), a_LearningRate);
+}
+
+double NeuralNetwork::BPTT_python_list(py::list& a_Inputs, py::list& a_Targets,
+                                       double a_LearningRate, unsigned int a_TruncationDepth)
+{
+    return BPTT(ListToRows(a_Inputs, m_num_inputs), ListToRows(a_Targets, m_num_outputs),
+                a_LearningRate, a_TruncationDepth);
+}
+
+// The buffer of a one-dimensional, C-contiguous float64 or float32 array
+// in native byte order, held for as long as this object exists.
+// IsValid() is false for any other object.
+class ArrayBuffer
+{
+    Py_buffer m_view;
+    bool m_valid;
+    char m_type;
+
+public:
+    ArrayBuffer(PyObject* a_Object, bool a_Writable)
     {
-        /////////////////////////////////////
-        // modify weight of that connection
-        ////
-        double t_incoming_neuron_activation =
-                m_neurons[m_connections[i].m_source_neuron_idx].m_activation;
-        double t_outgoing_neuron_activation =
-                m_neurons[m_connections[i].m_target_neuron_idx].m_activation;
-        if (m_connections[i].m_weight > 0) // positive weight
+        int t_flags = PyBUF_C_CONTIGUOUS | PyBUF_FORMAT | (a_Writable ? PyBUF_WRITABLE : 0);
+        m_valid = (PyObject_GetBuffer(a_Object, &m_view, t_flags) == 0);
+        if (!m_valid)
         {
-            double t_delta = (m_connections[i].m_hebb_rate
-                    * (t_max_weight - m_connections[i].m_weight)
-                    * t_incoming_neuron_activation
-                    * t_outgoing_neuron_activation)
-                    + m_connections[i].m_hebb_pre_rate * t_max_weight
-                            * t_incoming_neuron_activation
-                            * (t_outgoing_neuron_activation - 1.0);
-            m_connections[i].m_weight = (m_connections[i].m_weight + t_delta);
+            PyErr_Clear();
+            return;
         }
-        else if (m_connections[i].m_weight < 0) // negative weight
+
+        const char* t_format = m_view.format ? m_view.format : "B";
+        if ((*t_format == '@') || (*t_format == '='))
         {
-            // In the inhibatory case, we strengthen the synapse when output is low and
-            // input is high
-            double t_delta = m_connections[i].m_hebb_pre_rate
-                    * (t_max_weight - m_connections[i].m_weight)
-                    * t_incoming_neuron_activation
-                    * (1.0 - t_outgoing_neuron_activation)
-                    - m_connections[i].m_hebb_rate * t_max_weight
-                            * t_incoming_neuron_activation
-                            * t_outgoing_neuron_activation;
-            m_connections[i].m_weight = -(m_connections[i].m_weight + t_delta);
+            t_format++;
+        }
+        m_type = t_format[0];
+        if ((m_view.ndim != 1) || (t_format[1] != 0) ||
+            !(((m_type == 'd') && (m_view.itemsize == sizeof(double))) ||
+              ((m_type == 'f') && (m_view.itemsize == sizeof(float)))))
+        {
+            PyBuffer_Release(&m_view);
+            m_valid = false;
         }
-
-        Clamp(m_connections[i].m_weight, -a_Parameters.MaxWeight,
-                a_Parameters.MaxWeight);
     }
 
-}
-
-int NeuralNetwork::ConnectionExists(int a_to, int a_from)
-{
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    ~ArrayBuffer()
     {
-        if ((m_connections[i].m_source_neuron_idx == a_from)
-                && (m_connections[i].m_target_neuron_idx == a_to))
+        if (m_valid)
         {
-            return i;
+            PyBuffer_Release(&m_view);
         }
     }
 
-    return -1;
-}
+    bool IsValid() const { return m_valid; }
+    bool IsDouble() const { return m_type == 'd'; }
+    Py_ssize_t Size() const { return m_view.len / m_view.itemsize; }
+    void* Data() const { return m_view.buf; }
+};
 
-void NeuralNetwork::RTRL_update_gradients()
+void NeuralNetwork::Input_numpy(py::numeric::array& a_Inputs)
 {
-    // for every neuron
-    for (unsigned int k = m_num_inputs; k < m_neurons.size(); k++)
+    // Contiguous float arrays are read in place
+    ArrayBuffer t_buffer(a_Inputs.ptr(), false);
+    if (t_buffer.IsValid() && (t_buffer.Size() >= static_cast<Py_ssize_t>(m_num_inputs)))
     {
-        // for all possible connections
-        for (unsigned int i = m_num_inputs; i < m_neurons.size(); i++)
-            // to
-            for (unsigned int j = 0; j < m_neurons.size(); j++) // from
-            {
-                int t_idx = ConnectionExists(i, j);
-                if (t_idx != -1)
-                {
-                    //double t_derivative = unsigned_sigmoid_derivative( m_neurons[k].m_activation );
-                    double t_derivative = 0;
-                    if (m_neurons[k].m_activation_function_type
-                            == NEAT::UNSIGNED_SIGMOID)
-                    {
-                        t_derivative = unsigned_sigmoid_derivative(
-                                m_neurons[k].m_activation);
-                    }
-                    else if (m_neurons[k].m_activation_function_type
-                            == NEAT::TANH)
-                    {
-                        t_derivative = tanh_derivative(
-                                m_neurons[k].m_activation);
-                    }
-
-                    double t_sum = 0;
-                    // calculate the other sum
-                    for (unsigned int l = 0; l < m_neurons.size(); l++)
-                    {
-                        int t_l_idx = ConnectionExists(k, l);
-                        if (t_l_idx != -1)
-                        {
-                            t_sum += m_connections[t_l_idx].m_weight
-                                    * m_neurons[l].m_sensitivity_matrix[i][j];
-                        }
-                    }
-
-                    if (i == k)
-                    {
-                        t_sum += m_neurons[j].m_activation;
-                    }
-                    m_neurons[k].m_sensitivity_matrix[i][j] = t_derivative
-                            * t_sum;
-                }
-                else
-                {
-                    m_neurons[k].m_sensitivity_matrix[i][j] = 0;
-                }
-            }
-
+        if (t_buffer.IsDouble())
+            InputFrom(static_cast<const double*>(t_buffer.Data()));
+        else
+            InputFrom(static_cast<const float*>(t_buffer.Data()));
+        return;
     }
 
+    int len = py::len(a_Inputs);
+    std::vector<double> inp;
+    inp.resize(len);
+    for(int i=0; i<len; i++)
+        inp[i] = py::extract<double>(a_Inputs[i]);
+
+    // if the number of passed inputs differs from the actual number of inputs,
+    // clip them to fit.
+    if (inp.size() != m_num_inputs)
+        inp.resize(m_num_inputs);
+
+    Input(inp);
 }
 
-// please pay attention. notice here only one output is assumed
-void NeuralNetwork::RTRL_update_error(double a_target)
+void NeuralNetwork::OutputInto_numpy(py::numeric::array& a_Outputs) const
 {
-    // add to total error
-    m_total_error = (a_target - Output()[0]);
-    // adjust each weight
-    for (unsigned int i = 0; i < m_neurons.size(); i++) // to
+    if (py::len(a_Outputs) < static_cast<int>(m_num_outputs))
+        throw std::exception();
+
+    ArrayBuffer t_buffer(a_Outputs.ptr(), true);
+    if (t_buffer.IsValid())
     {
-        for (unsigned int j = 0; j < m_neurons.size(); j++) // from
-        {
-            int t_idx = ConnectionExists(i, j);
-            if (t_idx != -1)
-            {
-                // we know the first output's index is m_num_inputs
-                double t_delta = m_total_error
-                        * m_neurons[m_num_inputs].m_sensitivity_matrix[i][j];
-                m_total_weight_change[t_idx] += t_delta * LEARNING_RATE;
-            }
-        }
+        if (t_buffer.IsDouble())
+            OutputInto(static_cast<double*>(t_buffer.Data()));
+        else
+            OutputInto(static_cast<float*>(t_buffer.Data()));
+        return;
     }
-}
 
-void NeuralNetwork::RTRL_update_weights()
-{
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+    // Any other array is written one element at a time
+    std::vector<double> t_outputs(m_num_outputs + 1);
+    OutputInto(&t_outputs[0]);
+    for (unsigned int i = 0; i < m_num_outputs; i++)
     {
-        m_connections[i].m_weight += m_total_weight_change[i];
-        m_total_weight_change[i] = 0; // clear this out
+        a_Outputs[i] = t_outputs[i];
     }
-    m_total_error = 0;
 }
 
-void NeuralNetwork::Save(const char* a_filename)
+void ValuesIntoArray_numpy(const std::vector<double>& a_Values, py::numeric::array& a_Array)
 {
-    FILE* fil = fopen(a_filename, "w");
-    Save(fil);
-    fclose(fil);
-}
+    if (py::len(a_Array) < static_cast<int>(a_Values.size()))
+        throw std::exception();
 
-void NeuralNetwork::Save(FILE* a_file)
-{
-    fprintf(a_file, "NNstart\n");
-    // save num inputs/outputs and stuff
-    fprintf(a_file, "%d %d\n", m_num_inputs, m_num_outputs);
-    // save neurons
-    for (unsigned int i = 0; i < m_neurons.size(); i++)
+    ArrayBuffer t_buffer(a_Array.ptr(), true);
+    if (t_buffer.IsValid())
     {
-        // TYPE .. A .. B .. time_const .. bias .. activation_function_type .. split_y
-        fprintf(a_file, "neuron %d %3.18f %3.18f %3.18f %3.18f %d %3.18f\n",
-                static_cast<int>(m_neurons[i].m_type), m_neurons[i].m_a,
-                m_neurons[i].m_b, m_neurons[i].m_timeconst, m_neurons[i].m_bias,
-                static_cast<int>(m_neurons[i].m_activation_function_type),
-                m_neurons[i].m_split_y);
+        if (t_buffer.IsDouble())
+            std::copy(a_Values.begin(), a_Values.end(), static_cast<double*>(t_buffer.Data()));
+        else
+            std::copy(a_Values.begin(), a_Values.end(), static_cast<float*>(t_buffer.Data()));
+        return;
     }
-    // save connections
-    for (unsigned int i = 0; i < m_connections.size(); i++)
+
+    for (unsigned int i = 0; i < a_Values.size(); i++)
     {
-        // from .. to .. weight.. isrecur
-        fprintf(a_file, "connection %d %d %3.18f %d %3.18f %3.18f\n",
-                m_connections[i].m_source_neuron_idx,
-                m_connections[i].m_target_neuron_idx, m_connections[i].m_weight,
-                static_cast<int>(m_connections[i].m_recur_flag),
-                m_connections[i].m_hebb_rate, m_connections[i].m_hebb_pre_rate);
+        a_Array[i] = a_Values[i];
     }
-    // end
-    fprintf(a_file, "NNend\n\n");
 }
 
-bool NeuralNetwork::Load(std::ifstream& a_DataFile)
+std::vector<double> ArrayValues_numpy(py::numeric::array& a_Array, unsigned int a_Size)
 {
-    std::string t_str;
-    bool t_no_start = true, t_no_end = true;
+    if (py::len(a_Array) < static_cast<int>(a_Size))
+        throw std::exception();
 
-    if (!a_DataFile)
+    std::vector<double> t_values(a_Size);
+    ArrayBuffer t_buffer(a_Array.ptr(), false);
+    if (t_buffer.IsValid())
     {
-        ostringstream tStream;
-        tStream << "NN file error!" << std::endl;
-        //    throw NS::Exception(tStream.str());
+        if (t_buffer.IsDouble())
+        {
+            const double* t_data = static_cast<const double*>(t_buffer.Data());
+            std::copy(t_data, t_data + a_Size, t_values.begin());
+        }
+        else
+        {
+            const float* t_data = static_cast<const float*>(t_buffer.Data());
+            std::copy(t_data, t_data + a_Size, t_values.begin());
+        }
+        return t_values;
     }
 
-    // search for NNstart
-    do
+    for (unsigned int i = 0; i < a_Size; i++)
+    {
+        t_values[i] = py::extract<double>(a_Array[i]);
+    }
+    return t_values;
+}
+
+#endif
+
+std::vector<double> NeuralNetwork::Output()
+{
+    std::vector<double> t_output(m_num_outputs);
+    if (m_num_outputs > 0)
+    {
+        OutputInto(&t_output[0]);
+    }
+    return t_output;
+}
+
+template <class T>
+void NeuralNetwork::OutputToArray(T* a_Outputs) const
+{
+    if (!m_is_compiled)
+    {
+        for (unsigned int i = 0; i < m_num_outputs; i++)
+        {
+            a_Outputs[i] = static_cast<T>(m_neurons[i + m_num_inputs].m_activation);
+        }
+    }
+    else if (m_precision == SINGLE_PRECISION)
+    {
+        for (unsigned int i = 0; i < m_num_outputs; i++)
+        {
+            a_Outputs[i] = static_cast<T>(m_compiled_float.GetOutput(i));
+        }
+    }
+    else
+    {
+        for (unsigned int i = 0; i < m_num_outputs; i++)
+        {
+            a_Outputs[i] = static_cast<T>(m_compiled.GetOutput(i));
+        }
+    }
+}
+
+void NeuralNetwork::OutputInto(double* a_Outputs) const
+{
+    OutputToArray(a_Outputs);
+}
+
+void NeuralNetwork::OutputInto(float* a_Outputs) const
+{
+    OutputToArray(a_Outputs);
+}
+
+const double* NeuralNetwork::OutputPtr()
+{
+    m_outputs.resize(m_num_outputs);
+    if (m_num_outputs == 0)
+        return NULL;
+
+    OutputInto(&m_outputs[0]);
+    return &m_outputs[0];
+}
+
+// The a_Field of every neuron, to or from a_Values
+static void GetNeuronField(const std::vector<Neuron>& a_Neurons, double Neuron::*a_Field, double* a_Values)
+{
+    for (unsigned int i = 0; i < a_Neurons.size(); i++)
+    {
+        a_Values[i] = a_Neurons[i].*a_Field;
+    }
+}
+
+static void SetNeuronField(std::vector<Neuron>& a_Neurons, double Neuron::*a_Field, const double* a_Values)
+{
+    for (unsigned int i = 0; i < a_Neurons.size(); i++)
+    {
+        a_Neurons[i].*a_Field = a_Values[i];
+    }
+}
+
+void NeuralNetwork::GetWeights(double* a_Weights) const
+{
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        a_Weights[i] = m_connections[i].m_weight;
+    }
+}
+
+void NeuralNetwork::SetWeights(const double* a_Weights)
+{
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        m_connections[i].m_weight = a_Weights[i];
+    }
+    UpdateParameters();
+}
+
+void NeuralNetwork::GetBiases(double* a_Biases) const
+{
+    GetNeuronField(m_neurons, &Neuron::m_bias, a_Biases);
+}
+
+void NeuralNetwork::SetBiases(const double* a_Biases)
+{
+    SetNeuronField(m_neurons, &Neuron::m_bias, a_Biases);
+    UpdateParameters();
+}
+
+void NeuralNetwork::GetTimeConstants(double* a_TimeConstants) const
+{
+    GetNeuronField(m_neurons, &Neuron::m_timeconst, a_TimeConstants);
+}
+
+void NeuralNetwork::SetTimeConstants(const double* a_TimeConstants)
+{
+    SetNeuronField(m_neurons, &Neuron::m_timeconst, a_TimeConstants);
+    UpdateParameters();
+}
+
+void NeuralNetwork::GetActivationA(double* a_A) const
+{
+    GetNeuronField(m_neurons, &Neuron::m_a, a_A);
+}
+
+void NeuralNetwork::SetActivationA(const double* a_A)
+{
+    SetNeuronField(m_neurons, &Neuron::m_a, a_A);
+    UpdateParameters();
+}
+
+void NeuralNetwork::GetActivationB(double* a_B) const
+{
+    GetNeuronField(m_neurons, &Neuron::m_b, a_B);
+}
+
+void NeuralNetwork::SetActivationB(const double* a_B)
+{
+    SetNeuronField(m_neurons, &Neuron::m_b, a_B);
+    UpdateParameters();
+}
+
+void NeuralNetwork::ActivateTopological(unsigned int a_RecurrentIterations)
+{
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateTopological(a_RecurrentIterations);
+    else
+        m_compiled.ActivateTopological(a_RecurrentIterations);
+}
+
+void NeuralNetwork::ActivateDelta(double a_Epsilon)
+{
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateDelta(a_Epsilon);
+    else
+        m_compiled.ActivateDelta(a_Epsilon);
+}
+
+void NeuralNetwork::ActivateBatch(const std::vector< std::vector<double> >& a_Inputs,
+                                  std::vector< std::vector<double> >& a_Outputs,
+                                  unsigned int a_Steps)
+{
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+
+    unsigned int t_num_samples = static_cast<unsigned int>(a_Inputs.size());
+    std::vector<double> t_inputs(t_num_samples * m_num_inputs);
+    for (unsigned int s = 0; s < t_num_samples; s++)
+    {
+        if (a_Inputs[s].size() != m_num_inputs)
+            throw std::exception();
+
+        std::copy(a_Inputs[s].begin(), a_Inputs[s].end(), t_inputs.begin() + s * m_num_inputs);
+    }
+
+    std::vector<double> t_outputs(t_num_samples * m_num_outputs);
+    if (t_num_samples > 0)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            m_compiled_float.ActivateBatch(m_num_inputs ? &t_inputs[0] : NULL,
+                                           m_num_outputs ? &t_outputs[0] : NULL,
+                                           t_num_samples, a_Steps);
+        else
+            m_compiled.ActivateBatch(m_num_inputs ? &t_inputs[0] : NULL,
+                                     m_num_outputs ? &t_outputs[0] : NULL,
+                                     t_num_samples, a_Steps);
+    }
+
+    a_Outputs.resize(t_num_samples);
+    for (unsigned int s = 0; s < t_num_samples; s++)
+    {
+        a_Outputs[s].assign(t_outputs.begin() + s * m_num_outputs, t_outputs.begin() + (s + 1) * m_num_outputs);
+    }
+}
+
+bool NeuralNetwork::IsAcyclic() const
+{
+    if (m_is_compiled)
+    {
+        return (m_precision == SINGLE_PRECISION) ? m_compiled_float.IsAcyclic() : m_compiled.IsAcyclic();
+    }
+
+    CompiledNetwork t_compiled;
+    t_compiled.Build(m_neurons, m_connections, m_num_inputs, m_num_outputs);
+    return t_compiled.IsAcyclic();
+}
+
+unsigned int NeuralNetwork::SettlingDepth() const
+{
+    if (m_is_compiled)
+    {
+        return (m_precision == SINGLE_PRECISION) ? m_compiled_float.SettlingDepth() : m_compiled.SettlingDepth();
+    }
+
+    CompiledNetwork t_compiled;
+    t_compiled.Build(m_neurons, m_connections, m_num_inputs, m_num_outputs);
+    return t_compiled.SettlingDepth();
+}
+
+// Copies the rows of a_Rows, each of a_Width values, into a_Flat
+static void FlattenRows(const std::vector< std::vector<double> >& a_Rows, unsigned int a_Width,
+                        std::vector<double>& a_Flat)
+{
+    a_Flat.resize(a_Rows.size() * a_Width + 1);
+    for (unsigned int s = 0; s < a_Rows.size(); s++)
+    {
+        if (a_Rows[s].size() != a_Width)
+            throw std::exception();
+
+        std::copy(a_Rows[s].begin(), a_Rows[s].end(), a_Flat.begin() + s * a_Width);
+    }
+}
+
+double NeuralNetwork::Backprop(const std::vector< std::vector<double> >& a_Inputs,
+                               const std::vector< std::vector<double> >& a_Targets,
+                               double a_LearningRate)
+{
+    if (a_Inputs.size() != a_Targets.size())
+        throw std::exception();
+
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+
+    std::vector<double> t_inputs, t_targets;
+    FlattenRows(a_Inputs, m_num_inputs, t_inputs);
+    FlattenRows(a_Targets, m_num_outputs, t_targets);
+
+    unsigned int t_num_samples = static_cast<unsigned int>(a_Inputs.size());
+    if (m_precision == SINGLE_PRECISION)
+    {
+        if (!m_compiled_float.IsAcyclic())
+            throw std::exception();
+
+        return m_compiled_float.Backprop(&t_inputs[0], &t_targets[0], t_num_samples,
+                                         a_LearningRate, m_connections);
+    }
+
+    if (!m_compiled.IsAcyclic())
+        throw std::exception();
+
+    return m_compiled.Backprop(&t_inputs[0], &t_targets[0], t_num_samples,
+                               a_LearningRate, m_connections);
+}
+
+double NeuralNetwork::BPTT(const std::vector< std::vector<double> >& a_Inputs,
+                           const std::vector< std::vector<double> >& a_Targets,
+                           double a_LearningRate, unsigned int a_TruncationDepth)
+{
+    if (a_Inputs.size() != a_Targets.size())
+        throw std::exception();
+
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+
+    std::vector<double> t_inputs, t_targets;
+    FlattenRows(a_Inputs, m_num_inputs, t_inputs);
+    FlattenRows(a_Targets, m_num_outputs, t_targets);
+
+    unsigned int t_num_samples = static_cast<unsigned int>(a_Inputs.size());
+    if (m_precision == SINGLE_PRECISION)
+        return m_compiled_float.BPTT(&t_inputs[0], &t_targets[0], t_num_samples,
+                                     a_LearningRate, a_TruncationDepth, m_connections);
+
+    return m_compiled.BPTT(&t_inputs[0], &t_targets[0], t_num_samples,
+                           a_LearningRate, a_TruncationDepth, m_connections);
+}
+
+void NeuralNetwork::Compile()
+{
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.Build(m_neurons, m_connections, m_num_inputs, m_num_outputs, m_accuracy);
+    else
+        m_compiled.Build(m_neurons, m_connections, m_num_inputs, m_num_outputs, m_accuracy);
+    m_compiled.m_num_threads = m_compiled_float.m_num_threads = m_num_threads;
+    m_is_compiled = true;
+}
+
+void NeuralNetwork::CheckState(const NeuralNetworkState& a_State) const
+{
+    bool t_valid = m_is_compiled &&
+                   ((m_precision == SINGLE_PRECISION) ? m_compiled_float.IsStateOf(a_State.m_state_float)
+                                                      : m_compiled.IsStateOf(a_State.m_state));
+    if (!t_valid)
+        throw std::exception();
+}
+
+NeuralNetworkState NeuralNetwork::NewState() const
+{
+    if (!m_is_compiled)
+        throw std::exception();
+
+    NeuralNetworkState t_state;
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.NewState(t_state.m_state_float);
+    else
+        m_compiled.NewState(t_state.m_state);
+    return t_state;
+}
+
+NeuralNetworkState NeuralNetwork::CloneState() const
+{
+    if (!m_is_compiled)
+        throw std::exception();
+
+    NeuralNetworkState t_state;
+    if (m_precision == SINGLE_PRECISION)
+        t_state.m_state_float = m_compiled_float.m_state;
+    else
+        t_state.m_state = m_compiled.m_state;
+    return t_state;
+}
+
+void NeuralNetwork::RestoreState(const NeuralNetworkState& a_State)
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.m_state = a_State.m_state_float;
+    else
+        m_compiled.m_state = a_State.m_state;
+}
+
+void NeuralNetwork::Input(NeuralNetworkState& a_State, const std::vector<double>& a_Inputs) const
+{
+    CheckState(a_State);
+    if (a_Inputs.size() != m_num_inputs)
+        throw std::exception();
+
+    if (a_Inputs.empty())
+        return;
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.Input(a_State.m_state_float, &a_Inputs[0]);
+    else
+        m_compiled.Input(a_State.m_state, &a_Inputs[0]);
+}
+
+void NeuralNetwork::Activate(NeuralNetworkState& a_State) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.Activate(a_State.m_state_float);
+    else
+        m_compiled.Activate(a_State.m_state);
+}
+
+void NeuralNetwork::ActivateUseInternalBias(NeuralNetworkState& a_State) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateUseInternalBias(a_State.m_state_float);
+    else
+        m_compiled.ActivateUseInternalBias(a_State.m_state);
+}
+
+void NeuralNetwork::ActivateLeaky(NeuralNetworkState& a_State, double a_Step) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateLeaky(a_State.m_state_float, a_Step);
+    else
+        m_compiled.ActivateLeaky(a_State.m_state, a_Step);
+}
+
+void NeuralNetwork::ActivateTopological(NeuralNetworkState& a_State, unsigned int a_RecurrentIterations) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateTopological(a_State.m_state_float, a_RecurrentIterations);
+    else
+        m_compiled.ActivateTopological(a_State.m_state, a_RecurrentIterations);
+}
+
+void NeuralNetwork::ActivateDelta(NeuralNetworkState& a_State, double a_Epsilon) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.ActivateDelta(a_State.m_state_float, a_Epsilon);
+    else
+        m_compiled.ActivateDelta(a_State.m_state, a_Epsilon);
+}
+
+void NeuralNetwork::Flush(NeuralNetworkState& a_State) const
+{
+    CheckState(a_State);
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.Flush(a_State.m_state_float);
+    else
+        m_compiled.Flush(a_State.m_state);
+}
+
+std::vector<double> NeuralNetwork::Output(const NeuralNetworkState& a_State) const
+{
+    std::vector<double> t_outputs(m_num_outputs);
+    if (m_num_outputs > 0)
+        OutputInto(a_State, &t_outputs[0]);
+    else
+        CheckState(a_State);
+    return t_outputs;
+}
+
+void NeuralNetwork::OutputInto(const NeuralNetworkState& a_State, double* a_Outputs) const
+{
+    CheckState(a_State);
+    for (unsigned int i = 0; i < m_num_outputs; i++)
+    {
+        if (m_precision == SINGLE_PRECISION)
+            a_Outputs[i] = m_compiled_float.GetOutput(a_State.m_state_float, i);
+        else
+            a_Outputs[i] = m_compiled.GetOutput(a_State.m_state, i);
+    }
+}
+
+void NeuralNetwork::UpdateParameters()
+{
+    if (!m_is_compiled)
+        return;
+
+    if (m_precision == SINGLE_PRECISION)
+        m_compiled_float.UpdateParameters(m_neurons, m_connections);
+    else
+        m_compiled.UpdateParameters(m_neurons, m_connections);
+}
+
+void NeuralNetwork::Decompile()
+{
+    if (!m_is_compiled)
+        return;
+
+    for (unsigned int i = 0; i < m_neurons.size(); i++)
+    {
+        if (m_precision == SINGLE_PRECISION)
+        {
+            m_neurons[i].m_activation = m_compiled_float.GetActivation(i);
+            m_neurons[i].m_membrane_potential = m_compiled_float.GetMembranePotential(i);
+        }
+        else
+        {
+            m_neurons[i].m_activation = m_compiled.GetActivation(i);
+            m_neurons[i].m_membrane_potential = m_compiled.GetMembranePotential(i);
+        }
+    }
+    m_compiled.Clear();
+    m_compiled_float.Clear();
+    m_is_compiled = false;
+}
+
+void NeuralNetwork::SetPrecision(Precision a_Precision)
+{
+    if (a_Precision == m_precision)
+        return;
+
+    bool t_was_compiled = m_is_compiled;
+    Decompile();
+    m_precision = a_Precision;
+    if (t_was_compiled)
+    {
+        Compile();
+    }
+}
+
+void NeuralNetwork::SetNumThreads(unsigned int a_NumThreads)
+{
+    if (a_NumThreads == 0)
+    {
+        a_NumThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    }
+    m_num_threads = a_NumThreads;
+    m_compiled.m_num_threads = m_compiled_float.m_num_threads = m_num_threads;
+}
+
+ActivationBackend NeuralNetwork::GetBackend() const
+{
+    if (!m_is_compiled)
+        return INTERPRETED_BACKEND;
+
+    return (m_precision == SINGLE_PRECISION) ? m_compiled_float.Backend() : m_compiled.Backend();
+}
+
+ActivationBackend NeuralNetwork::SelectBackend()
+{
+    SetNumThreads((m_connections.size() >= BackendProfile::Active().m_parallel_min_connections) ? 0 : 1);
+    if (!m_is_compiled)
+    {
+        Compile();
+    }
+    return GetBackend();
+}
+
+void NeuralNetwork::SetActivationAccuracy(ActivationAccuracy a_Accuracy)
+{
+    if (a_Accuracy == m_accuracy)
+        return;
+
+    bool t_was_compiled = m_is_compiled;
+    Decompile();
+    m_accuracy = a_Accuracy;
+    if (t_was_compiled)
+    {
+        Compile();
+    }
+}
+
+OptimizationReport NeuralNetwork::Optimize(double a_WeightEpsilon, double a_BiasValue,
+                                           bool a_UseInternalBias)
+{
+    OptimizationReport t_report;
+    bool t_was_compiled = m_is_compiled;
+    Decompile();
+
+    // the RTRL data (and the connection index) refers to the old connections,
+    // and they no longer match the genes
+    m_neuron_gene_ids.clear();
+    m_link_gene_ids.clear();
+    m_is_optimized = true;
+    m_total_weight_change.clear();
+    m_sensitivity.clear();
+    m_rtrl_pairs.clear();
+    m_rtrl_row_start.clear();
+
+    unsigned int t_num_neurons = m_neurons.size();
+    unsigned int t_first_hidden = m_num_inputs + m_num_outputs;
+
+    // the side tables in use follow the neurons and connections kept
+    MatchSideTables();
+    bool t_has_learning = !m_connection_learning.empty();
+    std::vector<ConnectionLearning> t_kept_learning;
+
+    // the small weights
+    std::vector<Connection> t_kept;
+    t_kept.reserve(m_connections.size());
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        if (std::fabs(m_connections[i].m_weight) <= a_WeightEpsilon)
+        {
+            t_report.m_small_connections++;
+            continue;
+        }
+        t_kept.push_back(m_connections[i]);
+        if (t_has_learning)
+            t_kept_learning.push_back(m_connection_learning[i]);
+    }
+    m_connections.swap(t_kept);
+    m_connection_learning.swap(t_kept_learning);
+
+    // the constant neurons
+    int t_bias_input = -1;
+    for (unsigned int i = 0; i < m_num_inputs; i++)
+    {
+        if (m_neurons[i].m_type == BIAS)
+        {
+            t_bias_input = i;
+            break;
+        }
+    }
+
+    std::vector<bool> t_folded(t_num_neurons, false);
+    if (a_UseInternalBias || ((t_bias_input >= 0) && (a_BiasValue != 0)))
+    {
+        // A neuron becomes constant once all its sources are. Those in a
+        // cycle never do, their values could change at every step.
+        std::vector<unsigned int> t_out_start(t_num_neurons + 1, 0);
+        std::vector<unsigned int> t_out(m_connections.size());
+        std::vector<unsigned int> t_pending(t_num_neurons, 0);
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            t_out_start[m_connections[i].m_source_neuron_idx + 1]++;
+            t_pending[m_connections[i].m_target_neuron_idx]++;
+        }
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            t_out_start[i + 1] += t_out_start[i];
+        }
+        std::vector<unsigned int> t_fill(t_out_start.begin(), t_out_start.end() - 1);
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            t_out[t_fill[m_connections[i].m_source_neuron_idx]++] = i;
+        }
+
+        std::vector<double> t_sum(t_num_neurons, 0.0);
+        std::vector<double> t_value(t_num_neurons, 0.0);
+        std::vector<unsigned int> t_ready;
+        if (t_bias_input >= 0)
+        {
+            t_value[t_bias_input] = a_BiasValue;
+            t_ready.push_back(t_bias_input);
+        }
+        for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+        {
+            if (t_pending[i] == 0)
+                t_ready.push_back(i);
+        }
+
+        // A folded constant reaches its targets sooner than it did, and a
+        // cycle would keep what it got meanwhile for good. So the neurons
+        // that lead into a cycle are not folded: those are the ones left
+        // after taking away, over and over, the neurons with no targets left.
+        std::vector<unsigned int> t_in_start(t_num_neurons + 1, 0);
+        std::vector<unsigned int> t_in(m_connections.size());
+        std::vector<unsigned int> t_targets_left(t_num_neurons, 0);
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            // the inputs ignore their connections
+            if (m_connections[i].m_target_neuron_idx < m_num_inputs)
+                continue;
+            t_in_start[m_connections[i].m_target_neuron_idx + 1]++;
+            t_targets_left[m_connections[i].m_source_neuron_idx]++;
+        }
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            t_in_start[i + 1] += t_in_start[i];
+        }
+        std::vector<unsigned int> t_in_fill(t_in_start.begin(), t_in_start.end() - 1);
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            if (m_connections[i].m_target_neuron_idx >= m_num_inputs)
+                t_in[t_in_fill[m_connections[i].m_target_neuron_idx]++] = m_connections[i].m_source_neuron_idx;
+        }
+
+        std::vector<bool> t_leads_to_cycle(t_num_neurons, true);
+        std::vector<unsigned int> t_ends;
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            if (t_targets_left[i] == 0)
+                t_ends.push_back(i);
+        }
+        while (!t_ends.empty())
+        {
+            unsigned int t_k = t_ends.back();
+            t_ends.pop_back();
+            t_leads_to_cycle[t_k] = false;
+            for (unsigned int j = t_in_start[t_k]; j < t_in_start[t_k + 1]; j++)
+            {
+                if (--t_targets_left[t_in[j]] == 0)
+                    t_ends.push_back(t_in[j]);
+            }
+        }
+
+        std::vector<bool> t_constant(t_num_neurons, false);
+        while (!t_ready.empty())
+        {
+            unsigned int t_k = t_ready.back();
+            t_ready.pop_back();
+
+            if (t_k >= m_num_inputs)
+            {
+                const Neuron& t_n = m_neurons[t_k];
+                double t_x = t_sum[t_k] + (a_UseInternalBias ? t_n.m_bias : 0.0);
+                t_value[t_k] = af_apply(t_n.m_activation_function_type, t_x, t_n.m_a, t_n.m_b);
+            }
+            t_constant[t_k] = true;
+            t_folded[t_k] = (t_k >= t_first_hidden) && !t_leads_to_cycle[t_k];
+
+            for (unsigned int j = t_out_start[t_k]; j < t_out_start[t_k + 1]; j++)
+            {
+                const Connection& t_c = m_connections[t_out[j]];
+                unsigned int t_target = t_c.m_target_neuron_idx;
+                t_sum[t_target] += t_c.m_weight * t_value[t_k];
+                if ((--t_pending[t_target] == 0) && (t_target >= m_num_inputs))
+                    t_ready.push_back(t_target);
+            }
+        }
+
+        // what the folded neurons add to the others
+        std::vector<double> t_constant_input(t_num_neurons, 0.0);
+        t_kept.clear();
+        t_kept_learning.clear();
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            const Connection& t_c = m_connections[i];
+            if (!t_folded[t_c.m_source_neuron_idx])
+            {
+                t_kept.push_back(t_c);
+                if (t_has_learning)
+                    t_kept_learning.push_back(m_connection_learning[i]);
+                continue;
+            }
+            if (!t_folded[t_c.m_target_neuron_idx])
+                t_constant_input[t_c.m_target_neuron_idx] += t_c.m_weight * t_value[t_c.m_source_neuron_idx];
+            t_report.m_folded_connections++;
+        }
+        m_connections.swap(t_kept);
+        m_connection_learning.swap(t_kept_learning);
+
+        for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+        {
+            if (t_folded[i])
+                t_report.m_folded_neurons++;
+            if (t_folded[i] || (t_constant_input[i] == 0))
+                continue;
+
+            if (a_UseInternalBias)
+            {
+                m_neurons[i].m_bias += t_constant_input[i];
+                continue;
+            }
+
+            double t_weight = t_constant_input[i] / a_BiasValue;
+            int t_idx = ConnectionExists(i, t_bias_input);
+            if (t_idx >= 0)
+            {
+                m_connections[t_idx].m_weight += t_weight;
+            }
+            else
+            {
+                Connection t_c;
+                t_c.m_source_neuron_idx = t_bias_input;
+                t_c.m_target_neuron_idx = i;
+                t_c.m_weight = t_weight;
+                t_c.m_signal = 0;
+                m_connections.push_back(t_c);
+                if (t_has_learning)
+                    m_connection_learning.push_back(ConnectionLearning());
+                t_report.m_added_connections++;
+            }
+        }
+    }
+
+    // the neurons that reach an output, found backwards from the outputs
+    std::vector<unsigned int> t_in_start(t_num_neurons + 1, 0);
+    std::vector<unsigned int> t_in(m_connections.size());
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        t_in_start[m_connections[i].m_target_neuron_idx + 1]++;
+    }
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_in_start[i + 1] += t_in_start[i];
+    }
+    std::vector<unsigned int> t_fill(t_in_start.begin(), t_in_start.end() - 1);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        t_in[t_fill[m_connections[i].m_target_neuron_idx]++] = m_connections[i].m_source_neuron_idx;
+    }
+
+    std::vector<bool> t_alive(t_num_neurons, false);
+    std::vector<unsigned int> t_stack;
+    for (unsigned int i = 0; (i < t_first_hidden) && (i < t_num_neurons); i++)
+    {
+        t_alive[i] = true;
+        if (i >= m_num_inputs)
+            t_stack.push_back(i);
+    }
+    while (!t_stack.empty())
+    {
+        unsigned int t_k = t_stack.back();
+        t_stack.pop_back();
+        for (unsigned int j = t_in_start[t_k]; j < t_in_start[t_k + 1]; j++)
+        {
+            if (!t_alive[t_in[j]])
+            {
+                t_alive[t_in[j]] = true;
+                t_stack.push_back(t_in[j]);
+            }
+        }
+    }
+
+    // renumber what is left
+    std::vector<int> t_new_idx(t_num_neurons, -1);
+    std::vector<Neuron> t_neurons;
+    std::vector<NeuronLayout> t_layout;
+    t_neurons.reserve(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        if (t_alive[i] && !t_folded[i])
+        {
+            t_new_idx[i] = t_neurons.size();
+            t_neurons.push_back(m_neurons[i]);
+            if (!m_neuron_layout.empty())
+                t_layout.push_back(m_neuron_layout[i]);
+        }
+        else if (!t_folded[i])
+        {
+            t_report.m_dead_neurons++;
+        }
+    }
+    m_neurons.swap(t_neurons);
+    m_neuron_layout.swap(t_layout);
+
+    t_kept.clear();
+    t_kept_learning.clear();
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        Connection t_c = m_connections[i];
+        int t_source = t_new_idx[t_c.m_source_neuron_idx];
+        int t_target = t_new_idx[t_c.m_target_neuron_idx];
+        if ((t_source < 0) || (t_target < 0) || (t_c.m_target_neuron_idx < m_num_inputs))
+        {
+            t_report.m_dead_connections++;
+            continue;
+        }
+        t_c.m_source_neuron_idx = t_source;
+        t_c.m_target_neuron_idx = t_target;
+        t_kept.push_back(t_c);
+        if (t_has_learning)
+            t_kept_learning.push_back(m_connection_learning[i]);
+    }
+    m_connections.swap(t_kept);
+    m_connection_learning.swap(t_kept_learning);
+
+    if (t_was_compiled)
+    {
+        Compile();
+    }
+
+    return t_report;
+}
+
+void NeuralNetwork::ReorderHiddenNeurons()
+{
+    unsigned int t_num_neurons = m_neurons.size();
+    unsigned int t_first_hidden = m_num_inputs + m_num_outputs;
+    if (t_num_neurons <= t_first_hidden + 1)
+        return;
+
+    bool t_was_compiled = m_is_compiled;
+    Decompile();
+
+    // the RTRL data refers to the old indices
+    m_total_weight_change.clear();
+    m_sensitivity.clear();
+    m_rtrl_pairs.clear();
+    m_rtrl_row_start.clear();
+    MatchSideTables();
+
+    // the outgoing connections of every neuron
+    std::vector<unsigned int> t_out_start(t_num_neurons + 1, 0);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        t_out_start[m_connections[i].m_source_neuron_idx + 1]++;
+    }
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_out_start[i + 1] += t_out_start[i];
+    }
+    std::vector<unsigned int> t_out(m_connections.size());
+    std::vector<unsigned int> t_fill(t_out_start.begin(), t_out_start.end() - 1);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        t_out[t_fill[m_connections[i].m_source_neuron_idx]++] = m_connections[i].m_target_neuron_idx;
+    }
+
+    // breadth-first from the inputs, then from the outputs and from any
+    // hidden neurons not reached yet, numbering the hidden neurons as found
+    std::vector<int> t_new_idx(t_num_neurons, -1);
+    std::vector<bool> t_seen(t_num_neurons, false);
+    std::vector<unsigned int> t_queue;
+    t_queue.reserve(t_num_neurons);
+    unsigned int t_next_idx = t_first_hidden;
+    unsigned int t_head = 0;
+    for (unsigned int t_seed = 0; t_seed < t_num_neurons; t_seed++)
+    {
+        if (t_seen[t_seed])
+            continue;
+
+        // all the inputs start together
+        unsigned int t_seed_end = (t_seed < m_num_inputs) ? m_num_inputs : (t_seed + 1);
+        for (unsigned int i = t_seed; i < t_seed_end; i++)
+        {
+            t_seen[i] = true;
+            t_queue.push_back(i);
+            if (i >= t_first_hidden)
+                t_new_idx[i] = t_next_idx++;
+        }
+
+        for (; t_head < t_queue.size(); t_head++)
+        {
+            unsigned int t_k = t_queue[t_head];
+            for (unsigned int j = t_out_start[t_k]; j < t_out_start[t_k + 1]; j++)
+            {
+                unsigned int t_target = t_out[j];
+                if (t_seen[t_target])
+                    continue;
+                t_seen[t_target] = true;
+                t_queue.push_back(t_target);
+                if (t_target >= t_first_hidden)
+                    t_new_idx[t_target] = t_next_idx++;
+            }
+        }
+    }
+    for (unsigned int i = 0; i < t_first_hidden; i++)
+    {
+        t_new_idx[i] = i;
+    }
+
+    std::vector<Neuron> t_neurons(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        t_neurons[t_new_idx[i]] = m_neurons[i];
+    }
+    m_neurons.swap(t_neurons);
+
+    if (m_neuron_gene_ids.size() == t_num_neurons)
+    {
+        std::vector<unsigned int> t_ids(t_num_neurons);
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            t_ids[t_new_idx[i]] = m_neuron_gene_ids[i];
+        }
+        m_neuron_gene_ids.swap(t_ids);
+    }
+
+    if (!m_neuron_layout.empty())
+    {
+        std::vector<NeuronLayout> t_layout(t_num_neurons);
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            std::swap(t_layout[t_new_idx[i]], m_neuron_layout[i]);
+        }
+        m_neuron_layout.swap(t_layout);
+    }
+
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        m_connections[i].m_source_neuron_idx = t_new_idx[m_connections[i].m_source_neuron_idx];
+        m_connections[i].m_target_neuron_idx = t_new_idx[m_connections[i].m_target_neuron_idx];
+    }
+
+    if (t_was_compiled)
+    {
+        Compile();
+    }
+}
+
+void NeuralNetwork::Adapt(Parameters& a_Parameters)
+{
+    Decompile();
+
+    // find max absolute magnitude of the weight
+    double t_max_weight = -999999999;
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        if (abs(m_connections[i].m_weight) > t_max_weight)
+        {
+            t_max_weight = abs(m_connections[i].m_weight);
+        }
+    }
+
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        /////////////////////////////////////
+        // modify weight of that connection
+        ////
+        double t_incoming_neuron_activation =
+                m_neurons[m_connections[i].m_source_neuron_idx].m_activation;
+        double t_outgoing_neuron_activation =
+                m_neurons[m_connections[i].m_target_neuron_idx].m_activation;
+        const ConnectionLearning& t_l = GetConnectionLearning(i);
+        if (m_connections[i].m_weight > 0) // positive weight
+        {
+            double t_delta = (t_l.m_hebb_rate
+                    * (t_max_weight - m_connections[i].m_weight)
+                    * t_incoming_neuron_activation
+                    * t_outgoing_neuron_activation)
+                    + t_l.m_hebb_pre_rate * t_max_weight
+                            * t_incoming_neuron_activation
+                            * (t_outgoing_neuron_activation - 1.0);
+            m_connections[i].m_weight = (m_connections[i].m_weight + t_delta);
+        }
+        else if (m_connections[i].m_weight < 0) // negative weight
+        {
+            // In the inhibatory case, we strengthen the synapse when output is low and
+            // input is high
+            double t_delta = t_l.m_hebb_pre_rate
+                    * (t_max_weight - m_connections[i].m_weight)
+                    * t_incoming_neuron_activation
+                    * (1.0 - t_outgoing_neuron_activation)
+                    - t_l.m_hebb_rate * t_max_weight
+                            * t_incoming_neuron_activation
+                            * t_outgoing_neuron_activation;
+            m_connections[i].m_weight = -(m_connections[i].m_weight + t_delta);
+        }
+
+        Clamp(m_connections[i].m_weight, -a_Parameters.MaxWeight,
+                a_Parameters.MaxWeight);
+    }
+
+}
+
+int NeuralNetwork::ConnectionExists(int a_to, int a_from)
+{
+    // negative indices become too large to match any neuron
+    unsigned int t_to = static_cast<unsigned int>(a_to);
+    unsigned int t_from = static_cast<unsigned int>(a_from);
+
+    // look it up in the connection index, if there is one
+    if ((m_rtrl_row_start.size() == m_neurons.size() + 1) && (t_to < m_neurons.size()))
+    {
+        unsigned int t_lo = m_rtrl_row_start[t_to], t_hi = m_rtrl_row_start[t_to + 1];
+        while (t_lo < t_hi)
+        {
+            unsigned int t_mid = (t_lo + t_hi) / 2;
+            unsigned int t_source = m_connections[m_rtrl_pairs[t_mid]].m_source_neuron_idx;
+            if (t_source == t_from)
+                return static_cast<int>(m_rtrl_pairs[t_mid]);
+            if (t_source < t_from)
+                t_lo = t_mid + 1;
+            else
+                t_hi = t_mid;
+        }
+        if (t_to >= m_num_inputs)
+            return -1;
+    }
+
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        if ((m_connections[i].m_source_neuron_idx == t_from)
+                && (m_connections[i].m_target_neuron_idx == t_to))
+        {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void NeuralNetwork::AddNeuron(const Neuron& a_n, const NeuronLayout& a_l)
+{
+    m_neuron_layout.resize(m_neurons.size());
+    m_neurons.push_back(a_n);
+    m_neuron_layout.push_back(a_l);
+}
+
+void NeuralNetwork::AddConnection(const Connection& a_c, const ConnectionLearning& a_l)
+{
+    m_connection_learning.resize(m_connections.size());
+    m_connections.push_back(a_c);
+    m_connection_learning.push_back(a_l);
+}
+
+const NeuronLayout& NeuralNetwork::GetNeuronLayout(unsigned int a_idx) const
+{
+    static const NeuronLayout t_default;
+    return (a_idx < m_neuron_layout.size()) ? m_neuron_layout[a_idx] : t_default;
+}
+
+NeuronLayout& NeuralNetwork::NeuronLayoutAt(unsigned int a_idx)
+{
+    if (m_neuron_layout.size() < m_neurons.size())
+        m_neuron_layout.resize(m_neurons.size());
+    return m_neuron_layout[a_idx];
+}
+
+const ConnectionLearning& NeuralNetwork::GetConnectionLearning(unsigned int a_idx) const
+{
+    static const ConnectionLearning t_default;
+    return (a_idx < m_connection_learning.size()) ? m_connection_learning[a_idx] : t_default;
+}
+
+ConnectionLearning& NeuralNetwork::ConnectionLearningAt(unsigned int a_idx)
+{
+    if (m_connection_learning.size() < m_connections.size())
+        m_connection_learning.resize(m_connections.size());
+    return m_connection_learning[a_idx];
+}
+
+void NeuralNetwork::MatchSideTables()
+{
+    if (!m_neuron_layout.empty())
+        m_neuron_layout.resize(m_neurons.size());
+    if (!m_connection_learning.empty())
+        m_connection_learning.resize(m_connections.size());
+}
+
+void NeuralNetwork::RTRL_update_gradients()
+{
+    Decompile();
+
+    if (m_rtrl_row_start.size() != m_neurons.size() + 1)
+    {
+        InitRTRLMatrix();
+    }
+
+    unsigned int t_num_pairs = static_cast<unsigned int>(m_rtrl_pairs.size());
+    std::vector<double> t_sum(t_num_pairs);
+
+    // for every neuron. The sensitivities are updated in place, so neuron k
+    // sees the new sensitivities of the neurons before it and the old ones
+    // of the neurons after it.
+    for (unsigned int k = m_num_inputs; k < m_neurons.size(); k++)
+    {
+        double* t_row = SensitivityRow(k);
+
+        //double t_derivative = unsigned_sigmoid_derivative( m_neurons[k].m_activation );
+        double t_derivative = 0;
+        if (m_neurons[k].m_activation_function_type
+                == NEAT::UNSIGNED_SIGMOID)
+        {
+            t_derivative = unsigned_sigmoid_derivative(
+                    m_neurons[k].m_activation);
+        }
+        else if (m_neurons[k].m_activation_function_type
+                == NEAT::TANH)
+        {
+            t_derivative = tanh_derivative(
+                    m_neurons[k].m_activation);
+        }
+
+        if (t_derivative == 0)
+        {
+            std::fill(t_row, t_row + t_num_pairs, 0.0);
+            continue;
+        }
+
+        // for all connections, sum up the sensitivities of the neurons that
+        // feed k (the inputs have none), in the order of the sources
+        std::fill(t_sum.begin(), t_sum.end(), 0.0);
+        for (unsigned int q = m_rtrl_row_start[k]; q < m_rtrl_row_start[k + 1]; q++)
+        {
+            const Connection& t_c = m_connections[m_rtrl_pairs[q]];
+            if (t_c.m_source_neuron_idx < m_num_inputs)
+                continue;
+
+            double t_weight = t_c.m_weight;
+            const double* t_source_row = SensitivityRow(t_c.m_source_neuron_idx);
+            for (unsigned int p = 0; p < t_num_pairs; p++)
+            {
+                t_sum[p] += t_weight * t_source_row[p];
+            }
+        }
+
+        // the connections into k itself
+        for (unsigned int q = m_rtrl_row_start[k]; q < m_rtrl_row_start[k + 1]; q++)
+        {
+            t_sum[q] += m_neurons[m_connections[m_rtrl_pairs[q]].m_source_neuron_idx].m_activation;
+        }
+
+        for (unsigned int p = 0; p < t_num_pairs; p++)
+        {
+            t_row[p] = t_derivative * t_sum[p];
+        }
+    }
+}
+
+void NeuralNetwork::RTRL_apply_errors(const std::vector<double>& a_Errors)
+{
+    if (m_rtrl_row_start.size() != m_neurons.size() + 1)
+    {
+        InitRTRLMatrix();
+    }
+
+    // the signed error of the first output
+    m_total_error = a_Errors[0];
+
+    // adjust each weight
+    for (unsigned int p = 0; p < m_rtrl_pairs.size(); p++)
+    {
+        // we know the first output's index is m_num_inputs
+        double t_delta = a_Errors[0] * SensitivityRow(m_num_inputs)[p];
+        for (unsigned int o = 1; o < a_Errors.size(); o++)
+        {
+            t_delta += a_Errors[o] * SensitivityRow(m_num_inputs + o)[p];
+        }
+        m_total_weight_change[m_rtrl_pairs[p]] += t_delta * LEARNING_RATE;
+    }
+}
+
+void NeuralNetwork::RTRL_update_error(double a_target)
+{
+    std::vector<double> t_errors(1, a_target - OutputPtr()[0]);
+    RTRL_apply_errors(t_errors);
+}
+
+void NeuralNetwork::RTRL_update_error(const std::vector<double>& a_Targets)
+{
+    if (a_Targets.size() != m_num_outputs)
+        throw std::exception();
+
+    std::vector<double> t_outputs = Output();
+    std::vector<double> t_errors(m_num_outputs);
+    for (unsigned int o = 0; o < m_num_outputs; o++)
+    {
+        t_errors[o] = a_Targets[o] - t_outputs[o];
+    }
+    if (!t_errors.empty())
+    {
+        RTRL_apply_errors(t_errors);
+    }
+}
+
+void NeuralNetwork::RTRL_update_weights()
+{
+    Decompile();
+
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        m_connections[i].m_weight += m_total_weight_change[i];
+        m_total_weight_change[i] = 0; // clear this out
+    }
+    m_total_error = 0;
+}
+
+void NeuralNetwork::Save(const char* a_filename)
+{
+    FILE* fil = fopen(a_filename, "w");
+    Save(fil);
+    fclose(fil);
+}
+
+void NeuralNetwork::Save(FILE* a_file)
+{
+    fprintf(a_file, "NNstart\n");
+    // save num inputs/outputs and stuff
+    fprintf(a_file, "%u %u\n", m_num_inputs, m_num_outputs);
+    // save neurons
+    for (unsigned int i = 0; i < m_neurons.size(); i++)
+    {
+        // TYPE .. A .. B .. time_const .. bias .. activation_function_type .. split_y
+        fprintf(a_file, "neuron %d %3.18f %3.18f %3.18f %3.18f %d %3.18f\n",
+                static_cast<int>(m_neurons[i].m_type), m_neurons[i].m_a,
+                m_neurons[i].m_b, m_neurons[i].m_timeconst, m_neurons[i].m_bias,
+                static_cast<int>(m_neurons[i].m_activation_function_type),
+                GetNeuronLayout(i).m_split_y);
+    }
+    // save connections
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        // from .. to .. weight.. isrecur
+        const ConnectionLearning& t_l = GetConnectionLearning(i);
+        fprintf(a_file, "connection %u %u %3.18f %d %3.18f %3.18f\n",
+                m_connections[i].m_source_neuron_idx,
+                m_connections[i].m_target_neuron_idx, m_connections[i].m_weight,
+                static_cast<int>(t_l.m_recur_flag),
+                t_l.m_hebb_rate, t_l.m_hebb_pre_rate);
+    }
+    // end
+    fprintf(a_file, "NNend\n\n");
+}
+
+bool NeuralNetwork::Load(std::ifstream& a_DataFile)
+{
+    std::string t_str;
+    bool t_no_start = true, t_no_end = true;
+
+    if (!a_DataFile)
+    {
+        ostringstream tStream;
+        tStream << "NN file error!" << std::endl;
+        //    throw NS::Exception(tStream.str());
+    }
+
+    // search for NNstart
+    do
     {
         a_DataFile >> t_str;
         if (t_str == "NNstart")
@@ -878,6 +2188,7 @@ bool NeuralNetwork::Load(std::ifstream& a_DataFile)
         if (t_str == "neuron")
         {
             Neuron t_n;
+            NeuronLayout t_l;
 
             // for type and aftype
             int t_type, t_aftype;
@@ -888,18 +2199,19 @@ bool NeuralNetwork::Load(std::ifstream& a_DataFile)
             a_DataFile >> t_n.m_timeconst;
             a_DataFile >> t_n.m_bias;
             a_DataFile >> t_aftype;
-            a_DataFile >> t_n.m_split_y;
+            a_DataFile >> t_l.m_split_y;
 
             t_n.m_type = static_cast<NEAT::NeuronType>(t_type);
             t_n.m_activation_function_type = static_cast<NEAT::ActivationFunction>(t_aftype);
 
-            m_neurons.push_back(t_n);
+            AddNeuron(t_n, t_l);
         }
 
         // a connection?
         if (t_str == "connection")
         {
             Connection t_c;
+            ConnectionLearning t_l;
 
             int t_isrecur;
 
@@ -908,12 +2220,12 @@ bool NeuralNetwork::Load(std::ifstream& a_DataFile)
             a_DataFile >> t_c.m_weight;
             a_DataFile >> t_isrecur;
 
-            a_DataFile >> t_c.m_hebb_rate;
-            a_DataFile >> t_c.m_hebb_pre_rate;
+            a_DataFile >> t_l.m_hebb_rate;
+            a_DataFile >> t_l.m_hebb_pre_rate;
 
-            t_c.m_recur_flag = static_cast<bool>(t_isrecur);
+            t_l.m_recur_flag = static_cast<bool>(t_isrecur);
 
-            m_connections.push_back(t_c);
+            AddConnection(t_c, t_l);
         }
 
 
@@ -938,5 +2250,519 @@ bool NeuralNetwork::Load(const char *a_filename)
     return Load(t_DataFile);
 }
 
+// An array of an image being written
+template <class T>
+static T* ImageArray(char* a_data, const NetworkImageHeader& a_header, NetworkImageArray a_array)
+{
+    return reinterpret_cast<T*>(a_data + a_header.m_offset[a_array]);
+}
+
+std::string NeuralNetwork::ToBinary() const
+{
+    NetworkImageHeader t_header;
+    NetworkImage::Layout(m_neurons.size(), m_connections.size(), t_header);
+    t_header.m_flags = m_is_compiled ? IMAGE_COMPILED : 0;
+    t_header.m_num_inputs = m_num_inputs;
+    t_header.m_num_outputs = m_num_outputs;
+    t_header.m_precision = static_cast<uint32_t>(m_precision);
+    t_header.m_accuracy = static_cast<uint32_t>(m_accuracy);
+
+    // the padding stays zero
+    std::string t_image(static_cast<size_t>(t_header.m_size), '\0');
+    char* t_data = &t_image[0];
+    memcpy(t_data, &t_header, sizeof(t_header));
+
+    int32_t* t_type = ImageArray<int32_t>(t_data, t_header, IMAGE_NEURON_TYPE);
+    int32_t* t_aftype = ImageArray<int32_t>(t_data, t_header, IMAGE_NEURON_ACTIVATION_FUNCTION);
+    double* t_a = ImageArray<double>(t_data, t_header, IMAGE_NEURON_A);
+    double* t_b = ImageArray<double>(t_data, t_header, IMAGE_NEURON_B);
+    double* t_timeconst = ImageArray<double>(t_data, t_header, IMAGE_NEURON_TIMECONST);
+    double* t_bias = ImageArray<double>(t_data, t_header, IMAGE_NEURON_BIAS);
+    double* t_split_y = ImageArray<double>(t_data, t_header, IMAGE_NEURON_SPLIT_Y);
+    double* t_activesum = ImageArray<double>(t_data, t_header, IMAGE_NEURON_ACTIVESUM);
+    double* t_activation = ImageArray<double>(t_data, t_header, IMAGE_NEURON_ACTIVATION);
+    double* t_membrane = ImageArray<double>(t_data, t_header, IMAGE_NEURON_MEMBRANE_POTENTIAL);
+    for (unsigned int i = 0; i < m_neurons.size(); i++)
+    {
+        const Neuron& t_n = m_neurons[i];
+        t_type[i] = static_cast<int32_t>(t_n.m_type);
+        t_aftype[i] = static_cast<int32_t>(t_n.m_activation_function_type);
+        t_a[i] = t_n.m_a;
+        t_b[i] = t_n.m_b;
+        t_timeconst[i] = t_n.m_timeconst;
+        t_bias[i] = t_n.m_bias;
+        t_split_y[i] = GetNeuronLayout(i).m_split_y;
+        t_activesum[i] = t_n.m_activesum;
+
+        // while compiled, the state is in the compiled form
+        if (!m_is_compiled)
+        {
+            t_activation[i] = t_n.m_activation;
+            t_membrane[i] = t_n.m_membrane_potential;
+        }
+        else if (m_precision == SINGLE_PRECISION)
+        {
+            t_activation[i] = m_compiled_float.GetActivation(i);
+            t_membrane[i] = m_compiled_float.GetMembranePotential(i);
+        }
+        else
+        {
+            t_activation[i] = m_compiled.GetActivation(i);
+            t_membrane[i] = m_compiled.GetMembranePotential(i);
+        }
+    }
+
+    uint32_t* t_source = ImageArray<uint32_t>(t_data, t_header, IMAGE_CONNECTION_SOURCE);
+    uint32_t* t_target = ImageArray<uint32_t>(t_data, t_header, IMAGE_CONNECTION_TARGET);
+    double* t_weight = ImageArray<double>(t_data, t_header, IMAGE_CONNECTION_WEIGHT);
+    double* t_hebb_rate = ImageArray<double>(t_data, t_header, IMAGE_CONNECTION_HEBB_RATE);
+    double* t_hebb_pre_rate = ImageArray<double>(t_data, t_header, IMAGE_CONNECTION_HEBB_PRE_RATE);
+    uint8_t* t_recur = ImageArray<uint8_t>(t_data, t_header, IMAGE_CONNECTION_RECUR_FLAG);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        const Connection& t_c = m_connections[i];
+        t_source[i] = t_c.m_source_neuron_idx;
+        t_target[i] = t_c.m_target_neuron_idx;
+        t_weight[i] = t_c.m_weight;
+        const ConnectionLearning& t_l = GetConnectionLearning(i);
+        t_hebb_rate[i] = t_l.m_hebb_rate;
+        t_hebb_pre_rate[i] = t_l.m_hebb_pre_rate;
+        t_recur[i] = t_l.m_recur_flag ? 1 : 0;
+    }
+
+    return t_image;
+}
+
+bool NeuralNetwork::FromImage(const NetworkImage& a_Image)
+{
+    if (a_Image.Empty())
+        return false;
+
+    const NetworkImageHeader& t_header = a_Image.Header();
+    unsigned int t_num_neurons = t_header.m_num_neurons;
+    unsigned int t_num_connections = t_header.m_num_connections;
+    const uint32_t* t_source = reinterpret_cast<const uint32_t*>(a_Image.Array(IMAGE_CONNECTION_SOURCE));
+    const uint32_t* t_target = reinterpret_cast<const uint32_t*>(a_Image.Array(IMAGE_CONNECTION_TARGET));
+
+    // refuse what would index out of the network
+    if ((static_cast<uint64_t>(t_header.m_num_inputs) + t_header.m_num_outputs > t_num_neurons) ||
+        (t_header.m_precision > SINGLE_PRECISION) ||
+        (t_header.m_accuracy > VECTOR_ACTIVATION))
+        return false;
+    for (unsigned int i = 0; i < t_num_connections; i++)
+    {
+        if ((t_source[i] >= t_num_neurons) || (t_target[i] >= t_num_neurons))
+            return false;
+    }
+
+    Clear();
+    m_num_inputs = t_header.m_num_inputs;
+    m_num_outputs = t_header.m_num_outputs;
+    m_precision = static_cast<Precision>(t_header.m_precision);
+    m_accuracy = static_cast<ActivationAccuracy>(t_header.m_accuracy);
+
+    const int32_t* t_type = reinterpret_cast<const int32_t*>(a_Image.Array(IMAGE_NEURON_TYPE));
+    const int32_t* t_aftype = reinterpret_cast<const int32_t*>(a_Image.Array(IMAGE_NEURON_ACTIVATION_FUNCTION));
+    const double* t_a = a_Image.Doubles(IMAGE_NEURON_A);
+    const double* t_b = a_Image.Doubles(IMAGE_NEURON_B);
+    const double* t_timeconst = a_Image.Doubles(IMAGE_NEURON_TIMECONST);
+    const double* t_bias = a_Image.Doubles(IMAGE_NEURON_BIAS);
+    const double* t_split_y = a_Image.Doubles(IMAGE_NEURON_SPLIT_Y);
+    const double* t_activesum = a_Image.Doubles(IMAGE_NEURON_ACTIVESUM);
+    const double* t_activation = a_Image.Doubles(IMAGE_NEURON_ACTIVATION);
+    const double* t_membrane = a_Image.Doubles(IMAGE_NEURON_MEMBRANE_POTENTIAL);
+    m_neurons.resize(t_num_neurons);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        Neuron& t_n = m_neurons[i];
+        t_n.m_type = static_cast<NeuronType>(t_type[i]);
+        t_n.m_activation_function_type = static_cast<ActivationFunction>(t_aftype[i]);
+        t_n.m_a = t_a[i];
+        t_n.m_b = t_b[i];
+        t_n.m_timeconst = t_timeconst[i];
+        t_n.m_bias = t_bias[i];
+        t_n.m_activesum = t_activesum[i];
+        t_n.m_activation = t_activation[i];
+        t_n.m_membrane_potential = t_membrane[i];
+
+        // the layouts are allocated only if there is any
+        if (t_split_y[i] != 0)
+            NeuronLayoutAt(i).m_split_y = t_split_y[i];
+    }
+
+    const double* t_weight = a_Image.Doubles(IMAGE_CONNECTION_WEIGHT);
+    const double* t_hebb_rate = a_Image.Doubles(IMAGE_CONNECTION_HEBB_RATE);
+    const double* t_hebb_pre_rate = a_Image.Doubles(IMAGE_CONNECTION_HEBB_PRE_RATE);
+    const uint8_t* t_recur = reinterpret_cast<const uint8_t*>(a_Image.Array(IMAGE_CONNECTION_RECUR_FLAG));
+    m_connections.resize(t_num_connections);
+    for (unsigned int i = 0; i < t_num_connections; i++)
+    {
+        Connection& t_c = m_connections[i];
+        t_c.m_source_neuron_idx = t_source[i];
+        t_c.m_target_neuron_idx = t_target[i];
+        t_c.m_weight = t_weight[i];
+        t_c.m_signal = 0;
+
+        if ((t_hebb_rate[i] != 0) || (t_hebb_pre_rate[i] != 0) || (t_recur[i] != 0))
+        {
+            ConnectionLearning& t_l = ConnectionLearningAt(i);
+            t_l.m_hebb_rate = t_hebb_rate[i];
+            t_l.m_hebb_pre_rate = t_hebb_pre_rate[i];
+            t_l.m_recur_flag = (t_recur[i] != 0);
+        }
+    }
+
+    if (t_header.m_flags & IMAGE_COMPILED)
+        Compile();
+
+    return true;
+}
+
+bool NeuralNetwork::FromBinary(const void* a_Data, size_t a_Size)
+{
+    NetworkImage t_image;
+    if ((reinterpret_cast<size_t>(a_Data) & 7) == 0)
+    {
+        t_image.Attach(a_Data, a_Size);
+        return FromImage(t_image);
+    }
+
+    // the arrays must be aligned, so a misaligned image is copied first
+    std::vector<uint64_t> t_aligned(a_Size / 8 + 1);
+    memcpy(&t_aligned[0], a_Data, a_Size);
+    t_image.Attach(&t_aligned[0], a_Size);
+    return FromImage(t_image);
+}
+
+bool NeuralNetwork::SaveBinary(const char* a_filename) const
+{
+    FILE* t_file = fopen(a_filename, "wb");
+    if (t_file == NULL)
+        return false;
+
+    std::string t_image = ToBinary();
+    bool t_written = (fwrite(t_image.data(), 1, t_image.size(), t_file) == t_image.size());
+    return (fclose(t_file) == 0) && t_written;
+}
+
+bool NeuralNetwork::LoadBinary(const char* a_filename)
+{
+    MappedFile t_file;
+    if (!t_file.Open(a_filename))
+        return false;
+
+    NetworkImage t_image;
+    t_image.Attach(t_file.Data(), t_file.Size());
+    return FromImage(t_image);
+}
+
+// The C source of the activation functions, as in ActivationFunctions.h.
+// %s is the prefix of the exported network.
+static const char* ExportCActivationFunction(ActivationFunction a_type)
+{
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID:
+        return "static double %s_af_sigmoid_signed(double x, double a, double b)\n"
+               "{\n"
+               "    return (1.0 / (1.0 + exp(-a * x - b)) - 0.5) * 2.0;\n"
+               "}\n";
+    case TANH:
+        return "static double %s_af_tanh(double x, double a, double b)\n"
+               "{\n"
+               "    (void)b;\n"
+               "    return tanh(x * a);\n"
+               "}\n";
+    case TANH_CUBIC:
+        return "static double %s_af_tanh_cubic(double x, double a, double b)\n"
+               "{\n"
+               "    (void)b;\n"
+               "    return tanh(x * x * x * a);\n"
+               "}\n";
+    case SIGNED_STEP:
+        return "static double %s_af_step_signed(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    return (x > b) ? 1.0 : -1.0;\n"
+               "}\n";
+    case UNSIGNED_STEP:
+        return "static double %s_af_step_unsigned(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    return (x > (0.5 + b)) ? 1.0 : 0.0;\n"
+               "}\n";
+    case SIGNED_GAUSS:
+        return "static double %s_af_gauss_signed(double x, double a, double b)\n"
+               "{\n"
+               "    return (exp(-a * x * x + b) - 0.5) * 2.0;\n"
+               "}\n";
+    case UNSIGNED_GAUSS:
+        return "static double %s_af_gauss_unsigned(double x, double a, double b)\n"
+               "{\n"
+               "    return exp(-a * x * x + b);\n"
+               "}\n";
+    case ABS:
+        return "static double %s_af_abs(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    return ((x + b) < 0.0) ? -(x + b) : (x + b);\n"
+               "}\n";
+    case SIGNED_SINE:
+        return "static double %s_af_sine_signed(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    return sin(x * 3.141592 + b);\n"
+               "}\n";
+    case UNSIGNED_SINE:
+        return "static double %s_af_sine_unsigned(double x, double a, double b)\n"
+               "{\n"
+               "    return (sin(x * a + b) + 1.0) / 2.0;\n"
+               "}\n";
+    case LINEAR:
+        return "static double %s_af_linear(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    return x + b;\n"
+               "}\n";
+    case RELU:
+        return "static double %s_af_relu(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    (void)b;\n"
+               "    return (x > 0) ? x : 0;\n"
+               "}\n";
+    case SOFTPLUS:
+        return "static double %s_af_softplus(double x, double a, double b)\n"
+               "{\n"
+               "    (void)a;\n"
+               "    (void)b;\n"
+               "    return log(1 + exp(x));\n"
+               "}\n";
+    default:
+        return "static double %s_af_sigmoid_unsigned(double x, double a, double b)\n"
+               "{\n"
+               "    return 1.0 / (1.0 + exp(-a * x - b));\n"
+               "}\n";
+    }
+}
+
+// The name of the exported activation function, after the prefix
+static const char* ExportCActivationName(ActivationFunction a_type)
+{
+    switch (a_type)
+    {
+    case SIGNED_SIGMOID: return "af_sigmoid_signed";
+    case TANH: return "af_tanh";
+    case TANH_CUBIC: return "af_tanh_cubic";
+    case SIGNED_STEP: return "af_step_signed";
+    case UNSIGNED_STEP: return "af_step_unsigned";
+    case SIGNED_GAUSS: return "af_gauss_signed";
+    case UNSIGNED_GAUSS: return "af_gauss_unsigned";
+    case ABS: return "af_abs";
+    case SIGNED_SINE: return "af_sine_signed";
+    case UNSIGNED_SINE: return "af_sine_unsigned";
+    case LINEAR: return "af_linear";
+    case RELU: return "af_relu";
+    case SOFTPLUS: return "af_softplus";
+    default: return "af_sigmoid_unsigned";
+    }
+}
+
+// A C literal that reads back as exactly a_x
+static std::string ExportCLiteral(double a_x)
+{
+    if (std::isnan(a_x))
+        return "NAN";
+    if (std::isinf(a_x))
+        return (a_x > 0) ? "HUGE_VAL" : "-HUGE_VAL";
+
+    char t_buf[64];
+    snprintf(t_buf, sizeof(t_buf), "%.17g", a_x);
+    std::string t_str(t_buf);
+    if (t_str.find_first_of(".e") == std::string::npos)
+        t_str += ".0";
+    if (a_x < 0)
+        t_str = "(" + t_str + ")";
+    return t_str;
+}
+
+// Writes the activation of neuron a_idx as a C expression, reading the
+// activations of the other neurons as a_Var[index]. The signals are summed
+// in connection order, as Activate() does.
+static void ExportCNeuron(FILE* a_file, const char* a_Prefix, const Neuron& a_neuron,
+                          const std::vector<const Connection*>& a_incoming, const char* a_Var)
+{
+    fprintf(a_file, "%s_%s(", a_Prefix, ExportCActivationName(a_neuron.m_activation_function_type));
+    if (a_incoming.empty())
+    {
+        fprintf(a_file, "0.0");
+    }
+    for (unsigned int j = 0; j < a_incoming.size(); j++)
+    {
+        fprintf(a_file, "%s%s[%u] * %s", (j > 0) ? "\n            + " : "", a_Var,
+                a_incoming[j]->m_source_neuron_idx, ExportCLiteral(a_incoming[j]->m_weight).c_str());
+    }
+    fprintf(a_file, ",\n            %s, %s)", ExportCLiteral(a_neuron.m_a).c_str(),
+            ExportCLiteral(a_neuron.m_b).c_str());
+}
+
+bool NeuralNetwork::ExportC(const char* a_filename, const char* a_Prefix)
+{
+    FILE* t_file = fopen(a_filename, "w");
+    if (!t_file)
+        return false;
+
+    unsigned int t_num_neurons = static_cast<unsigned int>(m_neurons.size());
+
+    // the incoming connections of each neuron, in connection order
+    std::vector< std::vector<const Connection*> > t_incoming(t_num_neurons);
+    for (unsigned int i = 0; i < m_connections.size(); i++)
+    {
+        t_incoming[m_connections[i].m_target_neuron_idx].push_back(&m_connections[i]);
+    }
+
+    std::string t_upper(a_Prefix);
+    std::transform(t_upper.begin(), t_upper.end(), t_upper.begin(), ::toupper);
+
+    fprintf(t_file, "/*\n"
+                    " * Generated by MultiNEAT - NeuralNetwork::ExportC()\n"
+                    " * %u neurons, %u inputs, %u outputs, %u connections\n"
+                    " *\n"
+                    " * The results match NeuralNetwork::Activate() exactly when compiled\n"
+                    " * without contracting a * b + c into fused multiply-adds\n"
+                    " * (-ffp-contract=off, the default in the ISO C modes of GCC).\n",
+            t_num_neurons, m_num_inputs, m_num_outputs, static_cast<unsigned int>(m_connections.size()));
+    // the code always computes what the uncompiled network does
+    if (m_is_compiled && (m_precision != DOUBLE_PRECISION))
+    {
+        fprintf(t_file, " *\n"
+                        " * The network was compiled in single precision, this code runs in\n"
+                        " * double precision, so the results differ by the float rounding.\n");
+    }
+    if (m_is_compiled && (m_accuracy != EXACT_ACTIVATION))
+    {
+        fprintf(t_file, " *\n"
+                        " * The network was compiled with approximated activation functions,\n"
+                        " * this code calls the C library, so the results differ by the error\n"
+                        " * of the approximations.\n");
+    }
+    fprintf(t_file, " */\n\n"
+                    "#include <math.h>\n\n");
+    fprintf(t_file, "#define %s_NUM_INPUTS %u\n", t_upper.c_str(), m_num_inputs);
+    fprintf(t_file, "#define %s_NUM_OUTPUTS %u\n", t_upper.c_str(), m_num_outputs);
+    fprintf(t_file, "#define %s_NUM_NEURONS %u\n\n", t_upper.c_str(), t_num_neurons);
+
+    // the activation functions in use
+    std::vector<bool> t_used(SOFTPLUS + 2, false);
+    for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+    {
+        unsigned int t_af = static_cast<unsigned int>(m_neurons[i].m_activation_function_type);
+        if (t_af > SOFTPLUS)
+            t_af = UNSIGNED_SIGMOID;
+        if (!t_used[t_af])
+        {
+            t_used[t_af] = true;
+            fprintf(t_file, ExportCActivationFunction(m_neurons[i].m_activation_function_type), a_Prefix);
+            fprintf(t_file, "\n");
+        }
+    }
+
+    // flush
+    fprintf(t_file, "/* Sets all activations in the state to zero */\n"
+                    "void %s_flush(double* state)\n{\n", a_Prefix);
+    fprintf(t_file, "    int i;\n"
+                    "    for (i = 0; i < %s_NUM_NEURONS; i++)\n"
+                    "        state[i] = 0.0;\n}\n\n", t_upper.c_str());
+
+    // input
+    fprintf(t_file, "/* Copies the inputs into the state */\n"
+                    "void %s_input(double* state, const double* inputs)\n{\n", a_Prefix);
+    for (unsigned int i = 0; i < m_num_inputs; i++)
+    {
+        fprintf(t_file, "    state[%u] = inputs[%u];\n", i, i);
+    }
+    fprintf(t_file, "}\n\n");
+
+    // activate - every neuron is computed from the old state
+    fprintf(t_file, "/* One step of NeuralNetwork::Activate() */\n"
+                    "void %s_activate(double* state)\n{\n", a_Prefix);
+    for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+    {
+        fprintf(t_file, "    const double n%u = ", i);
+        ExportCNeuron(t_file, a_Prefix, m_neurons[i], t_incoming[i], "state");
+        fprintf(t_file, ";\n");
+    }
+    for (unsigned int i = m_num_inputs; i < t_num_neurons; i++)
+    {
+        fprintf(t_file, "    state[%u] = n%u;\n", i, i);
+    }
+    fprintf(t_file, "}\n\n");
+
+    // output
+    fprintf(t_file, "/* Copies the outputs from the state */\n"
+                    "void %s_output(const double* state, double* outputs)\n{\n", a_Prefix);
+    for (unsigned int i = 0; i < m_num_outputs; i++)
+    {
+        fprintf(t_file, "    outputs[%u] = state[%u];\n", i, m_num_inputs + i);
+    }
+    fprintf(t_file, "}\n");
+
+    // evaluate - a feed-forward pass in topological order, for acyclic networks
+    if (IsAcyclic())
+    {
+        std::vector<unsigned int> t_pending(t_num_neurons, 0);
+        std::vector< std::vector<unsigned int> > t_outgoing(t_num_neurons);
+        for (unsigned int i = 0; i < m_connections.size(); i++)
+        {
+            t_pending[m_connections[i].m_target_neuron_idx]++;
+            t_outgoing[m_connections[i].m_source_neuron_idx].push_back(m_connections[i].m_target_neuron_idx);
+        }
+
+        std::vector<unsigned int> t_order;
+        for (unsigned int i = 0; i < t_num_neurons; i++)
+        {
+            if (t_pending[i] == 0)
+                t_order.push_back(i);
+        }
+        for (unsigned int k = 0; k < t_order.size(); k++)
+        {
+            for (unsigned int j = 0; j < t_outgoing[t_order[k]].size(); j++)
+            {
+                unsigned int t_target = t_outgoing[t_order[k]][j];
+                if (--t_pending[t_target] == 0)
+                    t_order.push_back(t_target);
+            }
+        }
+
+        fprintf(t_file, "\n/* The outputs for the inputs, same as NeuralNetwork::ActivateTopological()\n"
+                        "   on a flushed network */\n"
+                        "void %s_evaluate(const double* inputs, double* outputs)\n{\n", a_Prefix);
+        fprintf(t_file, "    double n[%u];\n", (t_num_neurons > 0) ? t_num_neurons : 1);
+        for (unsigned int k = 0; k < t_order.size(); k++)
+        {
+            unsigned int i = t_order[k];
+            if (i < m_num_inputs)
+            {
+                fprintf(t_file, "    n[%u] = inputs[%u];\n", i, i);
+            }
+            else
+            {
+                fprintf(t_file, "    n[%u] = ", i);
+                ExportCNeuron(t_file, a_Prefix, m_neurons[i], t_incoming[i], "n");
+                fprintf(t_file, ";\n");
+            }
+        }
+        for (unsigned int i = 0; i < m_num_outputs; i++)
+        {
+            fprintf(t_file, "    outputs[%u] = n[%u];\n", i, m_num_inputs + i);
+        }
+        fprintf(t_file, "}\n");
+    }
+
+    fclose(t_file);
+    return true;
+}
+
+
 
 }; // namespace NEAT
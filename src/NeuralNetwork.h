@@ -43,7 +43,10 @@ namespace py = boost::python;
 #endif
 
 #include <vector>
+#include <string>
 #include "Genes.h"
+#include "CompiledNetwork.h"
+#include "NetworkImage.h"
 
 namespace NEAT
 {
@@ -51,18 +54,13 @@ namespace NEAT
 class Connection
 {
 public:
-    unsigned short int m_source_neuron_idx;       // index of source neuron
-    unsigned short int m_target_neuron_idx;       // index of target neuron
+    unsigned int m_source_neuron_idx;             // index of source neuron
+    unsigned int m_target_neuron_idx;             // index of target neuron
     double m_weight;                               // weight of the connection
     double m_signal;                               // weight * input signal
 
-    bool m_recur_flag; // recurrence flag for displaying purposes
-    // can be ignored
-
-    // Hebbian learning parameters
-    // Ignored in case there is no lifetime learning
-    double m_hebb_rate;
-    double m_hebb_pre_rate;
+    // The recurrence flag and the Hebbian rates are kept by the network,
+    // see ConnectionLearning
 
     // comparison operator (nessesary for boost::python)
     bool operator==(Connection const& other) const
@@ -87,22 +85,15 @@ public:
     double m_a, m_b, m_timeconst, m_bias; // misc parameters
     double m_membrane_potential; // used in leaky integrator mode
     ActivationFunction m_activation_function_type;
-
-    // displaying and stuff
-    double m_x, m_y, m_z;
-    double m_sx, m_sy, m_sz;
-    std::vector<double> m_substrate_coords;
-    double m_split_y;
     NeuronType m_type;
 
-    // the sensitivity matrix of this neuron (for RTRL learning)
-    std::vector< std::vector< double > > m_sensitivity_matrix;
+    // The display and substrate data is kept by the network, see NeuronLayout.
+    // The RTRL sensitivities are kept by the network, see NeuralNetwork::InitRTRLMatrix()
 
     // comparison operator (nessesary for boost::python)
     bool operator==(Neuron const& other) const
     {
         if ((m_type == other.m_type) &&
-            (m_split_y == other.m_split_y) &&
             (m_activation_function_type == other.m_activation_function_type)// &&
             //(this == other.this))
             )
@@ -112,60 +103,450 @@ public:
     }
 };
 
+// The data of a neuron that activation never reads: where it is drawn and
+// where it is in the substrate. The network keeps it in a side table,
+// allocated only for the networks that have any (see
+// NeuralNetwork::m_neuron_layout).
+class NeuronLayout
+{
+public:
+    // displaying and stuff
+    double m_x, m_y, m_z;
+    double m_sx, m_sy, m_sz;
+    std::vector<double> m_substrate_coords;
+    double m_split_y;
+
+    NeuronLayout()
+    {
+        m_x = m_y = m_z = 0;
+        m_sx = m_sy = m_sz = 0;
+        m_split_y = 0;
+    }
+};
+
+// The data of a connection that activation never reads, kept in a side
+// table like NeuronLayout (see NeuralNetwork::m_connection_learning)
+class ConnectionLearning
+{
+public:
+    bool m_recur_flag; // recurrence flag for displaying purposes
+    // can be ignored
+
+    // Hebbian learning parameters
+    // Ignored in case there is no lifetime learning
+    double m_hebb_rate;
+    double m_hebb_pre_rate;
+
+    ConnectionLearning()
+    {
+        m_recur_flag = false;
+        m_hebb_rate = m_hebb_pre_rate = 0;
+    }
+};
+
+// The state of a compiled NeuralNetwork, kept apart from the network:
+// the activations and membrane potentials of its neurons. A copy is an
+// independent state, so forking a rollout is copying its state.
+// Only the member matching the network's precision is used.
+class NeuralNetworkState
+{
+public:
+    CompiledNetworkState m_state;
+    CompiledNetworkStateFloat m_state_float;
+};
+
+// What NeuralNetwork::Optimize() did
+class OptimizationReport
+{
+public:
+    unsigned int m_small_connections;  // removed, their weights were within the epsilon
+    unsigned int m_folded_neurons;     // constant hidden neurons folded into their targets
+    unsigned int m_folded_connections; // removed with the folded neurons
+    unsigned int m_added_connections;  // from the bias input, carrying folded constants
+    unsigned int m_dead_neurons;       // hidden neurons that couldn't reach an output
+    unsigned int m_dead_connections;   // from or to dead neurons, or into the inputs
+
+    OptimizationReport()
+    {
+        m_small_connections = m_folded_neurons = m_folded_connections = 0;
+        m_added_connections = m_dead_neurons = m_dead_connections = 0;
+    }
+};
+
 class NeuralNetwork
 {
     /////////////////////
     // RTRL variables
-    double m_total_error;
+    double m_total_error; // target - output of the first output, from RTRL_update_error()
 
     // Always the size of m_connections
     std::vector<double> m_total_weight_change;
+
+    // The connection index, built by InitRTRLMatrix(). It has the first
+    // connection of every distinct (target, source) pair that ends in a
+    // non-input neuron, sorted by target, then by source. The pairs ending
+    // in neuron i are [m_rtrl_row_start[i] .. m_rtrl_row_start[i+1]).
+    std::vector<unsigned int> m_rtrl_pairs;
+    std::vector<unsigned int> m_rtrl_row_start;
+
+    // The sensitivities, empty until InitRTRLMatrix() is called. They exist
+    // only for the non-input neurons k and the connections of m_rtrl_pairs.
+    // The sensitivity of neuron k to the pair p is at
+    // [(k - m_num_inputs) * m_rtrl_pairs.size() + p].
+    std::vector<double> m_sensitivity;
+
+    double* SensitivityRow(unsigned int a_k)
+    {
+        return &m_sensitivity[static_cast<size_t>(a_k - m_num_inputs) * m_rtrl_pairs.size()];
+    }
+
+    // Adds the weight changes for the errors of the first a_Errors.size() outputs
+    void RTRL_apply_errors(const std::vector<double>& a_Errors);
     /////////////////////
 
     // returns the index if that connection exists or -1 otherwise
     int ConnectionExists(int a_to, int a_from);
 
+    // The compiled form of the network, valid only while m_is_compiled is true.
+    // Only the one matching m_precision is used.
+    CompiledNetwork m_compiled;
+    CompiledNetworkFloat m_compiled_float;
+    bool m_is_compiled;
+
+    // The numeric type Compile() uses
+    Precision m_precision;
+
+    // The accuracy of the activation functions of the compiled form
+    ActivationAccuracy m_accuracy;
+
+    // The most threads the compiled form activates with
+    unsigned int m_num_threads;
+
+    // Set by Optimize(), reset by Clear()
+    bool m_is_optimized;
+
+    // The work of InputFrom() and OutputInto() for either element type
+    template <class T> void InputFromArray(const T* a_Inputs);
+    template <class T> void OutputToArray(T* a_Outputs) const;
+
+    // The copy of the outputs OutputPtr() returns
+    std::vector<double> m_outputs;
+
+    // Throws if the network isn't compiled or a_State isn't one of its states
+    void CheckState(const NeuralNetworkState& a_State) const;
+
+    // Sizes the side tables in use to the neurons and connections
+    void MatchSideTables();
+
 public:
 
-    unsigned short m_num_inputs, m_num_outputs;
+    unsigned int m_num_inputs, m_num_outputs;
     std::vector<Connection> m_connections; // array size - number of connections
     std::vector<Neuron>     m_neurons;
 
+    // The IDs of the neuron genes and the innovation IDs of the link genes
+    // the neurons and connections were built from by Genome::BuildPhenotype(),
+    // in the same order. Empty for networks built any other way.
+    std::vector<unsigned int> m_neuron_gene_ids;
+    std::vector<unsigned int> m_link_gene_ids;
+
+    // The NeuronLayout of every neuron and the ConnectionLearning of every
+    // connection, in the same order. A table is allocated only for the
+    // networks that have such data (Genome::BuildPhenotype() fills both,
+    // the substrate builders only the layouts), and the entries it lacks
+    // are the defaults. Read them with GetNeuronLayout() and the like.
+    std::vector<NeuronLayout> m_neuron_layout;
+    std::vector<ConnectionLearning> m_connection_learning;
+
     NeuralNetwork(bool a_Minimal); // if given false, the constructor will create a standard XOR network topology.
     NeuralNetwork();
 
-    void InitRTRLMatrix(); // initializes the sensitivity cube for RTRL learning.
-    // assumes that neuron and connection data are already initialized
+    void InitRTRLMatrix(); // initializes the sensitivities for RTRL learning.
+    // assumes that neuron and connection data are already initialized,
+    // and must be called again if the connections change
 
     void ActivateFast();          // assumes unsigned sigmoids everywhere.
     void Activate();              // any activation functions are supported
     void ActivateUseInternalBias(); // like Activate() but uses m_bias as well
     void ActivateLeaky(double step); // activates in leaky integrator mode
 
+    // Like Activate(), but propagates the inputs through the whole network
+    // in a single pass in topological order. The neurons that are part of
+    // cycles are activated a_RecurrentIterations times, all the others once.
+    // For an acyclic network this gives the same outputs as calling
+    // Activate() (after Flush()) as many times as the network is deep.
+    // The network is compiled first if it isn't already.
+    void ActivateTopological(unsigned int a_RecurrentIterations = 1);
+
+    // Event-driven Activate(), for inputs that change little from step to
+    // step. Only the neurons whose activation changed by more than
+    // a_Epsilon since they last passed it on update their targets' sums,
+    // which are kept from step to step, and only the neurons whose sums
+    // changed are activated again. With a_Epsilon = 0 the outputs are those
+    // of Activate() up to rounding, a larger a_Epsilon trades accuracy for
+    // speed. The first step after Flush(), any other activation method or a
+    // change of the weights or neuron parameters (also for the states of
+    // NewState() and CloneState()) is a full Activate(). The network is
+    // compiled first if it isn't already.
+    void ActivateDelta(double a_Epsilon = 0.0);
+
+    // Returns true if the network has no cycles (recurrent connections)
+    bool IsAcyclic() const;
+
+    // Returns the number of Activate() calls after which the outputs of the
+    // network stop changing, whatever its state, and are those of
+    // ActivateTopological() - the number of its topological levels.
+    // UINT_MAX if the network has cycles.
+    unsigned int SettlingDepth() const;
+
+    // Reentrant activation. The compiled network is not changed by the
+    // methods that take a state, so one network (the model) can drive any
+    // number of states at once, from any number of threads, as long as it
+    // isn't changed meanwhile. The states must come from NewState() or
+    // CloneState() of this network, compiled as it is now. All of these
+    // throw if the network isn't compiled.
+
+    // A flushed state
+    NeuralNetworkState NewState() const;
+
+    // A copy of the network's own state, and the other way around
+    NeuralNetworkState CloneState() const;
+    void RestoreState(const NeuralNetworkState& a_State);
+
+    // Same as the methods of the network's own state
+    void Input(NeuralNetworkState& a_State, const std::vector<double>& a_Inputs) const;
+    void Activate(NeuralNetworkState& a_State) const;
+    void ActivateUseInternalBias(NeuralNetworkState& a_State) const;
+    void ActivateLeaky(NeuralNetworkState& a_State, double a_Step) const;
+    void ActivateTopological(NeuralNetworkState& a_State, unsigned int a_RecurrentIterations = 1) const;
+    void ActivateDelta(NeuralNetworkState& a_State, double a_Epsilon = 0.0) const;
+    void Flush(NeuralNetworkState& a_State) const;
+    std::vector<double> Output(const NeuralNetworkState& a_State) const;
+    void OutputInto(const NeuralNetworkState& a_State, double* a_Outputs) const;
+
+    // Runs many independent samples through the network at once. For each
+    // row of a_Inputs, this is the same as Flush(), Input(), a_Steps times
+    // Activate() and Output(), with the outputs stored in the same row of
+    // a_Outputs. The network's own state is left as it was.
+    // The network is compiled first if it isn't already.
+    void ActivateBatch(const std::vector< std::vector<double> >& a_Inputs,
+                       std::vector< std::vector<double> >& a_Outputs,
+                       unsigned int a_Steps);
+
+    // Compiles the network. Until it is decompiled (or cleared), the
+    // activation methods, Flush(), Input() and Output() run on the compiled
+    // form and the neurons' m_activation fields are not updated.
+    // Changes to m_neurons or m_connections require calling Compile() again.
+    void Compile();
+
+    // Copies changed weights and neuron parameters (A, B, time constant and
+    // bias) from m_connections and m_neurons into the compiled form, without
+    // compiling it again. The neurons, the connections' ends and the
+    // activation functions must be as they were when compiled.
+    // Does nothing if the network isn't compiled.
+    void UpdateParameters();
+
+    // Writes the state of the compiled network back to m_neurons and
+    // returns to activating the neurons and connections directly.
+    // Adapt() and the RTRL methods do this automatically.
+    void Decompile();
+
+    bool IsCompiled() const
+    {
+        return m_is_compiled;
+    }
+
+    // True if Optimize() changed the network since it was built. Its
+    // connections then come from no known link genes, and their weights
+    // can't be copied back to a genome.
+    bool IsOptimized() const
+    {
+        return m_is_optimized;
+    }
+
+    // Selects double (the default) or single precision for the compiled
+    // form. Recompiles the network if it is compiled. Clear() keeps it.
+    // Single precision speeds up the accumulation of the connections only,
+    // the activation functions cost the same as in double.
+    void SetPrecision(Precision a_Precision);
+    Precision GetPrecision() const
+    {
+        return m_precision;
+    }
+
+    // Selects how accurately the compiled form computes the activation
+    // functions (see ActivationFunctions.h for the error bounds of each mode).
+    // The default is EXACT_ACTIVATION. Recompiles the network if it is
+    // compiled, the approximations apply only to the compiled form.
+    // Clear() keeps it.
+    void SetActivationAccuracy(ActivationAccuracy a_Accuracy);
+    ActivationAccuracy GetActivationAccuracy() const
+    {
+        return m_accuracy;
+    }
+
+    // Sets how many threads the compiled form may use in Activate(),
+    // ActivateUseInternalBias(), ActivateLeaky() and ActivateTopological(),
+    // 0 for one per hardware thread. The default is 1, serial. Only large
+    // networks (about 16K connections, or as many in a topological level)
+    // are split between threads, and the outputs don't depend on the number
+    // of threads. The threads come from a pool shared by the process, so
+    // networks activated from several threads at once share them too.
+    // Clear() keeps it.
+    void SetNumThreads(unsigned int a_NumThreads);
+    unsigned int GetNumThreads() const
+    {
+        return m_num_threads;
+    }
+
+    // The engine Activate() runs on: INTERPRETED_BACKEND if the network
+    // isn't compiled, otherwise the form the compiled network chose for its
+    // size (see BackendProfile). Meant for logs.
+    ActivationBackend GetBackend() const;
+
+    // Picks the engine for the network from its size: compiles it if it
+    // isn't compiled and lets it use all the hardware threads if it has
+    // enough connections to gain from them, one otherwise. The precision and
+    // the activation accuracy are kept, as they change the outputs.
+    // Returns the engine picked.
+    ActivationBackend SelectBackend();
+
+    // Simplifies the network for activation, in three steps:
+    //  - removes the connections of weight at most a_WeightEpsilon in
+    //    magnitude (with the default, only those of weight 0)
+    //  - folds the hidden neurons whose inputs are all constant, the bias
+    //    input (at a_BiasValue) or other such neurons. What they add to
+    //    the rest of the network goes to the internal biases of their
+    //    targets if a_UseInternalBias, or else to connections from the
+    //    bias input (there is no folding without a bias input then).
+    //    The neurons that lead into a cycle are not folded.
+    //  - removes the hidden neurons that can't reach an output.
+    // The inputs and outputs stay where they are.
+    //
+    // a_UseInternalBias must match the activation method used later, true
+    // for ActivateUseInternalBias() and ActivateLeaky(), false for the
+    // others. Then, with a_WeightEpsilon = 0, the outputs of acyclic
+    // networks are the same up to rounding, and in the step-wise methods
+    // they are the same once the constant neurons have settled (they may
+    // reach the outputs sooner than they did). A cycle would remember the
+    // values it got before that, which is why nothing that leads into one
+    // is folded. The neuron state is kept, but Flush() is advisable, and
+    // the side tables follow the neurons and connections that are left.
+    // The network no longer matches its genome (see IsOptimized()), and it
+    // is recompiled if it is compiled.
+    OptimizationReport Optimize(double a_WeightEpsilon = 0.0, double a_BiasValue = 1.0,
+                                bool a_UseInternalBias = false);
+
+    // Renumbers the hidden neurons in breadth-first order from the inputs,
+    // so neurons fed by the same or nearby neurons get nearby indices and
+    // activation reads the neurons mostly in sequence. The inputs and
+    // outputs keep their indices, the connections keep their order and
+    // are only remapped, and m_neuron_gene_ids and m_neuron_layout follow
+    // the neurons. The outputs don't change. The RTRL sensitivities are
+    // dropped, and the network is recompiled if it is compiled.
+    void ReorderHiddenNeurons();
+
+    // Real-time recurrent learning. The sensitivities are kept only for the
+    // existing connections, so a step costs O(connections^2) time and the
+    // memory is (non-input neurons * connections).
     void RTRL_update_gradients();
-    void RTRL_update_error(double a_target);
+    void RTRL_update_error(double a_target); // for the first output only
+    void RTRL_update_error(const std::vector<double>& a_Targets); // one target per output
     void RTRL_update_weights();   // performs the backprop step
 
+    // Gradient descent on the squared error of the outputs. Only the
+    // connection weights are trained, so they can be copied back to the
+    // genome with Genome::DerivePhenotypicChanges(). Row s of a_Targets has
+    // the wanted outputs for row s of a_Inputs. Both return the mean squared
+    // error of the outputs over all rows. For Backprop() that is the error
+    // before the weights changed. For BPTT() it is the error over the
+    // sequence as it was run, so with more than one truncation window the
+    // later windows count with the weights of the earlier updates.
+    // The network is compiled first if it isn't already.
+
+    // Batched backpropagation for acyclic networks (throws for the others).
+    // Every row is a separate sample, run like Flush(), Input(),
+    // ActivateTopological() and Output(), and the weights change once, by
+    // the gradient averaged over all rows. The state of the network is kept.
+    double Backprop(const std::vector< std::vector<double> >& a_Inputs,
+                    const std::vector< std::vector<double> >& a_Targets,
+                    double a_LearningRate);
+
+    // Truncated backpropagation through time, for any network. The rows are
+    // a sequence, run like Input(), Activate() and Output() from the current
+    // state on, and the state is left where the sequence ends. After every
+    // a_TruncationDepth steps the errors are propagated back through these
+    // steps and the weights change by the gradient averaged over them.
+    double BPTT(const std::vector< std::vector<double> >& a_Inputs,
+                const std::vector< std::vector<double> >& a_Targets,
+                double a_LearningRate, unsigned int a_TruncationDepth);
+
     // Hebbian learning
     void Adapt(Parameters& a_Parameters);
 
     void Flush();     // clears all activations
-    void FlushCube(); // clears the sensitivity cube
+    void FlushCube(); // clears the sensitivities
 
     void Input(std::vector<double>& a_Inputs);
 
+    // Sets the inputs from a_Inputs[0 .. NumInputs()) without copying them first
+    void InputFrom(const double* a_Inputs);
+    void InputFrom(const float* a_Inputs);
+
 #ifdef USE_BOOST_PYTHON
 
     void Input_python_list(py::list& a_Inputs);
+    void Input_state_python_list(NeuralNetworkState& a_State, py::list& a_Inputs) const;
+    void RTRL_update_error_python_list(py::list& a_Targets);
+    py::list ActivateBatch_python_list(py::list& a_Inputs, unsigned int a_Steps);
+    double Backprop_python_list(py::list& a_Inputs, py::list& a_Targets, double a_LearningRate);
+    double BPTT_python_list(py::list& a_Inputs, py::list& a_Targets,
+                            double a_LearningRate, unsigned int a_TruncationDepth);
     void Input_numpy(py::numeric::array& a_Inputs);
+    void OutputInto_numpy(py::numeric::array& a_Outputs) const;
 
 #endif
 
     std::vector<double> Output();
 
+    // Writes the outputs to a_Outputs[0 .. NumOutputs()) without allocating
+    void OutputInto(double* a_Outputs) const;
+    void OutputInto(float* a_Outputs) const;
+
+    // Returns the outputs, valid until OutputPtr() is called again. They are
+    // copied to a buffer of the network's own, allocated only once.
+    const double* OutputPtr();
+
+    // Bulk access to the weights and the neuron parameters, for optimizers
+    // that work on them as arrays. The weights are in the order of
+    // m_connections (NumConnections() of them), the others in the order of
+    // m_neurons (NumNeurons() of them). The setters update the compiled form
+    // if the network is compiled.
+    void GetWeights(double* a_Weights) const;
+    void SetWeights(const double* a_Weights);
+    void GetBiases(double* a_Biases) const;
+    void SetBiases(const double* a_Biases);
+    void GetTimeConstants(double* a_TimeConstants) const;
+    void SetTimeConstants(const double* a_TimeConstants);
+    void GetActivationA(double* a_A) const;
+    void SetActivationA(const double* a_A);
+    void GetActivationB(double* a_B) const;
+    void SetActivationB(const double* a_B);
+
     // accessor methods
     void AddNeuron(const Neuron& a_n) { m_neurons.push_back( a_n ); }
     void AddConnection(const Connection& a_c) { m_connections.push_back( a_c ); }
+    void AddNeuron(const Neuron& a_n, const NeuronLayout& a_l);
+    void AddConnection(const Connection& a_c, const ConnectionLearning& a_l);
+
+    // The side table entry of a neuron or connection, the defaults if it
+    // has none. The ...At() ones are for changing it, and allocate the
+    // table if the network has none.
+    const NeuronLayout& GetNeuronLayout(unsigned int a_idx) const;
+    NeuronLayout& NeuronLayoutAt(unsigned int a_idx);
+    const ConnectionLearning& GetConnectionLearning(unsigned int a_idx) const;
+    ConnectionLearning& ConnectionLearningAt(unsigned int a_idx);
+
     Connection GetConnectionByIndex(unsigned int a_idx) const
     {
         return m_connections[a_idx];
@@ -174,19 +555,27 @@ public:
     {
         return m_neurons[a_idx];
     }
-    void SetInputOutputDimentions(const unsigned short a_i, const unsigned short a_o)
+    void SetInputOutputDimentions(const unsigned int a_i, const unsigned int a_o)
     {
         m_num_inputs = a_i;
         m_num_outputs = a_o;
     }
-    unsigned short NumInputs() const
+    unsigned int NumInputs() const
     {
         return m_num_inputs;
     }
-    unsigned short NumOutputs() const
+    unsigned int NumOutputs() const
     {
         return m_num_outputs;
     }
+    unsigned int NumNeurons() const
+    {
+        return static_cast<unsigned int>(m_neurons.size());
+    }
+    unsigned int NumConnections() const
+    {
+        return static_cast<unsigned int>(m_connections.size());
+    }
 
     // clears the network and makes it a minimal one
     void Clear()
@@ -194,10 +583,21 @@ public:
         m_neurons.clear();
         m_connections.clear();
         m_total_weight_change.clear();
+        m_sensitivity.clear();
+        m_rtrl_pairs.clear();
+        m_rtrl_row_start.clear();
+        m_neuron_gene_ids.clear();
+        m_link_gene_ids.clear();
+        m_neuron_layout.clear();
+        m_connection_learning.clear();
+        m_compiled.Clear();
+        m_compiled_float.Clear();
+        m_is_compiled = false;
+        m_is_optimized = false;
         SetInputOutputDimentions(0, 0);
     }
 
-    double GetConnectionLenght(Neuron source, Neuron target)
+    double GetConnectionLenght(const NeuronLayout& source, const NeuronLayout& target)
     {   double dist = 0.0;
         for (unsigned int i = 0; i < source.m_substrate_coords.size(); i++)
             dist += (target.m_substrate_coords[i] - source.m_substrate_coords[i])*(target.m_substrate_coords[i]- source.m_substrate_coords[i] );
@@ -209,9 +609,9 @@ public:
        /* double total = 0;
         for (unsigned int i = 0; i < m_connections.size(); i++)
         {
-            //std:: cout << GetConnectionLenght(m_neurons[m_connections[i].m_source_neuron_idx], m_neurons[m_connections[i].m_target_neuron_idx])<< std::endl;
+            //std:: cout << GetConnectionLenght(GetNeuronLayout(m_connections[i].m_source_neuron_idx), GetNeuronLayout(m_connections[i].m_target_neuron_idx))<< std::endl;
 
-            total += std::pow(GetConnectionLenght(m_neurons[m_connections[i].m_source_neuron_idx], m_neurons[m_connections[i].m_target_neuron_idx]),2);
+            total += std::pow(GetConnectionLenght(GetNeuronLayout(m_connections[i].m_source_neuron_idx), GetNeuronLayout(m_connections[i].m_target_neuron_idx)),2);
         }
         //std::cout <<  total << std::endl;
         */
@@ -225,8 +625,73 @@ public:
     // save/load from already opened files for reading/writing
     void Save(FILE* a_file);
     bool Load(std::ifstream& a_DataFile);
+
+    // Saves/loads the binary image of the network (see NetworkImage.h),
+    // with the state of the neurons, the precision and accuracy and whether
+    // the network is compiled. LoadBinary() maps the file, checks the
+    // image and copies its arrays into the neurons and connections, so the
+    // network doesn't refer to the file afterwards (it is not zero-copy).
+    // Both return false on any error.
+    bool SaveBinary(const char* a_filename) const;
+    bool LoadBinary(const char* a_filename);
+
+    // The same image in memory. a_Data needn't be aligned.
+    std::string ToBinary() const;
+    bool FromBinary(const void* a_Data, size_t a_Size);
+    bool FromImage(const NetworkImage& a_Image);
+
+    // Writes the network as standalone C source, with the weights as constants
+    // and one statement per neuron. The functions are named a_Prefix_input(),
+    // a_Prefix_activate() (one step of Activate()), a_Prefix_output() and
+    // a_Prefix_flush() and work on a state array of one double per neuron.
+    // Acyclic networks also get a_Prefix_evaluate(), a complete feed-forward
+    // pass in topological order. Returns false if the file can't be written.
+    // The code computes the activation functions with the C library in
+    // double precision, like the uncompiled network. A network compiled in
+    // single precision or with another accuracy than EXACT_ACTIVATION gives
+    // slightly different results, and the file says so in its header.
+    bool ExportC(const char* a_filename, const char* a_Prefix = "network");
 };
 
+#ifdef USE_BOOST_PYTHON
+
+// Copy values between C++ and a Python sequence of at least as many
+// elements, which contiguous float64/float32 arrays are in one pass.
+// Both throw if the sequence is shorter.
+void ValuesIntoArray_numpy(const std::vector<double>& a_Values, py::numeric::array& a_Array);
+std::vector<double> ArrayValues_numpy(py::numeric::array& a_Array, unsigned int a_Size);
+
+// Pickles the network as its binary image
+struct NeuralNetwork_pickle_suite : py::pickle_suite
+{
+    static py::object getstate(const NeuralNetwork& a)
+    {
+        std::string t_image = a.ToBinary();
+#if PY_MAJOR_VERSION >= 3
+        return py::object(py::handle<>(PyBytes_FromStringAndSize(t_image.data(), t_image.size())));
+#else
+        return py::str(t_image.data(), t_image.size());
+#endif
+    }
+
+    static void setstate(NeuralNetwork& a, py::object entries)
+    {
+        Py_buffer t_view;
+        if (PyObject_GetBuffer(entries.ptr(), &t_view, PyBUF_SIMPLE) != 0)
+            py::throw_error_already_set();
+
+        bool t_loaded = a.FromBinary(t_view.buf, static_cast<size_t>(t_view.len));
+        PyBuffer_Release(&t_view);
+        if (!t_loaded)
+        {
+            PyErr_SetString(PyExc_ValueError, "not a network image of this version");
+            py::throw_error_already_set();
+        }
+    }
+};
+
+#endif
+
 }; // namespace NEAT
 
 
@@ -0,0 +1,235 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        PackedPopulation.cpp
+// Description: Implementation of the packed population.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "PackedPopulation.h"
+#include "Genome.h"
+#include "Population.h"
+
+namespace NEAT
+{
+
+PackedPopulation::PackedPopulation()
+{
+    Clear();
+}
+
+void PackedPopulation::Clear()
+{
+    m_num_networks = m_num_inputs = m_num_outputs = 0;
+    m_compiled.Clear();
+    m_output_slot.clear();
+    m_outputs.clear();
+}
+
+void PackedPopulation::Build(const std::vector<Genome>& a_Genomes)
+{
+    std::vector<NeuralNetwork> t_networks(a_Genomes.size());
+    for (unsigned int i = 0; i < a_Genomes.size(); i++)
+    {
+        a_Genomes[i].BuildPhenotype(t_networks[i]);
+    }
+    Build(t_networks);
+}
+
+void PackedPopulation::Build(const Population& a_Population)
+{
+    std::vector<NeuralNetwork> t_networks;
+    for (unsigned int i = 0; i < a_Population.m_Species.size(); i++)
+    {
+        const std::vector<Genome>& t_individuals = a_Population.m_Species[i].m_Individuals;
+        for (unsigned int j = 0; j < t_individuals.size(); j++)
+        {
+            t_networks.push_back(NeuralNetwork());
+            t_individuals[j].BuildPhenotype(t_networks.back());
+        }
+    }
+    Build(t_networks);
+}
+
+void PackedPopulation::Build(const std::vector<NeuralNetwork>& a_Networks)
+{
+    Clear();
+    if (a_Networks.empty())
+        return;
+
+    m_num_networks = static_cast<unsigned int>(a_Networks.size());
+    m_num_inputs = a_Networks[0].NumInputs();
+    m_num_outputs = a_Networks[0].NumOutputs();
+
+    // The inputs of the first network stand for the shared ones
+    std::vector<Neuron> t_neurons(a_Networks[0].m_neurons.begin(),
+                                  a_Networks[0].m_neurons.begin() + m_num_inputs);
+    std::vector<Connection> t_connections;
+    std::vector<unsigned int> t_output_neuron;
+
+    for (unsigned int n = 0; n < a_Networks.size(); n++)
+    {
+        const NeuralNetwork& t_net = a_Networks[n];
+        if ((t_net.NumInputs() != m_num_inputs) || (t_net.NumOutputs() != m_num_outputs) ||
+            (t_net.m_neurons.size() < m_num_inputs + m_num_outputs))
+        {
+            Clear();
+            throw std::exception();
+        }
+
+        // The network's own neurons follow the ones of the networks before it
+        unsigned int t_base = static_cast<unsigned int>(t_neurons.size()) - m_num_inputs;
+        t_neurons.insert(t_neurons.end(), t_net.m_neurons.begin() + m_num_inputs, t_net.m_neurons.end());
+        for (unsigned int i = 0; i < m_num_outputs; i++)
+        {
+            t_output_neuron.push_back(t_base + m_num_inputs + i);
+        }
+
+        for (unsigned int i = 0; i < t_net.m_connections.size(); i++)
+        {
+            Connection t_c = t_net.m_connections[i];
+            if (t_c.m_source_neuron_idx >= m_num_inputs)
+            {
+                t_c.m_source_neuron_idx += t_base;
+            }
+            if (t_c.m_target_neuron_idx < m_num_inputs)
+                continue; // never used, the inputs are not activated
+
+            t_c.m_target_neuron_idx += t_base;
+            t_connections.push_back(t_c);
+        }
+    }
+
+    m_compiled.Build(t_neurons, t_connections, m_num_inputs, 0);
+    m_compiled.Flush();
+
+    m_output_slot.resize(t_output_neuron.size());
+    for (unsigned int i = 0; i < t_output_neuron.size(); i++)
+    {
+        m_output_slot[i] = m_compiled.m_slot[t_output_neuron[i]];
+    }
+}
+
+void PackedPopulation::Activate()
+{
+    m_compiled.Activate();
+}
+
+void PackedPopulation::ActivateUseInternalBias()
+{
+    m_compiled.ActivateUseInternalBias();
+}
+
+void PackedPopulation::ActivateLeaky(double a_step)
+{
+    m_compiled.ActivateLeaky(a_step);
+}
+
+void PackedPopulation::ActivateTopological(unsigned int a_RecurrentIterations)
+{
+    m_compiled.ActivateTopological(a_RecurrentIterations);
+}
+
+void PackedPopulation::Flush()
+{
+    m_compiled.Flush();
+}
+
+void PackedPopulation::Input(const std::vector<double>& a_Inputs)
+{
+    if (a_Inputs.size() != m_num_inputs)
+        throw std::exception();
+
+    if (!a_Inputs.empty())
+    {
+        InputFrom(&a_Inputs[0]);
+    }
+}
+
+void PackedPopulation::InputFrom(const double* a_Inputs)
+{
+    if (m_num_networks > 0)
+    {
+        m_compiled.Input(a_Inputs);
+    }
+}
+
+std::vector<double> PackedPopulation::Output(unsigned int a_Network) const
+{
+    std::vector<double> t_outputs(m_num_outputs);
+    if (m_num_outputs > 0)
+    {
+        OutputInto(a_Network, &t_outputs[0]);
+    }
+    return t_outputs;
+}
+
+void PackedPopulation::OutputInto(unsigned int a_Network, double* a_Outputs) const
+{
+    if (a_Network >= m_num_networks)
+        throw std::exception();
+
+    const unsigned int* t_slot = &m_output_slot[a_Network * m_num_outputs];
+    for (unsigned int i = 0; i < m_num_outputs; i++)
+    {
+        a_Outputs[i] = m_compiled.m_state.m_activation[t_slot[i]];
+    }
+}
+
+const double* PackedPopulation::Outputs()
+{
+    m_outputs.resize(m_output_slot.size());
+    for (unsigned int i = 0; i < m_output_slot.size(); i++)
+    {
+        m_outputs[i] = m_compiled.m_state.m_activation[m_output_slot[i]];
+    }
+    return m_outputs.empty() ? NULL : &m_outputs[0];
+}
+
+#ifdef USE_BOOST_PYTHON
+
+void PackedPopulation::Build_python_list(py::list& a_Genomes)
+{
+    int len = py::len(a_Genomes);
+    std::vector<Genome> t_genomes;
+    t_genomes.reserve(len);
+    for(int i=0; i<len; i++)
+        t_genomes.push_back(py::extract<Genome&>(a_Genomes[i]));
+
+    Build(t_genomes);
+}
+
+void PackedPopulation::Input_python_list(py::list& a_Inputs)
+{
+    int len = py::len(a_Inputs);
+    std::vector<double> t_inputs(m_num_inputs, 0.0);
+    for(int i=0; i<len && i<static_cast<int>(m_num_inputs); i++)
+        t_inputs[i] = py::extract<double>(a_Inputs[i]);
+
+    Input(t_inputs);
+}
+
+#endif
+
+} // namespace NEAT
@@ -0,0 +1,131 @@
+#ifndef _PACKED_POPULATION_H
+#define _PACKED_POPULATION_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        PackedPopulation.h
+// Description: Many phenotypes packed into one compiled network.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include "NeuralNetwork.h"
+#include "CompiledNetwork.h"
+
+namespace NEAT
+{
+
+class Genome;
+class Population;
+
+//////////////////////////////////////////////////////////////////
+// A packed population.
+//
+// The phenotypes of many genomes, compiled together into a single
+// network that is block-diagonal except for the inputs, which all
+// the phenotypes share. One activation step then advances every
+// phenotype in one pass over the connections, with the neurons of
+// all phenotypes grouped by level and activation function as in a
+// compiled network (see CompiledNetwork.h).
+//
+// Each phenotype computes what it would on its own after Flush(),
+// given the same inputs and the same activation steps.
+// All of them must have the same numbers of inputs and outputs.
+//////////////////////////////////////////////////////////////////
+
+class PackedPopulation
+{
+    unsigned int m_num_networks, m_num_inputs, m_num_outputs;
+
+    // All the phenotypes in one network. Its first neurons are the
+    // inputs, then come the other neurons of every phenotype in turn.
+    CompiledNetwork m_compiled;
+
+    // The slots of the outputs, [network][output]
+    std::vector<unsigned int> m_output_slot;
+
+    // The outputs of all networks as Outputs() returns them
+    std::vector<double> m_outputs;
+
+public:
+
+    PackedPopulation();
+
+    // Packs the phenotypes of the genomes
+    void Build(const std::vector<Genome>& a_Genomes);
+
+    // Packs the phenotypes of all individuals of the population,
+    // species by species, in the order of the individuals in each species
+    void Build(const Population& a_Population);
+
+    // Packs the given phenotypes
+    void Build(const std::vector<NeuralNetwork>& a_Networks);
+
+    void Clear();
+
+    unsigned int NumNetworks() const
+    {
+        return m_num_networks;
+    }
+    unsigned int NumInputs() const
+    {
+        return m_num_inputs;
+    }
+    unsigned int NumOutputs() const
+    {
+        return m_num_outputs;
+    }
+
+    // Same as the NeuralNetwork methods of the same name, for all networks at once
+    void Activate();
+    void ActivateUseInternalBias();
+    void ActivateLeaky(double a_step);
+    void ActivateTopological(unsigned int a_RecurrentIterations = 1);
+    void Flush();
+
+    // The inputs are shared by all networks
+    void Input(const std::vector<double>& a_Inputs);
+    void InputFrom(const double* a_Inputs);
+
+    // The outputs of network a_Network
+    std::vector<double> Output(unsigned int a_Network) const;
+    void OutputInto(unsigned int a_Network, double* a_Outputs) const;
+
+    // Returns the outputs of all networks, the ones of network i at
+    // [i * NumOutputs() .. (i + 1) * NumOutputs()). Valid until Outputs()
+    // is called again.
+    const double* Outputs();
+
+#ifdef USE_BOOST_PYTHON
+
+    void Build_python_list(py::list& a_Genomes);
+    void Input_python_list(py::list& a_Inputs);
+
+#endif
+};
+
+} // namespace NEAT
+
+#endif
@@ -36,6 +36,7 @@
 #include "Genes.h"
 #include "Genome.h"
 #include "Population.h"
+#include "PackedPopulation.h"
 #include "Species.h"
 #include "Parameters.h"
 #include "Random.h"
@@ -44,6 +45,131 @@ namespace py = boost::python;
 using namespace NEAT;
 using namespace py;
 
+// The bulk getters and setters (GetWeights(), SetWeights() etc.) with a
+// NumPy array, or any sequence of at least a_Size() elements, for the values
+template <class C, void (C::*a_Get)(double*) const, unsigned int (C::*a_Size)() const>
+void GetValues_numpy(const C& a_Object, numeric::array& a_Array)
+{
+    std::vector<double> t_values((a_Object.*a_Size)() + 1);
+    (a_Object.*a_Get)(&t_values[0]);
+    t_values.pop_back();
+    ValuesIntoArray_numpy(t_values, a_Array);
+}
+
+template <class C, void (C::*a_Set)(const double*), unsigned int (C::*a_Size)() const>
+void SetValues_numpy(C& a_Object, numeric::array& a_Array)
+{
+    std::vector<double> t_values = ArrayValues_numpy(a_Array, (a_Object.*a_Size)());
+    t_values.push_back(0);
+    (a_Object.*a_Set)(&t_values[0]);
+}
+
+// Python sees the neurons and connections of a network with the fields of
+// their side tables (NeuronLayout, ConnectionLearning) as if they were
+// their own, through these references to a network and an index. Reading
+// a field of a side table the network doesn't have gives the default and
+// doesn't allocate it.
+class NeuronRef
+{
+public:
+    typedef Neuron ItemType;
+    typedef NeuronLayout SideType;
+
+    NeuralNetwork* m_net;
+    unsigned int m_idx;
+
+    static unsigned int Count(const NeuralNetwork& a_Net) { return a_Net.NumNeurons(); }
+
+    Neuron& Item() const
+    {
+        if (m_idx >= m_net->NumNeurons())
+            throw std::out_of_range("the neuron is no longer in the network");
+        return m_net->m_neurons[m_idx];
+    }
+    const NeuronLayout& Side() const { Item(); return m_net->GetNeuronLayout(m_idx); }
+    NeuronLayout& SideAt() const { Item(); return m_net->NeuronLayoutAt(m_idx); }
+};
+
+class ConnectionRef
+{
+public:
+    typedef Connection ItemType;
+    typedef ConnectionLearning SideType;
+
+    NeuralNetwork* m_net;
+    unsigned int m_idx;
+
+    static unsigned int Count(const NeuralNetwork& a_Net) { return a_Net.NumConnections(); }
+
+    Connection& Item() const
+    {
+        if (m_idx >= m_net->NumConnections())
+            throw std::out_of_range("the connection is no longer in the network");
+        return m_net->m_connections[m_idx];
+    }
+    const ConnectionLearning& Side() const { Item(); return m_net->GetConnectionLearning(m_idx); }
+    ConnectionLearning& SideAt() const { Item(); return m_net->ConnectionLearningAt(m_idx); }
+};
+
+// The sequence of the neurons or connections of a network (NeuralNetwork.neurons
+// and .connections), indexed like a list
+template <class R>
+class RefList
+{
+public:
+    NeuralNetwork* m_net;
+
+    unsigned int Size() const { return R::Count(*m_net); }
+
+    R Get(int a_idx) const
+    {
+        int t_size = static_cast<int>(Size());
+        if (a_idx < 0)
+            a_idx += t_size;
+        if ((a_idx < 0) || (a_idx >= t_size))
+            throw std::out_of_range("index out of range");
+
+        R t_ref;
+        t_ref.m_net = m_net;
+        t_ref.m_idx = static_cast<unsigned int>(a_idx);
+        return t_ref;
+    }
+};
+
+template <class R>
+RefList<R> NetworkRefList(NeuralNetwork& a_Net)
+{
+    RefList<R> t_list;
+    t_list.m_net = &a_Net;
+    return t_list;
+}
+
+// The properties of the references, a_Field of the neuron or connection or
+// of its side table entry
+template <class R, class T, T R::ItemType::*a_Field>
+T GetItemField(const R& a_Ref) { return a_Ref.Item().*a_Field; }
+
+template <class R, class T, T R::ItemType::*a_Field>
+void SetItemField(const R& a_Ref, T a_Value) { a_Ref.Item().*a_Field = a_Value; }
+
+template <class R, class T, T R::SideType::*a_Field>
+T GetSideField(const R& a_Ref) { return a_Ref.Side().*a_Field; }
+
+template <class R, class T, T R::SideType::*a_Field>
+void SetSideField(const R& a_Ref, T a_Value) { a_Ref.SideAt().*a_Field = a_Value; }
+
+template <class R, class T, T R::ItemType::*a_Field>
+void ItemProperty(class_<R>& a_Class, const char* a_Name)
+{
+    a_Class.add_property(a_Name, &GetItemField<R, T, a_Field>, &SetItemField<R, T, a_Field>);
+}
+
+template <class R, class T, T R::SideType::*a_Field>
+void SideProperty(class_<R>& a_Class, const char* a_Name)
+{
+    a_Class.add_property(a_Name, &GetSideField<R, T, a_Field>, &SetSideField<R, T, a_Field>);
+}
+
 
 BOOST_PYTHON_MODULE(_MultiNEAT)
 {
@@ -84,6 +210,39 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
         .value("BLENDED", BLENDED)
         ;
 
+    enum_<Precision>("Precision")
+        .value("DOUBLE_PRECISION", DOUBLE_PRECISION)
+        .value("SINGLE_PRECISION", SINGLE_PRECISION)
+        ;
+
+    enum_<ActivationAccuracy>("ActivationAccuracy")
+        .value("EXACT_ACTIVATION", EXACT_ACTIVATION)
+        .value("FAST_ACTIVATION", FAST_ACTIVATION)
+        .value("TABLE_ACTIVATION", TABLE_ACTIVATION)
+        .value("VECTOR_ACTIVATION", VECTOR_ACTIVATION)
+        ;
+
+    enum_<ActivationBackend>("ActivationBackend")
+        .value("INTERPRETED_BACKEND", INTERPRETED_BACKEND)
+        .value("CSR_BACKEND", CSR_BACKEND)
+        .value("PARALLEL_CSR_BACKEND", PARALLEL_CSR_BACKEND)
+        .value("PROGRAM_BACKEND", PROGRAM_BACKEND)
+        .value("FIXED_BACKEND", FIXED_BACKEND)
+        ;
+
+    def("ActivationBackendName", &ActivationBackendName);
+
+    class_<BackendProfile>("BackendProfile", init<>())
+            .def_readwrite("program_max_neurons", &BackendProfile::m_program_max_neurons)
+            .def_readwrite("parallel_min_connections", &BackendProfile::m_parallel_min_connections)
+            .def("Calibrate", &BackendProfile::Calibrate)
+            .def("Save", &BackendProfile::Save)
+            .def("Load", &BackendProfile::Load)
+            ;
+
+    // the profile the networks use, changes to it apply to networks compiled after
+    def("GetBackendProfile", &BackendProfile::Active, return_value_policy<reference_existing_object>());
+
 
 ///////////////////////////////////////////////////////////////////
 // RNG class
@@ -108,9 +267,12 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def_readwrite("source_neuron_idx", &Connection::m_source_neuron_idx)
             .def_readwrite("target_neuron_idx", &Connection::m_target_neuron_idx)
             .def_readwrite("weight", &Connection::m_weight)
-            .def_readwrite("recur_flag", &Connection::m_recur_flag)
-            .def_readwrite("hebb_rate", &Connection::m_hebb_rate)
-            .def_readwrite("hebb_pre_rate", &Connection::m_hebb_pre_rate)
+            ;
+
+    class_<ConnectionLearning>("ConnectionLearning", init<>())
+            .def_readwrite("recur_flag", &ConnectionLearning::m_recur_flag)
+            .def_readwrite("hebb_rate", &ConnectionLearning::m_hebb_rate)
+            .def_readwrite("hebb_pre_rate", &ConnectionLearning::m_hebb_pre_rate)
             ;
 
     class_<Neuron>("Neuron", init<>())
@@ -120,22 +282,97 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def_readwrite("bias", &Neuron::m_bias)
             .def_readwrite("activation", &Neuron::m_activation)
             .def_readwrite("activation_function_type", &Neuron::m_activation_function_type)
-            .def_readwrite("split_y", &Neuron::m_split_y)
             .def_readwrite("type", &Neuron::m_type)
-            .def_readwrite("x", &Neuron::m_x)
-            .def_readwrite("y", &Neuron::m_y)
-            .def_readwrite("z", &Neuron::m_z)
-            .def_readwrite("substrate_coords", &Neuron::m_substrate_coords)
+            ;
+
+    class_<NeuronLayout>("NeuronLayout", init<>())
+            .def_readwrite("split_y", &NeuronLayout::m_split_y)
+            .def_readwrite("x", &NeuronLayout::m_x)
+            .def_readwrite("y", &NeuronLayout::m_y)
+            .def_readwrite("z", &NeuronLayout::m_z)
+            .def_readwrite("substrate_coords", &NeuronLayout::m_substrate_coords)
+            ;
+
+    // The elements of NeuralNetwork.neurons and .connections, with the
+    // fields of the side tables as well
+    class_<ConnectionRef> t_connection_ref("ConnectionRef", no_init);
+    ItemProperty<ConnectionRef, unsigned int, &Connection::m_source_neuron_idx>(t_connection_ref, "source_neuron_idx");
+    ItemProperty<ConnectionRef, unsigned int, &Connection::m_target_neuron_idx>(t_connection_ref, "target_neuron_idx");
+    ItemProperty<ConnectionRef, double, &Connection::m_weight>(t_connection_ref, "weight");
+    SideProperty<ConnectionRef, bool, &ConnectionLearning::m_recur_flag>(t_connection_ref, "recur_flag");
+    SideProperty<ConnectionRef, double, &ConnectionLearning::m_hebb_rate>(t_connection_ref, "hebb_rate");
+    SideProperty<ConnectionRef, double, &ConnectionLearning::m_hebb_pre_rate>(t_connection_ref, "hebb_pre_rate");
+
+    class_<NeuronRef> t_neuron_ref("NeuronRef", no_init);
+    ItemProperty<NeuronRef, double, &Neuron::m_a>(t_neuron_ref, "a");
+    ItemProperty<NeuronRef, double, &Neuron::m_b>(t_neuron_ref, "b");
+    ItemProperty<NeuronRef, double, &Neuron::m_timeconst>(t_neuron_ref, "time_const");
+    ItemProperty<NeuronRef, double, &Neuron::m_bias>(t_neuron_ref, "bias");
+    ItemProperty<NeuronRef, double, &Neuron::m_activation>(t_neuron_ref, "activation");
+    ItemProperty<NeuronRef, ActivationFunction, &Neuron::m_activation_function_type>(t_neuron_ref, "activation_function_type");
+    ItemProperty<NeuronRef, NeuronType, &Neuron::m_type>(t_neuron_ref, "type");
+    SideProperty<NeuronRef, double, &NeuronLayout::m_split_y>(t_neuron_ref, "split_y");
+    SideProperty<NeuronRef, double, &NeuronLayout::m_x>(t_neuron_ref, "x");
+    SideProperty<NeuronRef, double, &NeuronLayout::m_y>(t_neuron_ref, "y");
+    SideProperty<NeuronRef, double, &NeuronLayout::m_z>(t_neuron_ref, "z");
+    SideProperty<NeuronRef, std::vector<double>, &NeuronLayout::m_substrate_coords>(t_neuron_ref, "substrate_coords");
+
+    // they keep the list alive, which keeps the network alive
+    class_< RefList<NeuronRef> >("NeuronList", no_init)
+            .def("__len__", &RefList<NeuronRef>::Size)
+            .def("__getitem__", &RefList<NeuronRef>::Get, with_custodian_and_ward_postcall<0, 1>())
+            ;
+
+    class_< RefList<ConnectionRef> >("ConnectionList", no_init)
+            .def("__len__", &RefList<ConnectionRef>::Size)
+            .def("__getitem__", &RefList<ConnectionRef>::Get, with_custodian_and_ward_postcall<0, 1>())
+            ;
+
+    class_<OptimizationReport>("OptimizationReport", init<>())
+            .def_readonly("small_connections", &OptimizationReport::m_small_connections)
+            .def_readonly("folded_neurons", &OptimizationReport::m_folded_neurons)
+            .def_readonly("folded_connections", &OptimizationReport::m_folded_connections)
+            .def_readonly("added_connections", &OptimizationReport::m_added_connections)
+            .def_readonly("dead_neurons", &OptimizationReport::m_dead_neurons)
+            .def_readonly("dead_connections", &OptimizationReport::m_dead_connections)
             ;
 
     void (NeuralNetwork::*NN_Save)(const char*) = &NeuralNetwork::Save;
+    void (NeuralNetwork::*NN_AddNeuron)(const Neuron&) = &NeuralNetwork::AddNeuron;
+    void (NeuralNetwork::*NN_AddNeuron_layout)(const Neuron&, const NeuronLayout&) = &NeuralNetwork::AddNeuron;
+    void (NeuralNetwork::*NN_AddConnection)(const Connection&) = &NeuralNetwork::AddConnection;
+    void (NeuralNetwork::*NN_AddConnection_learning)(const Connection&, const ConnectionLearning&) =
+            &NeuralNetwork::AddConnection;
     bool (NeuralNetwork::*NN_Load)(const char*) = &NeuralNetwork::Load;
     void (Genome::*Genome_Save)(const char*) = &Genome::Save;
     void (NeuralNetwork::*NN_Input)(list&) = &NeuralNetwork::Input_python_list;
     void (NeuralNetwork::*NN_Input_numpy)(numeric::array&) = &NeuralNetwork::Input_numpy;
+
+    // the state-less and the per-state (NeuralNetworkState) overloads
+    void (NeuralNetwork::*NN_Activate)() = &NeuralNetwork::Activate;
+    void (NeuralNetwork::*NN_Activate_state)(NeuralNetworkState&) const = &NeuralNetwork::Activate;
+    void (NeuralNetwork::*NN_ActivateUseInternalBias)() = &NeuralNetwork::ActivateUseInternalBias;
+    void (NeuralNetwork::*NN_ActivateUseInternalBias_state)(NeuralNetworkState&) const = &NeuralNetwork::ActivateUseInternalBias;
+    void (NeuralNetwork::*NN_ActivateLeaky)(double) = &NeuralNetwork::ActivateLeaky;
+    void (NeuralNetwork::*NN_ActivateLeaky_state)(NeuralNetworkState&, double) const = &NeuralNetwork::ActivateLeaky;
+    void (NeuralNetwork::*NN_ActivateTopological)(unsigned int) = &NeuralNetwork::ActivateTopological;
+    void (NeuralNetwork::*NN_ActivateTopological_state)(NeuralNetworkState&, unsigned int) const = &NeuralNetwork::ActivateTopological;
+    void (NeuralNetwork::*NN_ActivateDelta)(double) = &NeuralNetwork::ActivateDelta;
+    void (NeuralNetwork::*NN_ActivateDelta_state)(NeuralNetworkState&, double) const = &NeuralNetwork::ActivateDelta;
+    void (NeuralNetwork::*NN_Flush)() = &NeuralNetwork::Flush;
+    void (NeuralNetwork::*NN_Flush_state)(NeuralNetworkState&) const = &NeuralNetwork::Flush;
+    std::vector<double> (NeuralNetwork::*NN_Output)() = &NeuralNetwork::Output;
+    std::vector<double> (NeuralNetwork::*NN_Output_state)(const NeuralNetworkState&) const = &NeuralNetwork::Output;
+    void (NeuralNetwork::*NN_RTRL_update_error)(double) = &NeuralNetwork::RTRL_update_error;
+    void (Genome::*Genome_BuildPhenotype)(NeuralNetwork&) const = &Genome::BuildPhenotype;
+    void (Genome::*Genome_BuildPhenotype_Compiled)(NeuralNetwork&, bool) const = &Genome::BuildPhenotype;
     void (Parameters::*Parameters_Save)(const char*) = &Parameters::Save;
     int (Parameters::*Parameters_Load)(const char*) = &Parameters::Load;
 
+    class_<NeuralNetworkState>("NeuralNetworkState", init<>())
+            .def(init<const NeuralNetworkState&>())
+            ;
+
     class_<NeuralNetwork>("NeuralNetwork", init<>())
 
             .def(init<bool>())
@@ -145,24 +382,88 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def("RTRL_update_gradients",
             &NeuralNetwork::RTRL_update_gradients)
             .def("RTRL_update_error",
-            &NeuralNetwork::RTRL_update_error)
+            NN_RTRL_update_error)
+            .def("RTRL_update_error",
+            &NeuralNetwork::RTRL_update_error_python_list)
             .def("RTRL_update_weights",
             &NeuralNetwork::RTRL_update_weights)
 
             .def("ActivateFast",
             &NeuralNetwork::ActivateFast)
             .def("Activate",
-            &NeuralNetwork::Activate)
+            NN_Activate)
+            .def("Activate",
+            NN_Activate_state)
             .def("ActivateUseInternalBias",
-            &NeuralNetwork::ActivateUseInternalBias)
+            NN_ActivateUseInternalBias)
+            .def("ActivateUseInternalBias",
+            NN_ActivateUseInternalBias_state)
+            .def("ActivateLeaky",
+            NN_ActivateLeaky)
             .def("ActivateLeaky",
-            &NeuralNetwork::ActivateLeaky)
+            NN_ActivateLeaky_state)
+            .def("ActivateTopological",
+            NN_ActivateTopological,
+            (arg("a_RecurrentIterations") = 1))
+            .def("ActivateTopological",
+            NN_ActivateTopological_state,
+            (arg("a_State"), arg("a_RecurrentIterations") = 1))
+            .def("ActivateDelta",
+            NN_ActivateDelta,
+            (arg("a_Epsilon") = 0.0))
+            .def("ActivateDelta",
+            NN_ActivateDelta_state,
+            (arg("a_State"), arg("a_Epsilon") = 0.0))
+            .def("IsAcyclic",
+            &NeuralNetwork::IsAcyclic)
+            .def("SettlingDepth",
+            &NeuralNetwork::SettlingDepth)
+            .def("ActivateBatch",
+            &NeuralNetwork::ActivateBatch_python_list)
+            .def("Backprop",
+            &NeuralNetwork::Backprop_python_list)
+            .def("BPTT",
+            &NeuralNetwork::BPTT_python_list)
+
+            .def("Compile",
+            &NeuralNetwork::Compile)
+            .def("Decompile",
+            &NeuralNetwork::Decompile)
+            .def("UpdateParameters",
+            &NeuralNetwork::UpdateParameters)
+            .def("IsCompiled",
+            &NeuralNetwork::IsCompiled)
+            .def("IsOptimized",
+            &NeuralNetwork::IsOptimized)
+            .def("SetPrecision",
+            &NeuralNetwork::SetPrecision)
+            .def("GetPrecision",
+            &NeuralNetwork::GetPrecision)
+            .def("SetActivationAccuracy",
+            &NeuralNetwork::SetActivationAccuracy)
+            .def("GetActivationAccuracy",
+            &NeuralNetwork::GetActivationAccuracy)
+            .def("SetNumThreads",
+            &NeuralNetwork::SetNumThreads)
+            .def("GetNumThreads",
+            &NeuralNetwork::GetNumThreads)
+            .def("GetBackend",
+            &NeuralNetwork::GetBackend)
+            .def("SelectBackend",
+            &NeuralNetwork::SelectBackend)
+            .def("Optimize",
+            &NeuralNetwork::Optimize,
+            (arg("a_WeightEpsilon") = 0.0, arg("a_BiasValue") = 1.0, arg("a_UseInternalBias") = false))
+            .def("ReorderHiddenNeurons",
+            &NeuralNetwork::ReorderHiddenNeurons)
 
             .def("Adapt",
             &NeuralNetwork::Adapt)
 
             .def("Flush",
-            &NeuralNetwork::Flush)
+            NN_Flush)
+            .def("Flush",
+            NN_Flush_state)
             .def("FlushCude",
             &NeuralNetwork::InitRTRLMatrix)
 
@@ -177,26 +478,77 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             NN_Save)
             .def("Load",
             NN_Load)
+            .def("SaveBinary",
+            &NeuralNetwork::SaveBinary)
+            .def("LoadBinary",
+            &NeuralNetwork::LoadBinary)
+            .def("ExportC",
+            &NeuralNetwork::ExportC,
+            (arg("a_filename"), arg("a_Prefix") = "network"))
 
             .def("Input",
             NN_Input)
             .def("Input",
             NN_Input_numpy)
+            .def("Input",
+            &NeuralNetwork::Input_state_python_list)
+
+            .def("NewState",
+            &NeuralNetwork::NewState)
+            .def("CloneState",
+            &NeuralNetwork::CloneState)
+            .def("RestoreState",
+            &NeuralNetwork::RestoreState)
             .def("Output",
-            &NeuralNetwork::Output)
+            NN_Output)
+            .def("Output",
+            NN_Output_state)
+            .def("OutputInto",
+            &NeuralNetwork::OutputInto_numpy)
             
             .def("AddNeuron",
-            &NeuralNetwork::AddNeuron)
+            NN_AddNeuron)
+            .def("AddNeuron",
+            NN_AddNeuron_layout)
             .def("AddConnection",
-            &NeuralNetwork::AddConnection)
+            NN_AddConnection)
+            .def("AddConnection",
+            NN_AddConnection_learning)
             .def("SetInputOutputDimentions",
             &NeuralNetwork::SetInputOutputDimentions)
 
             .def("GetTotalConnectionLength", &NeuralNetwork::GetTotalConnectionLength)
 
-
-            .def_readwrite("neurons", &NeuralNetwork::m_neurons)
-            .def_readwrite("connections", &NeuralNetwork::m_connections)
+            .def("NumNeurons", &NeuralNetwork::NumNeurons)
+            .def("NumConnections", &NeuralNetwork::NumConnections)
+            .def("GetWeights",
+            &GetValues_numpy<NeuralNetwork, &NeuralNetwork::GetWeights, &NeuralNetwork::NumConnections>)
+            .def("SetWeights",
+            &SetValues_numpy<NeuralNetwork, &NeuralNetwork::SetWeights, &NeuralNetwork::NumConnections>)
+            .def("GetBiases",
+            &GetValues_numpy<NeuralNetwork, &NeuralNetwork::GetBiases, &NeuralNetwork::NumNeurons>)
+            .def("SetBiases",
+            &SetValues_numpy<NeuralNetwork, &NeuralNetwork::SetBiases, &NeuralNetwork::NumNeurons>)
+            .def("GetTimeConstants",
+            &GetValues_numpy<NeuralNetwork, &NeuralNetwork::GetTimeConstants, &NeuralNetwork::NumNeurons>)
+            .def("SetTimeConstants",
+            &SetValues_numpy<NeuralNetwork, &NeuralNetwork::SetTimeConstants, &NeuralNetwork::NumNeurons>)
+            .def("GetActivationA",
+            &GetValues_numpy<NeuralNetwork, &NeuralNetwork::GetActivationA, &NeuralNetwork::NumNeurons>)
+            .def("SetActivationA",
+            &SetValues_numpy<NeuralNetwork, &NeuralNetwork::SetActivationA, &NeuralNetwork::NumNeurons>)
+            .def("GetActivationB",
+            &GetValues_numpy<NeuralNetwork, &NeuralNetwork::GetActivationB, &NeuralNetwork::NumNeurons>)
+            .def("SetActivationB",
+            &SetValues_numpy<NeuralNetwork, &NeuralNetwork::SetActivationB, &NeuralNetwork::NumNeurons>)
+
+
+            .add_property("neurons",
+            make_function(&NetworkRefList<NeuronRef>, with_custodian_and_ward_postcall<0, 1>()))
+            .add_property("connections",
+            make_function(&NetworkRefList<ConnectionRef>, with_custodian_and_ward_postcall<0, 1>()))
+
+            .def_pickle(NeuralNetwork_pickle_suite())
             ;
 
 
@@ -224,12 +576,25 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def("GetID", &Genome::GetID)
             .def("GetDepth", &Genome::GetDepth)
             .def("CalculateDepth", &Genome::CalculateDepth)
-            .def("BuildPhenotype", &Genome::BuildPhenotype)
+            .def("BuildPhenotype", Genome_BuildPhenotype)
+            .def("BuildPhenotype", Genome_BuildPhenotype_Compiled)
+            .def("UpdatePhenotype", &Genome::UpdatePhenotype)
             .def("DerivePhenotypicChanges", &Genome::DerivePhenotypicChanges)
             .def("BuildHyperNEATPhenotype", &Genome::BuildHyperNEATPhenotype)
             
              .def("Randomize_LinkWeights", &Genome::Randomize_LinkWeights)
 
+            .def("GetWeights", &GetValues_numpy<Genome, &Genome::GetWeights, &Genome::NumLinks>)
+            .def("SetWeights", &SetValues_numpy<Genome, &Genome::SetWeights, &Genome::NumLinks>)
+            .def("GetBiases", &GetValues_numpy<Genome, &Genome::GetBiases, &Genome::NumNeurons>)
+            .def("SetBiases", &SetValues_numpy<Genome, &Genome::SetBiases, &Genome::NumNeurons>)
+            .def("GetTimeConstants", &GetValues_numpy<Genome, &Genome::GetTimeConstants, &Genome::NumNeurons>)
+            .def("SetTimeConstants", &SetValues_numpy<Genome, &Genome::SetTimeConstants, &Genome::NumNeurons>)
+            .def("GetActivationA", &GetValues_numpy<Genome, &Genome::GetActivationA, &Genome::NumNeurons>)
+            .def("SetActivationA", &SetValues_numpy<Genome, &Genome::SetActivationA, &Genome::NumNeurons>)
+            .def("GetActivationB", &GetValues_numpy<Genome, &Genome::GetActivationB, &Genome::NumNeurons>)
+            .def("SetActivationB", &SetValues_numpy<Genome, &Genome::SetActivationB, &Genome::NumNeurons>)
+
             .def("IsEvaluated", &Genome::IsEvaluated)
             .def("SetEvaluated", &Genome::SetEvaluated)
             .def("ResetEvaluated", &Genome::ResetEvaluated)
@@ -283,6 +648,7 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
 			.def_readwrite("m_query_weights_only", &Substrate::m_query_weights_only)
             .def_readwrite("m_hidden_nodes_activation", &Substrate::m_hidden_nodes_activation)
             .def_readwrite("m_output_nodes_activation", &Substrate::m_output_nodes_activation)
+            .def_readwrite("m_cppn_activation_accuracy", &Substrate::m_cppn_activation_accuracy)
 
             .def_readwrite("m_allow_input_hidden_links", &Substrate::m_allow_input_hidden_links)
             .def_readwrite("m_allow_input_output_links", &Substrate::m_allow_input_output_links)
@@ -344,6 +710,29 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def_readwrite("RNG", &Population::m_RNG)
             ;
 
+///////////////////////////////////////////////////////////////////
+// PackedPopulation class
+///////////////////////////////////////////////////////////////////
+
+    void (PackedPopulation::*PP_Build_Population)(const Population&) = &PackedPopulation::Build;
+
+    class_<PackedPopulation>("PackedPopulation", init<>())
+            .def("Build", PP_Build_Population)
+            .def("Build", &PackedPopulation::Build_python_list)
+            .def("Clear", &PackedPopulation::Clear)
+            .def("NumNetworks", &PackedPopulation::NumNetworks)
+            .def("NumInputs", &PackedPopulation::NumInputs)
+            .def("NumOutputs", &PackedPopulation::NumOutputs)
+            .def("Activate", &PackedPopulation::Activate)
+            .def("ActivateUseInternalBias", &PackedPopulation::ActivateUseInternalBias)
+            .def("ActivateLeaky", &PackedPopulation::ActivateLeaky)
+            .def("ActivateTopological", &PackedPopulation::ActivateTopological,
+            (arg("a_RecurrentIterations") = 1))
+            .def("Flush", &PackedPopulation::Flush)
+            .def("Input", &PackedPopulation::Input_python_list)
+            .def("Output", &PackedPopulation::Output)
+            ;
+
 ///////////////////////////////////////////////////////////////////
 // Parameters class
 ///////////////////////////////////////////////////////////////////
@@ -506,15 +895,6 @@ BOOST_PYTHON_MODULE(_MultiNEAT)
             .def(vector_indexing_suite< std::vector<Species> >() )
             ;
 
-    // These are necessary to iterate through lists of Neurons and Connections
-    class_< std::vector<Neuron> >("NeuronList")
-            .def(vector_indexing_suite< std::vector<Neuron> >() )
-            ;
-
-    class_< std::vector<Connection> >("ConnectionList")
-            .def(vector_indexing_suite< std::vector<Connection> >() )
-            ;
-
     // For dealing with Phenotype behaviors
     class_< std::vector<PhenotypeBehavior> >("PhenotypeBehaviorList")
             .def(vector_indexing_suite< std::vector<PhenotypeBehavior> >() )
@@ -0,0 +1,516 @@
+#ifndef _SIMD_MATH_H
+#define _SIMD_MATH_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        SimdMath.h
+// Description: Portable SIMD batches and vectorized exp, log, sin and tanh.
+///////////////////////////////////////////////////////////////////////////////
+
+// The instruction set is picked at compile time from the compiler's target
+// flags (e.g. -march=native): AVX-512, AVX2, SSE2 or none. Define
+// NEAT_NO_SIMD to force the scalar code paths.
+//
+// The math functions below assume arguments inside the ranges documented
+// next to them. Callers check the ranges and fall back to the C library for
+// the (rare) batches that contain anything else, including NaNs.
+// Within range, the results are within 3 ulp of the C library's.
+
+#if !defined(NEAT_NO_SIMD)
+#if defined(__AVX512F__)
+#define NEAT_SIMD_AVX512
+#elif defined(__AVX2__)
+#define NEAT_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+#define NEAT_SIMD_SSE2
+#endif
+#endif
+
+#if defined(NEAT_SIMD_AVX512) || defined(NEAT_SIMD_AVX2)
+#include <immintrin.h>
+#define NEAT_SIMD
+#elif defined(NEAT_SIMD_SSE2)
+#include <emmintrin.h>
+#ifdef __SSE4_1__
+#include <smmintrin.h>
+#endif
+#define NEAT_SIMD
+#endif
+
+// GCC 12 takes the _mm512_undefined_*() inside the AVX-512 intrinsics for
+// uninitialized variables, in every function that inlines them
+#if defined(NEAT_SIMD_AVX512) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+namespace NEAT
+{
+
+#ifdef NEAT_SIMD
+
+//////////////////////////////////////////////////////////////////
+// A batch of doubles, as wide as the instruction set allows
+//////////////////////////////////////////////////////////////////
+
+#if defined(NEAT_SIMD_AVX512)
+
+struct DoubleBatch
+{
+    typedef double value_type;
+    typedef __m512d type;
+    typedef __mmask8 mask;
+    enum { size = 8 };
+
+    static type load(const double* p) { return _mm512_loadu_pd(p); }
+    static void store(double* p, type v) { _mm512_storeu_pd(p, v); }
+    static type set1(double v) { return _mm512_set1_pd(v); }
+
+    static type add(type a, type b) { return _mm512_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm512_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm512_div_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm512_fmadd_pd(a, b, c); }
+    static type max(type a, type b) { return _mm512_max_pd(a, b); }
+    static type min(type a, type b) { return _mm512_min_pd(a, b); }
+    static type round(type a) { return _mm512_roundscale_pd(a, _MM_FROUND_TO_NEAREST_INT); }
+    static type bitxor(type a, type b)
+    {
+        return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+    }
+    static type abs(type a)
+    {
+        return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a),
+                                                    _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+    }
+    static type signbit(type a)
+    {
+        return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a),
+                                                    _mm512_set1_epi64(0x8000000000000000LL)));
+    }
+
+    static mask gt(type a, type b) { return _mm512_cmp_pd_mask(a, b, _CMP_GT_OQ); }
+    // true where a is below lo, above hi or NaN
+    static mask outside(type a, type lo, type hi)
+    {
+        return _mm512_cmp_pd_mask(a, lo, _CMP_NGE_UQ) | _mm512_cmp_pd_mask(a, hi, _CMP_NLE_UQ);
+    }
+    static type select(mask m, type a, type b) { return _mm512_mask_blend_pd(m, b, a); }
+    static bool any(mask m) { return m != 0; }
+    static mask none() { return 0; }
+
+    // 2^k for integral k in [-1022, 1023]
+    static type pow2(type k)
+    {
+        __m512i t = _mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(6755399441055744.0)));
+        t = _mm512_slli_epi64(t, 52);
+        return _mm512_castsi512_pd(_mm512_add_epi64(t, _mm512_set1_epi64(1023LL << 52)));
+    }
+    // the sign bit set where the integral k is odd
+    static type oddsign(type k)
+    {
+        __m512i t = _mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(6755399441055744.0)));
+        return _mm512_castsi512_pd(_mm512_slli_epi64(t, 63));
+    }
+    // x = m * 2^e with m in [1, 2), for positive normal x
+    static void frexp(type x, type& m, type& e)
+    {
+        __m512i t = _mm512_castpd_si512(x);
+        __m512i t_exp = _mm512_or_si512(_mm512_srli_epi64(t, 52), _mm512_set1_epi64(0x4330000000000000LL));
+        e = _mm512_sub_pd(_mm512_castsi512_pd(t_exp), _mm512_set1_pd(4503599627370496.0 + 1023.0));
+        m = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(t, _mm512_set1_epi64(0x000FFFFFFFFFFFFFLL)),
+                                                _mm512_set1_epi64(0x3FF0000000000000LL)));
+    }
+};
+
+#elif defined(NEAT_SIMD_AVX2)
+
+struct DoubleBatch
+{
+    typedef double value_type;
+    typedef __m256d type;
+    typedef __m256d mask;
+    enum { size = 4 };
+
+    static type load(const double* p) { return _mm256_loadu_pd(p); }
+    static void store(double* p, type v) { _mm256_storeu_pd(p, v); }
+    static type set1(double v) { return _mm256_set1_pd(v); }
+
+    static type add(type a, type b) { return _mm256_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm256_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm256_div_pd(a, b); }
+#ifdef __FMA__
+    static type fmadd(type a, type b, type c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+    static type fmadd(type a, type b, type c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+    static type max(type a, type b) { return _mm256_max_pd(a, b); }
+    static type min(type a, type b) { return _mm256_min_pd(a, b); }
+    static type round(type a) { return _mm256_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static type bitxor(type a, type b) { return _mm256_xor_pd(a, b); }
+    static type abs(type a) { return _mm256_andnot_pd(_mm256_set1_pd(-0.0), a); }
+    static type signbit(type a) { return _mm256_and_pd(_mm256_set1_pd(-0.0), a); }
+
+    static mask gt(type a, type b) { return _mm256_cmp_pd(a, b, _CMP_GT_OQ); }
+    static mask outside(type a, type lo, type hi)
+    {
+        return _mm256_or_pd(_mm256_cmp_pd(a, lo, _CMP_NGE_UQ), _mm256_cmp_pd(a, hi, _CMP_NLE_UQ));
+    }
+    static type select(mask m, type a, type b) { return _mm256_blendv_pd(b, a, m); }
+    static bool any(mask m) { return _mm256_movemask_pd(m) != 0; }
+    static mask none() { return _mm256_setzero_pd(); }
+
+    static type pow2(type k)
+    {
+        __m256i t = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(6755399441055744.0)));
+        t = _mm256_slli_epi64(t, 52);
+        return _mm256_castsi256_pd(_mm256_add_epi64(t, _mm256_set1_epi64x(1023LL << 52)));
+    }
+    static type oddsign(type k)
+    {
+        __m256i t = _mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(6755399441055744.0)));
+        return _mm256_castsi256_pd(_mm256_slli_epi64(t, 63));
+    }
+    static void frexp(type x, type& m, type& e)
+    {
+        __m256i t = _mm256_castpd_si256(x);
+        __m256i t_exp = _mm256_or_si256(_mm256_srli_epi64(t, 52), _mm256_set1_epi64x(0x4330000000000000LL));
+        e = _mm256_sub_pd(_mm256_castsi256_pd(t_exp), _mm256_set1_pd(4503599627370496.0 + 1023.0));
+        m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(t, _mm256_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                                _mm256_set1_epi64x(0x3FF0000000000000LL)));
+    }
+};
+
+#else // SSE2
+
+struct DoubleBatch
+{
+    typedef double value_type;
+    typedef __m128d type;
+    typedef __m128d mask;
+    enum { size = 2 };
+
+    static type load(const double* p) { return _mm_loadu_pd(p); }
+    static void store(double* p, type v) { _mm_storeu_pd(p, v); }
+    static type set1(double v) { return _mm_set1_pd(v); }
+
+    static type add(type a, type b) { return _mm_add_pd(a, b); }
+    static type sub(type a, type b) { return _mm_sub_pd(a, b); }
+    static type mul(type a, type b) { return _mm_mul_pd(a, b); }
+    static type div(type a, type b) { return _mm_div_pd(a, b); }
+    static type fmadd(type a, type b, type c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+    static type max(type a, type b) { return _mm_max_pd(a, b); }
+    static type min(type a, type b) { return _mm_min_pd(a, b); }
+#ifdef __SSE4_1__
+    static type round(type a) { return _mm_round_pd(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+#else
+    // exact for |a| < 2^51, which covers every caller
+    static type round(type a)
+    {
+        const __m128d t_magic = _mm_set1_pd(6755399441055744.0);
+        return _mm_sub_pd(_mm_add_pd(a, t_magic), t_magic);
+    }
+#endif
+    static type bitxor(type a, type b) { return _mm_xor_pd(a, b); }
+    static type abs(type a) { return _mm_andnot_pd(_mm_set1_pd(-0.0), a); }
+    static type signbit(type a) { return _mm_and_pd(_mm_set1_pd(-0.0), a); }
+
+    static mask gt(type a, type b) { return _mm_cmpgt_pd(a, b); }
+    static mask outside(type a, type lo, type hi)
+    {
+        return _mm_or_pd(_mm_cmpnge_pd(a, lo), _mm_cmpnle_pd(a, hi));
+    }
+    static type select(mask m, type a, type b) { return _mm_or_pd(_mm_and_pd(m, a), _mm_andnot_pd(m, b)); }
+    static bool any(mask m) { return _mm_movemask_pd(m) != 0; }
+    static mask none() { return _mm_setzero_pd(); }
+
+    static type pow2(type k)
+    {
+        __m128i t = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(6755399441055744.0)));
+        t = _mm_slli_epi64(t, 52);
+        return _mm_castsi128_pd(_mm_add_epi64(t, _mm_set1_epi64x(1023LL << 52)));
+    }
+    static type oddsign(type k)
+    {
+        __m128i t = _mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(6755399441055744.0)));
+        return _mm_castsi128_pd(_mm_slli_epi64(t, 63));
+    }
+    static void frexp(type x, type& m, type& e)
+    {
+        __m128i t = _mm_castpd_si128(x);
+        __m128i t_exp = _mm_or_si128(_mm_srli_epi64(t, 52), _mm_set1_epi64x(0x4330000000000000LL));
+        e = _mm_sub_pd(_mm_castsi128_pd(t_exp), _mm_set1_pd(4503599627370496.0 + 1023.0));
+        m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(t, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+                                          _mm_set1_epi64x(0x3FF0000000000000LL)));
+    }
+};
+
+#endif
+
+//////////////////////////////////////////////////////////////////
+// A batch of floats, only with what single precision accumulation
+// needs (the activation functions are computed in double)
+//////////////////////////////////////////////////////////////////
+
+#if defined(NEAT_SIMD_AVX512)
+
+struct FloatBatch
+{
+    typedef float value_type;
+    typedef __m512 type;
+    enum { size = 16 };
+
+    static type load(const float* p) { return _mm512_loadu_ps(p); }
+    static void store(float* p, type v) { _mm512_storeu_ps(p, v); }
+    static type set1(float v) { return _mm512_set1_ps(v); }
+    static type add(type a, type b) { return _mm512_add_ps(a, b); }
+    static type mul(type a, type b) { return _mm512_mul_ps(a, b); }
+
+    // p[idx[0]], p[idx[1]], ...
+    static type gather(const float* p, const unsigned int* idx)
+    {
+        return _mm512_i32gather_ps(_mm512_loadu_si512(idx), p, 4);
+    }
+    static type gather(const float* p, const unsigned short* idx)
+    {
+        return _mm512_i32gather_ps(_mm512_cvtepu16_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx))), p, 4);
+    }
+    static float sum(type v) { return _mm512_reduce_add_ps(v); }
+};
+
+#elif defined(NEAT_SIMD_AVX2)
+
+struct FloatBatch
+{
+    typedef float value_type;
+    typedef __m256 type;
+    enum { size = 8 };
+
+    static type load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, type v) { _mm256_storeu_ps(p, v); }
+    static type set1(float v) { return _mm256_set1_ps(v); }
+    static type add(type a, type b) { return _mm256_add_ps(a, b); }
+    static type mul(type a, type b) { return _mm256_mul_ps(a, b); }
+
+    // p[idx[0]], p[idx[1]], ...
+    static type gather(const float* p, const unsigned int* idx)
+    {
+        return _mm256_i32gather_ps(p, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(idx)), 4);
+    }
+    static type gather(const float* p, const unsigned short* idx)
+    {
+        return _mm256_i32gather_ps(p, _mm256_cvtepu16_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(idx))), 4);
+    }
+    static float sum(type v)
+    {
+        __m128 t = _mm_add_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+        t = _mm_add_ps(t, _mm_movehl_ps(t, t));
+        t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+        return _mm_cvtss_f32(t);
+    }
+};
+
+#else // SSE2
+
+struct FloatBatch
+{
+    typedef float value_type;
+    typedef __m128 type;
+    enum { size = 4 };
+
+    static type load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, type v) { _mm_storeu_ps(p, v); }
+    static type set1(float v) { return _mm_set1_ps(v); }
+    static type add(type a, type b) { return _mm_add_ps(a, b); }
+    static type mul(type a, type b) { return _mm_mul_ps(a, b); }
+
+    // p[idx[0]], p[idx[1]], ...
+    static type gather(const float* p, const unsigned int* idx)
+    {
+        return _mm_set_ps(p[idx[3]], p[idx[2]], p[idx[1]], p[idx[0]]);
+    }
+    static type gather(const float* p, const unsigned short* idx)
+    {
+        return _mm_set_ps(p[idx[3]], p[idx[2]], p[idx[1]], p[idx[0]]);
+    }
+    static float sum(type v)
+    {
+        __m128 t = _mm_add_ps(v, _mm_movehl_ps(v, v));
+        t = _mm_add_ss(t, _mm_shuffle_ps(t, t, 1));
+        return _mm_cvtss_f32(t);
+    }
+};
+
+#endif
+
+
+//////////////////////////////////////////////////////////////////
+// Vectorized math
+//////////////////////////////////////////////////////////////////
+
+// Evaluates the polynomial with the given coefficients (highest power first)
+template <class B>
+inline typename B::type simd_poly(typename B::type a_x, const double* a_coeffs, int a_count)
+{
+    typename B::type t_y = B::set1(a_coeffs[0]);
+    for (int i = 1; i < a_count; i++)
+    {
+        t_y = B::fmadd(t_y, a_x, B::set1(a_coeffs[i]));
+    }
+    return t_y;
+}
+
+// Valid range of simd_exp()
+const double SIMD_EXP_MIN = -708.0;
+const double SIMD_EXP_MAX = 709.0;
+
+// e^x for x in [SIMD_EXP_MIN, SIMD_EXP_MAX]
+// Reduces x = k*ln2 + r with |r| <= ln2/2 and sums the Taylor series of e^r
+template <class B>
+inline typename B::type simd_exp(typename B::type a_x)
+{
+    static const double t_coeffs[] =
+    {
+        1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0,
+        1.0 / 362880.0, 1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0,
+        1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+    };
+
+    typename B::type t_k = B::round(B::mul(a_x, B::set1(1.4426950408889634074)));
+    typename B::type t_r = B::sub(a_x, B::mul(t_k, B::set1(6.93147180369123816490e-01)));
+    t_r = B::sub(t_r, B::mul(t_k, B::set1(1.90821492927058770002e-10)));
+
+    return B::mul(simd_poly<B>(t_r, t_coeffs, 14), B::pow2(t_k));
+}
+
+// e^x for x in [SIMD_EXP_MIN, SIMD_EXP_MAX], with a relative error below 1.7e-7
+// like fast_exp() - the series of simd_exp() cut at r^6
+template <class B>
+inline typename B::type simd_fast_exp(typename B::type a_x)
+{
+    static const double t_coeffs[] =
+    {
+        1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 0.5, 1.0, 1.0
+    };
+
+    typename B::type t_k = B::round(B::mul(a_x, B::set1(1.4426950408889634074)));
+    typename B::type t_r = B::sub(a_x, B::mul(t_k, B::set1(6.93147180369123816490e-01)));
+    t_r = B::sub(t_r, B::mul(t_k, B::set1(1.90821492927058770002e-10)));
+
+    return B::mul(simd_poly<B>(t_r, t_coeffs, 7), B::pow2(t_k));
+}
+
+// Natural logarithm for positive, normal, finite x
+// Reduces x = m * 2^e with m in [sqrt(1/2), sqrt(2)) and uses
+// log(m) = 2 atanh(s), s = (m - 1) / (m + 1)
+template <class B>
+inline typename B::type simd_log(typename B::type a_x)
+{
+    static const double t_coeffs[] =
+    {
+        2.0 / 23.0, 2.0 / 21.0, 2.0 / 19.0, 2.0 / 17.0, 2.0 / 15.0, 2.0 / 13.0,
+        2.0 / 11.0, 2.0 / 9.0, 2.0 / 7.0, 2.0 / 5.0, 2.0 / 3.0, 2.0
+    };
+
+    typename B::type t_m, t_e;
+    B::frexp(a_x, t_m, t_e);
+
+    typename B::mask t_big = B::gt(t_m, B::set1(1.41421356237309504880));
+    t_m = B::select(t_big, B::mul(t_m, B::set1(0.5)), t_m);
+    t_e = B::select(t_big, B::add(t_e, B::set1(1.0)), t_e);
+
+    typename B::type t_f = B::sub(t_m, B::set1(1.0));
+    typename B::type t_s = B::div(t_f, B::add(t_f, B::set1(2.0)));
+    typename B::type t_z = B::mul(t_s, t_s);
+    typename B::type t_log_m = B::mul(t_s, simd_poly<B>(t_z, t_coeffs, 12));
+
+    typename B::type t_y = B::fmadd(t_e, B::set1(1.90821492927058770002e-10), t_log_m);
+    return B::fmadd(t_e, B::set1(6.93147180369123816490e-01), t_y);
+}
+
+// Valid range of simd_sin()
+const double SIMD_SIN_MAX = 1.0e6;
+
+// sin(x) for |x| <= SIMD_SIN_MAX
+// Reduces x = k*pi + r with |r| <= pi/2, so sin(x) = (-1)^k sin(r)
+template <class B>
+inline typename B::type simd_sin(typename B::type a_x)
+{
+    static const double t_coeffs[] =
+    {
+        1.0 / 51090942171709440000.0, -1.0 / 121645100408832000.0,
+        1.0 / 355687428096000.0, -1.0 / 1307674368000.0, 1.0 / 6227020800.0,
+        -1.0 / 39916800.0, 1.0 / 362880.0, -1.0 / 5040.0, 1.0 / 120.0,
+        -1.0 / 6.0, 1.0
+    };
+
+    typename B::type t_k = B::round(B::mul(a_x, B::set1(0.31830988618379067154)));
+    typename B::type t_r = B::sub(a_x, B::mul(t_k, B::set1(3.141592651605606)));
+    t_r = B::sub(t_r, B::mul(t_k, B::set1(1.9841871617964912e-09)));
+    t_r = B::sub(t_r, B::mul(t_k, B::set1(-2.435410355594793e-18)));
+
+    typename B::type t_y = B::mul(t_r, simd_poly<B>(B::mul(t_r, t_r), t_coeffs, 11));
+    return B::bitxor(t_y, B::oddsign(t_k));
+}
+
+// tanh(x) for any non-NaN x
+template <class B>
+inline typename B::type simd_tanh(typename B::type a_x)
+{
+    // rational approximation for |x| < 0.625 (Cephes)
+    static const double t_p[] =
+    {
+        -9.64399179425052238628E-1, -9.92877231001918586564E1, -1.61468768441708447952E3
+    };
+    static const double t_q[] =
+    {
+        1.0, 1.12811678491632931402E2, 2.23548839060100448583E3, 4.84406305325125486048E3
+    };
+
+    typename B::type t_z = B::mul(a_x, a_x);
+    typename B::type t_small = B::div(B::mul(t_z, simd_poly<B>(t_z, t_p, 3)), simd_poly<B>(t_z, t_q, 4));
+    t_small = B::fmadd(a_x, t_small, a_x);
+
+    // (1 - e^-2|x|) / (1 + e^-2|x|) otherwise. Beyond |x| = 22 the result is 1 anyway.
+    typename B::type t_abs = B::min(B::abs(a_x), B::set1(22.0));
+    typename B::type t_e = simd_exp<B>(B::mul(t_abs, B::set1(-2.0)));
+    typename B::type t_large = B::div(B::sub(B::set1(1.0), t_e), B::add(B::set1(1.0), t_e));
+    // give it the sign of x
+    t_large = B::bitxor(t_large, B::signbit(a_x));
+
+    return B::select(B::gt(t_abs, B::set1(0.625)), t_large, t_small);
+}
+
+#endif // NEAT_SIMD
+
+} // namespace NEAT
+
+#if defined(NEAT_SIMD_AVX512) && defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#endif
@@ -51,6 +51,7 @@ Substrate::Substrate()
     m_allow_looped_output_links = false;
     m_hidden_nodes_activation = UNSIGNED_SIGMOID;
     m_output_nodes_activation = UNSIGNED_SIGMOID;
+    m_cppn_activation_accuracy = EXACT_ACTIVATION;
     m_max_weight_and_bias = 5.0;
     m_min_time_const = 0.1;
     m_max_time_const = 1.0;
@@ -66,6 +67,7 @@ Substrate::Substrate(std::vector<std::vector<double> >& a_inputs,
     m_query_weights_only = false;
     m_hidden_nodes_activation = NEAT::UNSIGNED_SIGMOID;
     m_output_nodes_activation = NEAT::UNSIGNED_SIGMOID;
+    m_cppn_activation_accuracy = NEAT::EXACT_ACTIVATION;
     m_allow_input_hidden_links = true;
     m_allow_input_output_links = false;
     m_allow_hidden_hidden_links = false;
@@ -95,6 +97,7 @@ Substrate::Substrate(py::list a_inputs, py::list a_hidden, py::list a_outputs)
     m_with_distance = false;
     m_hidden_nodes_activation = NEAT::UNSIGNED_SIGMOID;
     m_output_nodes_activation = NEAT::UNSIGNED_SIGMOID;
+    m_cppn_activation_accuracy = NEAT::EXACT_ACTIVATION;
     m_allow_input_hidden_links = true;
     m_allow_input_output_links = false;
     m_allow_hidden_hidden_links = false;
@@ -293,5 +296,5 @@ void Substrate::PrintInfo()
 }
 // namespace NEAT
 
-}
+}
 
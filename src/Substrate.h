@@ -34,6 +34,7 @@
 #include <boost/archive/text_oarchive.hpp>
 #include <boost/archive/text_iarchive.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 
 namespace py = boost::python;
 
@@ -86,6 +87,9 @@ public:
     ActivationFunction m_hidden_nodes_activation;
     ActivationFunction m_output_nodes_activation;
 
+    // how accurately the CPPN computes its activation functions when it is queried
+    ActivationAccuracy m_cppn_activation_accuracy;
+
     // additional parameters
     double m_max_weight_and_bias;
     double m_min_time_const;
@@ -160,6 +164,12 @@ public:
         ar & m_custom_connectivity;
         ar & m_custom_conn_obeys_flags;
         ar & m_query_weights_only;
+
+        // added in version 1
+        if (version > 0)
+            ar & m_cppn_activation_accuracy;
+        else
+            m_cppn_activation_accuracy = EXACT_ACTIVATION;
     }
     
 #endif
@@ -195,5 +205,9 @@ struct Substrate_pickle_suite : py::pickle_suite
 
 }
 
+#ifdef USE_BOOST_PYTHON
+BOOST_CLASS_VERSION(NEAT::Substrate, 1)
+#endif
+
 #endif
 
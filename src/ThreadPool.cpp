@@ -0,0 +1,135 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ThreadPool.cpp
+// Description: A persistent pool of worker threads for parallel activation.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ThreadPool.h"
+
+namespace NEAT
+{
+
+ThreadPool::ThreadPool(unsigned int a_num_workers)
+{
+    m_task = NULL;
+    m_num_tasks = m_next_task = m_tasks_done = 0;
+    m_batch = 0;
+    m_stop = false;
+    for (unsigned int i = 0; i < a_num_workers; i++)
+    {
+        m_workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> t_lock(m_mutex);
+        m_stop = true;
+    }
+    m_work_ready.notify_all();
+    for (unsigned int i = 0; i < m_workers.size(); i++)
+    {
+        m_workers[i].join();
+    }
+}
+
+ThreadPool& ThreadPool::Shared()
+{
+    static ThreadPool s_pool(std::thread::hardware_concurrency() > 1 ?
+                             std::thread::hardware_concurrency() - 1 : 0);
+    return s_pool;
+}
+
+void ThreadPool::Run(unsigned int a_num_tasks, const std::function<void(unsigned int)>& a_task)
+{
+    std::unique_lock<std::mutex> t_run_lock(m_run_mutex, std::try_to_lock);
+    if (!t_run_lock.owns_lock() || m_workers.empty() || (a_num_tasks < 2))
+    {
+        for (unsigned int i = 0; i < a_num_tasks; i++)
+        {
+            a_task(i);
+        }
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> t_lock(m_mutex);
+        m_task = &a_task;
+        m_num_tasks = a_num_tasks;
+        m_next_task = 0;
+        m_tasks_done = 0;
+        m_batch++;
+    }
+    m_work_ready.notify_all();
+
+    RunTasks();
+
+    std::unique_lock<std::mutex> t_lock(m_mutex);
+    while (m_tasks_done < m_num_tasks)
+    {
+        m_work_done.wait(t_lock);
+    }
+    m_task = NULL;
+}
+
+void ThreadPool::RunTasks()
+{
+    std::unique_lock<std::mutex> t_lock(m_mutex);
+    while (m_next_task < m_num_tasks)
+    {
+        unsigned int t_task = m_next_task++;
+        const std::function<void(unsigned int)>& t_function = *m_task;
+        t_lock.unlock();
+        t_function(t_task);
+        t_lock.lock();
+        if (++m_tasks_done == m_num_tasks)
+        {
+            m_work_done.notify_all();
+        }
+    }
+}
+
+void ThreadPool::WorkerLoop()
+{
+    unsigned long t_last_batch = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> t_lock(m_mutex);
+            while (!m_stop && (m_batch == t_last_batch))
+            {
+                m_work_ready.wait(t_lock);
+            }
+            if (m_stop)
+                return;
+            t_last_batch = m_batch;
+        }
+        RunTasks();
+    }
+}
+
+} // namespace NEAT
@@ -0,0 +1,105 @@
+#ifndef _THREAD_POOL_H
+#define _THREAD_POOL_H
+
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ThreadPool.h
+// Description: A persistent pool of worker threads for parallel activation.
+///////////////////////////////////////////////////////////////////////////////
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace NEAT
+{
+
+//////////////////////////////////////////////////////////////////
+// A thread pool.
+//
+// The workers are started once and then wait for work, so handing
+// them a batch of tasks costs a wake-up, not a thread creation.
+// Run() splits a batch of numbered tasks between the workers and
+// the calling thread and returns when all of them are done.
+//
+// One batch runs at a time. A caller that finds the pool busy with
+// another caller's batch runs its own tasks by itself instead of
+// waiting, so the pool can be used from any number of threads.
+//////////////////////////////////////////////////////////////////
+
+class ThreadPool
+{
+public:
+
+    // Starts a_num_workers worker threads
+    explicit ThreadPool(unsigned int a_num_workers);
+    ~ThreadPool();
+
+    // The pool shared by the whole process, with a worker for every
+    // hardware thread but one (the calling thread is the other one).
+    // Started on first use.
+    static ThreadPool& Shared();
+
+    unsigned int NumWorkers() const
+    {
+        return static_cast<unsigned int>(m_workers.size());
+    }
+
+    // Calls a_task(0) .. a_task(a_num_tasks - 1), in any order and on any
+    // of the threads, and returns when all of the calls have returned.
+    void Run(unsigned int a_num_tasks, const std::function<void(unsigned int)>& a_task);
+
+private:
+
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator=(const ThreadPool&);
+
+    // Runs tasks of the current batch until there are none left
+    void RunTasks();
+    void WorkerLoop();
+
+    std::vector<std::thread> m_workers;
+
+    // Held by the caller whose batch is running
+    std::mutex m_run_mutex;
+
+    // Guards everything below
+    std::mutex m_mutex;
+    std::condition_variable m_work_ready, m_work_done;
+
+    // The current batch. m_batch changes with every batch, so the workers
+    // can tell a new one from the one they already worked on.
+    const std::function<void(unsigned int)>* m_task;
+    unsigned int m_num_tasks, m_next_task, m_tasks_done;
+    unsigned long m_batch;
+    bool m_stop;
+};
+
+} // namespace NEAT
+
+#endif
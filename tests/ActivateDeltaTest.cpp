@@ -0,0 +1,194 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ActivateDeltaTest.cpp
+// Description: Checks that ActivateDelta() follows changes of the weights.
+///////////////////////////////////////////////////////////////////////////////
+
+// A standalone test program. A state of NewState() is stepped with
+// ActivateDelta(), and the weights and neuron parameters of the network
+// are changed between two of its steps. Its outputs must stay those of a
+// second state stepped with Activate(), up to rounding.
+//
+// Build it from the repository root and link it with the library's sources
+// (all of src/*.cpp except Main.cpp and PythonBindings.cpp), for instance:
+//
+//     c++ -std=gnu++11 -O2 -pthread -Isrc -o activatedelta_test
+//         tests/ActivateDeltaTest.cpp src/CompiledNetwork.cpp src/Genome.cpp ...
+//
+// It exits with 0 if every check passed.
+
+#include <stdio.h>
+#include <math.h>
+#include <vector>
+#include "NeuralNetwork.h"
+
+using namespace NEAT;
+
+const unsigned int NUM_INPUTS = 4;
+const unsigned int NUM_OUTPUTS = 3;
+const unsigned int NUM_HIDDEN = 40;
+const double TOLERANCE = 1e-12;
+
+static Neuron MakeNeuron(NeuronType a_type, ActivationFunction a_af)
+{
+    Neuron t_n;
+    t_n.m_activesum = 0;
+    t_n.m_activation = 0;
+    t_n.m_a = 1;
+    t_n.m_b = 0;
+    t_n.m_timeconst = 1;
+    t_n.m_bias = 0;
+    t_n.m_membrane_potential = 0;
+    t_n.m_activation_function_type = a_af;
+    t_n.m_type = a_type;
+    return t_n;
+}
+
+static void Connect(NeuralNetwork& a_net, unsigned int a_from, unsigned int a_to, double a_weight)
+{
+    Connection t_c;
+    t_c.m_source_neuron_idx = a_from;
+    t_c.m_target_neuron_idx = a_to;
+    t_c.m_weight = a_weight;
+    t_c.m_signal = 0;
+    a_net.AddConnection(t_c);
+}
+
+// A recurrent network of tanh neurons
+static NeuralNetwork MakeNetwork()
+{
+    const unsigned int t_num_neurons = NUM_INPUTS + NUM_OUTPUTS + NUM_HIDDEN;
+
+    NeuralNetwork t_net(true);
+    t_net.SetInputOutputDimentions(NUM_INPUTS, NUM_OUTPUTS);
+    for (unsigned int i = 0; i < t_num_neurons; i++)
+    {
+        NeuronType t_type = (i < NUM_INPUTS) ? INPUT : ((i < NUM_INPUTS + NUM_OUTPUTS) ? OUTPUT : HIDDEN);
+        t_net.AddNeuron(MakeNeuron(t_type, TANH));
+    }
+    for (unsigned int i = NUM_INPUTS; i < t_num_neurons; i++)
+    {
+        for (unsigned int k = 0; k < 5; k++)
+        {
+            Connect(t_net, (i * 7 + k * 11) % t_num_neurons, i, sin(i * 1.3 + k) * 0.8);
+        }
+    }
+    return t_net;
+}
+
+static std::vector<double> StepInputs(unsigned int a_step)
+{
+    std::vector<double> t_inputs(NUM_INPUTS);
+    for (unsigned int i = 0; i < NUM_INPUTS; i++)
+    {
+        // small changes from step to step, as ActivateDelta() is meant for
+        t_inputs[i] = sin(i + a_step * 0.05);
+    }
+    return t_inputs;
+}
+
+// Steps both states once and compares their outputs
+static bool Step(NeuralNetwork& a_net, NeuralNetworkState& a_delta, NeuralNetworkState& a_full,
+                 unsigned int a_step, const char* a_name)
+{
+    std::vector<double> t_inputs = StepInputs(a_step);
+    a_net.Input(a_delta, t_inputs);
+    a_net.Input(a_full, t_inputs);
+    a_net.ActivateDelta(a_delta);
+    a_net.Activate(a_full);
+
+    std::vector<double> t_delta = a_net.Output(a_delta);
+    std::vector<double> t_full = a_net.Output(a_full);
+    for (unsigned int i = 0; i < t_delta.size(); i++)
+    {
+        if (!(fabs(t_delta[i] - t_full[i]) <= TOLERANCE))
+        {
+            printf("%s: step %u, output %u is %.17g, expected %.17g\n", a_name, a_step, i, t_delta[i], t_full[i]);
+            return false;
+        }
+    }
+    return true;
+}
+
+// Runs a few steps, calls a_change and runs a few more
+template <class Change>
+static bool Check(Change a_change, const char* a_name)
+{
+    NeuralNetwork t_net = MakeNetwork();
+    t_net.Compile();
+    NeuralNetworkState t_delta = t_net.NewState();
+    NeuralNetworkState t_full = t_net.NewState();
+
+    bool t_ok = true;
+    unsigned int t_step = 0;
+    for (; t_ok && (t_step < 5); t_step++)
+    {
+        t_ok = Step(t_net, t_delta, t_full, t_step, a_name);
+    }
+    a_change(t_net);
+    for (; t_ok && (t_step < 10); t_step++)
+    {
+        t_ok = Step(t_net, t_delta, t_full, t_step, a_name);
+    }
+
+    printf("%s: %s\n", a_name, t_ok ? "passed" : "FAILED");
+    return t_ok;
+}
+
+static void ChangeWeights(NeuralNetwork& a_net)
+{
+    std::vector<double> t_weights(a_net.NumConnections());
+    a_net.GetWeights(&t_weights[0]);
+    for (unsigned int i = 0; i < t_weights.size(); i++)
+    {
+        t_weights[i] = -1.5 * t_weights[i];
+    }
+    a_net.SetWeights(&t_weights[0]);
+}
+
+static void ChangeSlopes(NeuralNetwork& a_net)
+{
+    std::vector<double> t_a(a_net.NumNeurons(), 2.5);
+    a_net.SetActivationA(&t_a[0]);
+}
+
+static void ChangeByHand(NeuralNetwork& a_net)
+{
+    for (unsigned int i = 0; i < a_net.m_connections.size(); i += 2)
+    {
+        a_net.m_connections[i].m_weight += 0.7;
+    }
+    a_net.UpdateParameters();
+}
+
+int main()
+{
+    bool t_ok = true;
+    t_ok = Check(ChangeWeights, "SetWeights()") && t_ok;
+    t_ok = Check(ChangeSlopes, "SetActivationA()") && t_ok;
+    t_ok = Check(ChangeByHand, "UpdateParameters()") && t_ok;
+    return t_ok ? 0 : 1;
+}
@@ -0,0 +1,204 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        CPPNDepthTest.cpp
+// Description: Checks that BuildHyperNEATPhenotype() queries the CPPN as
+//              deep as its genome.
+///////////////////////////////////////////////////////////////////////////////
+
+// A standalone test program (POSIX). The substrate builders query the CPPN
+// with as many Activate() calls as the genome is deep (GetDepth()), or with
+// a single ActivateTopological() when that gives the same outputs. Every
+// weight of the substrate must be the CPPN's output after GetDepth()
+// Activate() calls, for a shallow CPPN and for one deeper than the 16
+// levels the depth of a genome stops at.
+//
+// Build it from the repository root like the library and link it with the
+// library's sources (all of src/*.cpp except Main.cpp and
+// PythonBindings.cpp), for instance:
+//
+//     c++ -std=gnu++11 -O2 -ffp-contract=off -pthread -Isrc -o cppndepth_test
+//         tests/CPPNDepthTest.cpp src/CompiledNetwork.cpp src/Genome.cpp ...
+//
+// It exits with 0 if every check passed.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "Genome.h"
+#include "NeuralNetwork.h"
+#include "Substrate.h"
+
+using namespace NEAT;
+
+// 2D substrate points, queried in pairs, and the bias
+const unsigned int NUM_CPPN_INPUTS = 5;
+
+// A CPPN genome of a chain of a_num_hidden neurons between the inputs and
+// its one output, loaded from a temporary file in the format of Save()
+static bool MakeChainCPPN(unsigned int a_num_hidden, Genome& a_genome)
+{
+    const char* t_base = getenv("TMPDIR");
+    std::string t_template = std::string((t_base && *t_base) ? t_base : "/tmp") + "/multineat_cppn_XXXXXX";
+    std::vector<char> t_name(t_template.begin(), t_template.end());
+    t_name.push_back('\0');
+    int t_fd = mkstemp(&t_name[0]);
+    if (t_fd < 0)
+        return false;
+    FILE* t_file = fdopen(t_fd, "w");
+    if (!t_file)
+    {
+        close(t_fd);
+        unlink(&t_name[0]);
+        return false;
+    }
+
+    // the neurons are numbered inputs, bias, output, then the chain
+    const unsigned int t_output_id = NUM_CPPN_INPUTS + 1;
+    fprintf(t_file, "GenomeStart 1\n");
+    for (unsigned int i = 1; i < NUM_CPPN_INPUTS; i++)
+    {
+        fprintf(t_file, "Neuron %u %d 0 %d 1 0 1 0\n", i, static_cast<int>(INPUT), static_cast<int>(LINEAR));
+    }
+    fprintf(t_file, "Neuron %u %d 0 %d 1 0 1 0\n", NUM_CPPN_INPUTS, static_cast<int>(BIAS), static_cast<int>(LINEAR));
+    fprintf(t_file, "Neuron %u %d 1 %d 1 0 1 0\n", t_output_id, static_cast<int>(OUTPUT), static_cast<int>(LINEAR));
+    for (unsigned int h = 0; h < a_num_hidden; h++)
+    {
+        fprintf(t_file, "Neuron %u %d 0.5 %d 1 0 1 0\n", t_output_id + 1 + h, static_cast<int>(HIDDEN),
+                static_cast<int>(UNSIGNED_SIGMOID));
+    }
+
+    unsigned int t_innov = 1;
+    for (unsigned int i = 1; i <= NUM_CPPN_INPUTS; i++)
+    {
+        fprintf(t_file, "Link %u %u %u 0 %.8f\n", i, t_output_id + 1, t_innov++, 0.9 * sin(i * 2.1));
+    }
+    for (unsigned int h = 1; h < a_num_hidden; h++)
+    {
+        fprintf(t_file, "Link %u %u %u 0 %.8f\n", t_output_id + h, t_output_id + 1 + h, t_innov++, 2.0 + 0.5 * cos(h * 1.7));
+    }
+    fprintf(t_file, "Link %u %u %u 0 1.5\n", t_output_id + a_num_hidden, t_output_id, t_innov++);
+    fprintf(t_file, "GenomeEnd\n");
+    fclose(t_file);
+
+    a_genome = Genome(&t_name[0]);
+    unlink(&t_name[0]);
+    return true;
+}
+
+// Builds the substrate of a_genome and compares its weights with those of
+// the CPPN activated GetDepth() times. If a_truncated, that many steps must
+// not be enough for the CPPN to settle, for the check to mean something.
+static bool Check(unsigned int a_num_hidden, bool a_truncated, const char* a_name)
+{
+    Genome t_genome;
+    if (!MakeChainCPPN(a_num_hidden, t_genome))
+    {
+        printf("%s: cannot write the genome\n", a_name);
+        return false;
+    }
+
+    std::vector< std::vector<double> > t_inputs, t_hidden, t_outputs;
+    for (unsigned int i = 0; i < 6; i++)
+    {
+        std::vector<double> t_point(2);
+        t_point[0] = -1.0 + 0.4 * i;
+        t_point[1] = -1.0;
+        t_inputs.push_back(t_point);
+    }
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        std::vector<double> t_point(2);
+        t_point[0] = -0.5 + 0.5 * i;
+        t_point[1] = 1.0;
+        t_outputs.push_back(t_point);
+    }
+    Substrate t_substrate(t_inputs, t_hidden, t_outputs);
+    t_substrate.m_query_weights_only = true;
+    t_substrate.m_allow_input_output_links = true;
+
+    NeuralNetwork t_net;
+    t_genome.BuildHyperNEATPhenotype(t_net, t_substrate);
+
+    t_genome.CalculateDepth();
+    int t_depth = t_genome.GetDepth();
+
+    NeuralNetwork t_cppn;
+    t_genome.BuildPhenotype(t_cppn, true);
+
+    bool t_ok = (t_net.m_connections.size() == t_inputs.size() * t_outputs.size());
+    bool t_settled = true;
+    for (unsigned int c = 0; t_ok && (c < t_net.m_connections.size()); c++)
+    {
+        const Connection& t_c = t_net.m_connections[c];
+        std::vector<double> t_query(NUM_CPPN_INPUTS);
+        for (unsigned int n = 0; n < 2; n++)
+        {
+            t_query[n] = t_net.GetNeuronLayout(t_c.m_source_neuron_idx).m_substrate_coords[n];
+            t_query[2 + n] = t_net.GetNeuronLayout(t_c.m_target_neuron_idx).m_substrate_coords[n];
+        }
+        t_query[NUM_CPPN_INPUTS - 1] = 1.0;
+
+        t_cppn.Flush();
+        t_cppn.Input(t_query);
+        for (int d = 0; d < t_depth; d++)
+        {
+            t_cppn.Activate();
+        }
+        double t_expected = t_cppn.Output()[0] * t_substrate.m_max_weight_and_bias;
+
+        t_cppn.Flush();
+        t_cppn.Input(t_query);
+        t_cppn.ActivateTopological();
+        double t_topological = t_cppn.Output()[0] * t_substrate.m_max_weight_and_bias;
+        if (t_topological != t_expected)
+            t_settled = false;
+
+        if (t_c.m_weight != t_expected)
+        {
+            printf("%s: weight %u is %.17g, expected %.17g\n", a_name, c, t_c.m_weight, t_expected);
+            t_ok = false;
+        }
+    }
+    if (t_ok && (a_truncated == t_settled))
+    {
+        printf("%s: the CPPN %s within %d steps\n", a_name, t_settled ? "settles" : "doesn't settle", t_depth);
+        t_ok = false;
+    }
+
+    printf("%s: %s\n", a_name, t_ok ? "passed" : "FAILED");
+    return t_ok;
+}
+
+int main()
+{
+    bool t_ok = true;
+    t_ok = Check(3, false, "3 hidden levels") && t_ok;
+    t_ok = Check(20, true, "20 hidden levels") && t_ok;
+    return t_ok ? 0 : 1;
+}
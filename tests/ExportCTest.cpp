@@ -0,0 +1,382 @@
+///////////////////////////////////////////////////////////////////////////////////////////
+//    MultiNEAT - Python/C++ NeuroEvolution of Augmenting Topologies Library
+//
+//    Copyright (C) 2012 Peter Chervenski
+//
+//    This program is free software: you can redistribute it and/or modify
+//    it under the terms of the GNU Lesser General Public License as published by
+//    the Free Software Foundation, either version 3 of the License, or
+//    (at your option) any later version.
+//
+//    This program is distributed in the hope that it will be useful,
+//    but WITHOUT ANY WARRANTY; without even the implied warranty of
+//    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//    GNU General Public License for more details.
+//
+//    You should have received a copy of the GNU Lesser General Public License
+//    along with this program.  If not, see < http://www.gnu.org/licenses/ >.
+//
+//    Contact info:
+//
+//    Peter Chervenski < spookey@abv.bg >
+//    Shane Ryan < shane.mcdonald.ryan@gmail.com >
+///////////////////////////////////////////////////////////////////////////////////////////
+
+///////////////////////////////////////////////////////////////////////////////
+// File:        ExportCTest.cpp
+// Description: Checks that NeuralNetwork::ExportC() computes what Activate() does.
+///////////////////////////////////////////////////////////////////////////////
+
+// A standalone test program (POSIX). Every network is exported into a
+// temporary directory, built there with the C compiler ($CC, or cc) next
+// to a small harness, and run step by step on the same inputs as the
+// network itself. The outputs must be the same to the last bit. The
+// directory is removed afterwards.
+//
+// Build it from the repository root like the library, without FMA
+// contraction, and link it with the library's sources (all of src/*.cpp
+// except Main.cpp and PythonBindings.cpp), for instance:
+//
+//     c++ -std=gnu++11 -O2 -ffp-contract=off -pthread -Isrc -o exportc_test
+//         tests/ExportCTest.cpp src/CompiledNetwork.cpp src/Genome.cpp ...
+//
+// It exits with 0 if every network passed.
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <unistd.h>
+#include <math.h>
+#include <string>
+#include <vector>
+#include "NeuralNetwork.h"
+
+using namespace NEAT;
+
+const unsigned int NUM_STEPS = 8;
+const unsigned int NUM_FUNCTIONS = SOFTPLUS + 1;
+
+// A temporary directory, removed with the files put in it
+class TempDir
+{
+    std::string m_path;
+    std::vector<std::string> m_files;
+
+public:
+    TempDir()
+    {
+        const char* t_base = getenv("TMPDIR");
+        std::string t_template = std::string((t_base && *t_base) ? t_base : "/tmp") + "/multineat_exportc_XXXXXX";
+        std::vector<char> t_name(t_template.begin(), t_template.end());
+        t_name.push_back('\0');
+        if (mkdtemp(&t_name[0]))
+            m_path = &t_name[0];
+    }
+
+    ~TempDir()
+    {
+        for (unsigned int i = 0; i < m_files.size(); i++)
+        {
+            unlink(m_files[i].c_str());
+        }
+        if (!m_path.empty())
+            rmdir(m_path.c_str());
+    }
+
+    bool IsOpen() const
+    {
+        return !m_path.empty();
+    }
+
+    // The path of a file in the directory, removed with it
+    std::string File(const std::string& a_name)
+    {
+        std::string t_path = m_path + "/" + a_name;
+        m_files.push_back(t_path);
+        return t_path;
+    }
+};
+
+static Neuron MakeNeuron(NeuronType a_type, ActivationFunction a_af, double a_a, double a_b)
+{
+    Neuron t_n;
+    t_n.m_activesum = 0;
+    t_n.m_activation = 0;
+    t_n.m_a = a_a;
+    t_n.m_b = a_b;
+    t_n.m_timeconst = 1;
+    t_n.m_bias = 0;
+    t_n.m_membrane_potential = 0;
+    t_n.m_activation_function_type = a_af;
+    t_n.m_type = a_type;
+    return t_n;
+}
+
+static void Connect(NeuralNetwork& a_net, unsigned int a_from, unsigned int a_to, double a_weight)
+{
+    Connection t_c;
+    t_c.m_source_neuron_idx = a_from;
+    t_c.m_target_neuron_idx = a_to;
+    t_c.m_weight = a_weight;
+    t_c.m_signal = 0;
+    a_net.AddConnection(t_c);
+}
+
+// 3 inputs (the last one a bias), one output per activation function and
+// a hidden neuron of every activation function. The hidden neurons feed
+// the ones after them and all the outputs. With a_Recurrent, there are
+// also self-loops and connections back to earlier hidden neurons and
+// between the outputs.
+static NeuralNetwork MakeNetwork(bool a_Recurrent)
+{
+    const unsigned int t_num_inputs = 3;
+    const unsigned int t_num_outputs = NUM_FUNCTIONS;
+    const unsigned int t_num_hidden = NUM_FUNCTIONS;
+    const unsigned int t_first_hidden = t_num_inputs + t_num_outputs;
+
+    NeuralNetwork t_net(true);
+    t_net.SetInputOutputDimentions(t_num_inputs, t_num_outputs);
+
+    t_net.AddNeuron(MakeNeuron(INPUT, LINEAR, 1, 0));
+    t_net.AddNeuron(MakeNeuron(INPUT, LINEAR, 1, 0));
+    t_net.AddNeuron(MakeNeuron(BIAS, LINEAR, 1, 0));
+    for (unsigned int i = 0; i < t_num_outputs; i++)
+    {
+        t_net.AddNeuron(MakeNeuron(OUTPUT, static_cast<ActivationFunction>(i), 0.5 + 0.1 * i, 0.05 * i));
+    }
+    for (unsigned int i = 0; i < t_num_hidden; i++)
+    {
+        // in reverse, so no hidden neuron shares its output's function
+        t_net.AddNeuron(MakeNeuron(HIDDEN, static_cast<ActivationFunction>(t_num_hidden - 1 - i),
+                                   1.5 - 0.07 * i, -0.03 * i));
+    }
+
+    for (unsigned int h = 0; h < t_num_hidden; h++)
+    {
+        unsigned int t_h = t_first_hidden + h;
+        for (unsigned int i = 0; i < t_num_inputs; i++)
+        {
+            Connect(t_net, i, t_h, sin(3.0 * h + i) * 1.7);
+        }
+        for (unsigned int k = 0; k < h; k++)
+        {
+            if ((h + k) % 3 == 0)
+                Connect(t_net, t_first_hidden + k, t_h, cos(h - 2.0 * k) * 1.3);
+        }
+        for (unsigned int o = 0; o < t_num_outputs; o++)
+        {
+            if ((h + o) % 2 == 0)
+                Connect(t_net, t_h, t_num_inputs + o, sin(h * 0.7 + o) * 0.9);
+        }
+    }
+    for (unsigned int o = 0; o < t_num_outputs; o++)
+    {
+        Connect(t_net, o % 2, t_num_inputs + o, 0.4 - 0.05 * o);
+    }
+
+    if (a_Recurrent)
+    {
+        for (unsigned int h = 0; h < t_num_hidden; h += 2)
+        {
+            Connect(t_net, t_first_hidden + h, t_first_hidden + h, 0.6);
+        }
+        for (unsigned int h = 3; h < t_num_hidden; h += 3)
+        {
+            Connect(t_net, t_first_hidden + h, t_first_hidden + h - 3, -0.8);
+        }
+        for (unsigned int o = 1; o < t_num_outputs; o++)
+        {
+            Connect(t_net, t_num_inputs + o, t_num_inputs + o - 1, 0.5);
+            Connect(t_net, t_num_inputs + o - 1, t_first_hidden + o, -0.35);
+        }
+    }
+
+    return t_net;
+}
+
+static std::vector<double> StepInputs(unsigned int a_step, unsigned int a_num_inputs)
+{
+    std::vector<double> t_inputs(a_num_inputs, 1.0); // the bias stays at 1
+    for (unsigned int i = 0; i + 1 < a_num_inputs; i++)
+    {
+        t_inputs[i] = 2.5 * sin(a_step * 0.9 + i * 1.3);
+    }
+    return t_inputs;
+}
+
+// Exports a_net, runs the exported code for NUM_STEPS steps and compares
+// its outputs with a_net's Activate(). For acyclic networks the evaluate()
+// function is compared with ActivateTopological() as well.
+static bool CheckExport(NeuralNetwork a_net, const char* a_name)
+{
+    TempDir t_dir;
+    if (!t_dir.IsOpen())
+    {
+        printf("%s: can't create a temporary directory\n", a_name);
+        return false;
+    }
+
+    unsigned int t_num_inputs = a_net.NumInputs();
+    unsigned int t_num_outputs = a_net.NumOutputs();
+    bool t_acyclic = a_net.IsAcyclic();
+
+    std::string t_source = t_dir.File("net.c");
+    if (!a_net.ExportC(t_source.c_str(), "net"))
+    {
+        printf("%s: ExportC() failed\n", a_name);
+        return false;
+    }
+
+    // The harness reads the inputs of every step and prints the outputs
+    std::string t_harness = t_dir.File("harness.c");
+    FILE* t_file = fopen(t_harness.c_str(), "w");
+    if (!t_file)
+    {
+        printf("%s: can't write %s\n", a_name, t_harness.c_str());
+        return false;
+    }
+    fprintf(t_file, "#include <stdio.h>\n"
+                    "#include \"net.c\"\n"
+                    "int main(void)\n{\n"
+                    "    double state[NET_NUM_NEURONS], inputs[NET_NUM_INPUTS], outputs[NET_NUM_OUTPUTS];\n"
+                    "    int i, k;\n"
+                    "    net_flush(state);\n"
+                    "    for (k = 0; k < %u; k++)\n    {\n"
+                    "        for (i = 0; i < NET_NUM_INPUTS; i++)\n"
+                    "            if (scanf(\"%%la\", &inputs[i]) != 1) return 1;\n"
+                    "        net_input(state, inputs);\n"
+                    "        net_activate(state);\n"
+                    "        net_output(state, outputs);\n"
+                    "        for (i = 0; i < NET_NUM_OUTPUTS; i++)\n"
+                    "            printf(\"%%a\\n\", outputs[i]);\n", NUM_STEPS);
+    if (t_acyclic)
+    {
+        fprintf(t_file, "        net_evaluate(inputs, outputs);\n"
+                        "        for (i = 0; i < NET_NUM_OUTPUTS; i++)\n"
+                        "            printf(\"%%a\\n\", outputs[i]);\n");
+    }
+    fprintf(t_file, "    }\n"
+                    "    return 0;\n}\n");
+    if (fclose(t_file) != 0)
+    {
+        printf("%s: can't write %s\n", a_name, t_harness.c_str());
+        return false;
+    }
+
+    std::string t_input_file = t_dir.File("inputs.txt");
+    t_file = fopen(t_input_file.c_str(), "w");
+    if (!t_file)
+    {
+        printf("%s: can't write %s\n", a_name, t_input_file.c_str());
+        return false;
+    }
+    for (unsigned int k = 0; k < NUM_STEPS; k++)
+    {
+        std::vector<double> t_inputs = StepInputs(k, t_num_inputs);
+        for (unsigned int i = 0; i < t_num_inputs; i++)
+        {
+            fprintf(t_file, "%a\n", t_inputs[i]);
+        }
+    }
+    if (fclose(t_file) != 0)
+    {
+        printf("%s: can't write %s\n", a_name, t_input_file.c_str());
+        return false;
+    }
+
+    const char* t_cc = getenv("CC");
+    std::string t_program = t_dir.File("harness");
+    std::string t_command = std::string((t_cc && *t_cc) ? t_cc : "cc") +
+                            " -std=c99 -O2 -ffp-contract=off -o '" + t_program + "' '" + t_harness + "' -lm";
+    if (system(t_command.c_str()) != 0)
+    {
+        printf("%s: can't build the exported code\n", a_name);
+        return false;
+    }
+
+    t_command = "'" + t_program + "' < '" + t_input_file + "'";
+    FILE* t_pipe = popen(t_command.c_str(), "r");
+    if (!t_pipe)
+    {
+        printf("%s: can't run the exported code\n", a_name);
+        return false;
+    }
+
+    NeuralNetwork t_topological = a_net;
+    bool t_ok = true;
+    a_net.Flush();
+    for (unsigned int k = 0; k < NUM_STEPS; k++)
+    {
+        std::vector<double> t_inputs = StepInputs(k, t_num_inputs);
+        a_net.Input(t_inputs);
+        a_net.Activate();
+        std::vector<double> t_expected = a_net.Output();
+
+        if (t_acyclic)
+        {
+            t_topological.Flush();
+            t_topological.Input(t_inputs);
+            t_topological.ActivateTopological();
+            std::vector<double> t_evaluated = t_topological.Output();
+            t_expected.insert(t_expected.end(), t_evaluated.begin(), t_evaluated.end());
+        }
+
+        for (unsigned int i = 0; i < t_expected.size(); i++)
+        {
+            double t_x;
+            if (fscanf(t_pipe, "%la", &t_x) != 1)
+            {
+                printf("%s: the exported code stopped at step %u\n", a_name, k);
+                t_ok = false;
+                break;
+            }
+            // NaNs compare unequal, but the same NaN is fine
+            if ((t_x != t_expected[i]) && !(isnan(t_x) && isnan(t_expected[i])))
+            {
+                printf("%s: step %u, %s %u is %a, expected %a\n", a_name, k,
+                       (i < t_num_outputs) ? "output" : "evaluated output",
+                       i % t_num_outputs, t_x, t_expected[i]);
+                t_ok = false;
+            }
+        }
+        if (!t_ok)
+            break;
+    }
+    if (pclose(t_pipe) != 0)
+    {
+        printf("%s: the exported code failed\n", a_name);
+        t_ok = false;
+    }
+
+    printf("%s: %s\n", a_name, t_ok ? "passed" : "FAILED");
+    return t_ok;
+}
+
+int main()
+{
+    bool t_ok = true;
+
+    NeuralNetwork t_acyclic = MakeNetwork(false);
+    NeuralNetwork t_recurrent = MakeNetwork(true);
+    t_ok = CheckExport(t_acyclic, "acyclic, hidden neurons") && t_ok;
+    t_ok = CheckExport(t_recurrent, "recurrent, hidden neurons") && t_ok;
+
+    // the compiled form in double precision and EXACT_ACTIVATION
+    // computes the same as the uncompiled one
+    t_recurrent.Compile();
+    t_ok = CheckExport(t_recurrent, "recurrent, compiled") && t_ok;
+
+    // no hidden neurons
+    NeuralNetwork t_direct(true);
+    t_direct.SetInputOutputDimentions(2, NUM_FUNCTIONS);
+    t_direct.AddNeuron(MakeNeuron(INPUT, LINEAR, 1, 0));
+    t_direct.AddNeuron(MakeNeuron(BIAS, LINEAR, 1, 0));
+    for (unsigned int o = 0; o < NUM_FUNCTIONS; o++)
+    {
+        t_direct.AddNeuron(MakeNeuron(OUTPUT, static_cast<ActivationFunction>(o), 1.2, 0.1));
+        Connect(t_direct, 0, 2 + o, 1.1 - 0.1 * o);
+        Connect(t_direct, 1, 2 + o, -0.3);
+    }
+    t_ok = CheckExport(t_direct, "no hidden neurons") && t_ok;
+
+    return t_ok ? 0 : 1;
+}